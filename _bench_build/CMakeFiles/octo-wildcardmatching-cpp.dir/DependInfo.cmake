@@ -0,0 +1,29 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/compiled-wildcard-path.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/compiled-wildcard-path.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/compiled-wildcard-path.cpp.o.d"
+  "/root/repo/src/literal-automaton.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/literal-automaton.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/literal-automaton.cpp.o.d"
+  "/root/repo/src/multi-segment-matcher.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/multi-segment-matcher.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/multi-segment-matcher.cpp.o.d"
+  "/root/repo/src/path-view.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/path-view.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/path-view.cpp.o.d"
+  "/root/repo/src/wildcard-path-code-generator.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-code-generator.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-code-generator.cpp.o.d"
+  "/root/repo/src/wildcard-path-loader.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-loader.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-loader.cpp.o.d"
+  "/root/repo/src/wildcard-path-matcher-set.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher-set.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher-set.cpp.o.d"
+  "/root/repo/src/wildcard-path-matcher.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher.cpp.o.d"
+  "/root/repo/src/wildcard-path-pool.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-pool.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-pool.cpp.o.d"
+  "/root/repo/src/wildcard-path-storage.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-storage.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-storage.cpp.o.d"
+  "/root/repo/src/wildcard-path-watcher.cpp" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-watcher.cpp.o" "gcc" "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-watcher.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,31 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/compiled-wildcard-path.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/compiled-wildcard-path.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/literal-automaton.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/literal-automaton.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/multi-segment-matcher.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/multi-segment-matcher.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/path-view.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/path-view.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-code-generator.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-code-generator.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-loader.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-loader.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher-set.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher-set.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-matcher.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-pool.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-pool.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-storage.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-storage.cpp.o.d"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-watcher.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp.dir/src/wildcard-path-watcher.cpp.o.d"
+  "libocto-wildcardmatching-cpp.a"
+  "libocto-wildcardmatching-cpp.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/octo-wildcardmatching-cpp.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/octo-wildcardmatching-cpp-benchmarks.dir/src/wildcard-path-matcher-benchmarks.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp-benchmarks.dir/src/wildcard-path-matcher-benchmarks.cpp.o.d"
+  "octo-wildcardmatching-cpp-benchmarks"
+  "octo-wildcardmatching-cpp-benchmarks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/octo-wildcardmatching-cpp-benchmarks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/octo-wildcardmatching-cpp-generator.dir/src/wildcard-path-generator.cpp.o"
+  "CMakeFiles/octo-wildcardmatching-cpp-generator.dir/src/wildcard-path-generator.cpp.o.d"
+  "octo-wildcardmatching-cpp-generator"
+  "octo-wildcardmatching-cpp-generator.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/octo-wildcardmatching-cpp-generator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
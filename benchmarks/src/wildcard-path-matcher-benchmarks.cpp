@@ -0,0 +1,436 @@
+/**
+ * @file wildcard-path-matcher-benchmarks.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher-set.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+
+namespace
+{
+// Keeps the lookup results alive so the measured loops are not optimized out
+volatile size_t benchmark_sink = 0;
+
+/**
+ * @brief
+ * Runs the lookup enough times and returns the average nanoseconds per lookup
+ * The lookup returns the amount of matches it found
+ */
+template <typename Lookup>
+double measure(Lookup&& lookup)
+{
+    size_t iterations = 1;
+    for (;;)
+    {
+        size_t matches = 0;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            matches += lookup();
+        }
+        std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - begin;
+        if (elapsed > std::chrono::milliseconds(200) || iterations > (size_t(1) << 30))
+        {
+            benchmark_sink = benchmark_sink + matches;
+            return double(elapsed.count()) / iterations;
+        }
+        iterations *= 2;
+    }
+}
+
+double measure_lookup(const octo::wildcardmatching::WildcardPathMatcher& path_matcher, const std::string& input)
+{
+    return measure([&]() { return path_matcher.has_match(input) ? 1 : 0; });
+}
+
+void benchmark_deep_infix(const char* name,
+                          const std::string& wildcard_path,
+                          const std::function<std::string(size_t)>& make_input)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_path(wildcard_path);
+
+    printf("%s [%s]\n", name, wildcard_path.c_str());
+    printf("  %10s %14s %14s\n", "segments", "ns/lookup", "ns/segment");
+    for (size_t depth = 25; depth <= 400; depth *= 2)
+    {
+        double ns = measure_lookup(path_matcher, make_input(depth));
+        printf("  %10zu %14.1f %14.2f\n", depth, ns, ns / depth);
+    }
+}
+
+void benchmark_many_wildcard_paths(const char* name, size_t wildcard_paths_count, const std::string& input)
+{
+    std::vector<std::string> wildcard_paths;
+    for (size_t i = 0; i < wildcard_paths_count; i++)
+    {
+        // Wildcard paths sharing their leading segments, so they do not fail on the first comparison
+        switch (i % 4)
+        {
+        case 0:
+            wildcard_paths.push_back("/home/*/app" + std::to_string(i) + "/config/*.json");
+            break;
+        case 1:
+            wildcard_paths.push_back("/home/*/project" + std::to_string(i) + "/.git/**");
+            break;
+        case 2:
+            wildcard_paths.push_back("/home/**/cache" + std::to_string(i) + "/*.tmp");
+            break;
+        default:
+            wildcard_paths.push_back("/home/*/tool" + std::to_string(i) + "/bin/*");
+            break;
+        }
+    }
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(wildcard_paths);
+
+    double ns = measure_lookup(path_matcher, input);
+    printf("%s [%zu wildcard paths] [%s]\n", name, wildcard_paths_count, input.c_str());
+    printf("  %14.1f ns/lookup %14.2f ns/wildcard path\n", ns, ns / wildcard_paths_count);
+}
+
+void benchmark_captures(const std::string& wildcard_path, const std::string& input)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_path(wildcard_path);
+
+    octo::wildcardmatching::WildcardPathMatcher::WildcardCapture captures[8];
+    double id_ns = measure([&]() { return path_matcher.get_wildcard_match_id(input) ? 1 : 0; });
+    double captures_ns = measure([&]() {
+        size_t captures_count = 0;
+        return path_matcher.get_wildcard_match_captures(input, captures, 8, captures_count) ? captures_count : 0;
+    });
+    printf("Captures [%s] [%s]\n", wildcard_path.c_str(), input.c_str());
+    printf("  %14.1f ns/id lookup %14.1f ns/captures lookup\n", id_ns, captures_ns);
+}
+
+void benchmark_bulk_add(size_t wildcard_paths_count)
+{
+    std::vector<std::string> wildcard_paths;
+    wildcard_paths.reserve(wildcard_paths_count);
+    for (size_t i = 0; i < wildcard_paths_count; i++)
+    {
+        wildcard_paths.push_back("/srv/tenant" + std::to_string(i % 1000) + "/app" + std::to_string(i) +
+                                 (i % 2 ? "/**/*.log" : "/config/*.json"));
+    }
+
+    printf("Bulk add [%zu wildcard paths]\n", wildcard_paths_count);
+    for (size_t threads_count : {size_t(0), size_t(1), size_t(2), size_t(4), size_t(8)})
+    {
+        octo::wildcardmatching::WildcardPathMatcher path_matcher;
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        if (threads_count == 0)
+        {
+            path_matcher.add_wildcard_paths(wildcard_paths);
+        }
+        else
+        {
+            path_matcher.add_wildcard_paths_parallel(wildcard_paths, threads_count);
+        }
+        std::chrono::milliseconds elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - begin);
+        benchmark_sink = benchmark_sink + path_matcher.get_wildcard_paths_count();
+        if (threads_count == 0)
+        {
+            printf("  %10s %10lld ms\n", "serial", (long long)elapsed.count());
+        }
+        else
+        {
+            printf("  %7zu th %10lld ms\n", threads_count, (long long)elapsed.count());
+        }
+    }
+}
+
+void benchmark_policy_change(size_t wildcard_paths_count)
+{
+    std::vector<std::string> wildcard_paths;
+    for (size_t i = 0; i < wildcard_paths_count; i++)
+    {
+        wildcard_paths.push_back("/srv/tenant" + std::to_string(i % 1000) + "/app" + std::to_string(i) +
+                                 (i % 2 ? "/**/*.log" : "/config/*.json"));
+    }
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(wildcard_paths);
+
+    // Every change removes a wildcard path and replaces another, against loading the changed list again
+    // Enough changes are made for the plans they trigger to be part of the measure
+    static constexpr size_t CHANGES_COUNT = 40000;
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < CHANGES_COUNT; i++)
+    {
+        path_matcher.remove_wildcard_path((i * 7919) % path_matcher.get_wildcard_paths_count());
+        path_matcher.replace_wildcard_path((i * 104729) % path_matcher.get_wildcard_paths_count(),
+                                           "/srv/tenant" + std::to_string(i % 1000) + "/changed" + std::to_string(i));
+    }
+    std::chrono::nanoseconds incremental_elapsed = std::chrono::steady_clock::now() - begin;
+
+    begin = std::chrono::steady_clock::now();
+    std::vector<std::string> changed_wildcard_paths = path_matcher.get_wildcard_paths();
+    path_matcher.clean_wildcard_paths();
+    path_matcher.add_wildcard_paths(changed_wildcard_paths);
+    std::chrono::nanoseconds reload_elapsed = std::chrono::steady_clock::now() - begin;
+    benchmark_sink = benchmark_sink + path_matcher.get_wildcard_paths_count();
+
+    printf("Policy change [%zu wildcard paths]\n", wildcard_paths_count);
+    printf("  %14.1f us/change incremental %14.1f ms reload of all the changes\n",
+           double(incremental_elapsed.count()) / CHANGES_COUNT / 1000,
+           double(reload_elapsed.count()) / 1000000);
+}
+
+void benchmark_reload_patch_threshold(size_t wildcard_paths_count)
+{
+    std::vector<std::string> wildcard_paths;
+    for (size_t i = 0; i < wildcard_paths_count; i++)
+    {
+        wildcard_paths.push_back("/srv/tenant" + std::to_string(i % 1000) + "/app" + std::to_string(i) +
+                                 (i % 2 ? "/**/*.log" : "/config/*.json"));
+    }
+    octo::wildcardmatching::WildcardPathMatcher current_matcher;
+    current_matcher.add_wildcard_paths(wildcard_paths);
+
+    // The two ways the loader makes a reload: patching a copy of the current matcher, or building the changed list
+    // Every change inserts a wildcard path, the most costly edit since the slots after it move as well
+    printf("Reload patch threshold [%zu wildcard paths]\n", wildcard_paths_count);
+    static constexpr size_t CHANGES_COUNTS[] = {1, 4, 16, 64, 256};
+    for (const size_t* changes_count_iter = std::begin(CHANGES_COUNTS);
+         changes_count_iter != std::end(CHANGES_COUNTS);
+         changes_count_iter++)
+    {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        octo::wildcardmatching::WildcardPathMatcher patched_matcher(current_matcher);
+        for (size_t i = 0; i < *changes_count_iter; i++)
+        {
+            patched_matcher.insert_wildcard_path((i * 7919) % patched_matcher.get_wildcard_paths_count(),
+                                                 "/srv/added" + std::to_string(i) + "/**");
+        }
+        std::chrono::nanoseconds patch_elapsed = std::chrono::steady_clock::now() - begin;
+        std::vector<std::string> changed_wildcard_paths = patched_matcher.get_wildcard_paths();
+
+        begin = std::chrono::steady_clock::now();
+        octo::wildcardmatching::WildcardPathMatcher built_matcher;
+        built_matcher.add_wildcard_paths(changed_wildcard_paths);
+        built_matcher.shrink_to_fit();
+        std::chrono::nanoseconds build_elapsed = std::chrono::steady_clock::now() - begin;
+        benchmark_sink =
+            benchmark_sink + patched_matcher.get_wildcard_paths_count() + built_matcher.get_wildcard_paths_count();
+
+        printf("  %6zu changes %14.1f ms patched %14.1f ms built\n",
+               *changes_count_iter,
+               double(patch_elapsed.count()) / 1000000,
+               double(build_elapsed.count()) / 1000000);
+    }
+}
+
+void benchmark_matcher_set(size_t wildcard_paths_per_list, const std::string& input)
+{
+    static const char* const LIST_NAMES[] = {"allow", "deny", "audit"};
+    octo::wildcardmatching::WildcardPathMatcherSet matcher_set;
+    std::vector<octo::wildcardmatching::WildcardPathMatcher> path_matchers(3);
+    for (size_t list_index = 0; list_index < 3; list_index++)
+    {
+        std::vector<std::string> wildcard_paths;
+        for (size_t i = 0; i < wildcard_paths_per_list; i++)
+        {
+            wildcard_paths.push_back("/srv/" + std::string(LIST_NAMES[list_index]) + std::to_string(i) +
+                                     (i % 2 ? "/**/*.log" : "/*/config/*.json"));
+        }
+        wildcard_paths.push_back(std::string("**/") + LIST_NAMES[list_index] + "/*");
+        matcher_set.add_wildcard_paths(LIST_NAMES[list_index], wildcard_paths);
+        path_matchers[list_index].add_wildcard_paths(wildcard_paths);
+    }
+
+    std::vector<std::optional<size_t>> match_ids;
+    double single_ns = measure([&]() { return path_matchers[0].has_match(input) ? 1 : 0; });
+    double separate_ns = measure([&]() {
+        size_t matches = 0;
+        for (size_t list_index = 0; list_index < 3; list_index++)
+        {
+            matches += path_matchers[list_index].has_match(input) ? 1 : 0;
+        }
+        return matches;
+    });
+    double set_ns = measure([&]() {
+        matcher_set.get_wildcard_match_ids(input, match_ids);
+        return match_ids[0].has_value() ? 1 : 0;
+    });
+    printf("Matcher set [3 lists of %zu wildcard paths] [%s]\n", wildcard_paths_per_list + 1, input.c_str());
+    printf("  %14.1f ns single list %14.1f ns 3 matchers %14.1f ns set\n", single_ns, separate_ns, set_ns);
+}
+
+void benchmark_match_plan(const char* name,
+                          const std::function<std::string(size_t)>& make_wildcard_path,
+                          const std::string& input)
+{
+    std::vector<std::string> wildcard_paths;
+    for (size_t i = 0; i < 10000; i++)
+    {
+        wildcard_paths.push_back(make_wildcard_path(i));
+    }
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(wildcard_paths);
+
+    octo::wildcardmatching::WildcardPathMatcher::MatchPlan match_plan = path_matcher.get_match_plan();
+    double ns = measure_lookup(path_matcher, input);
+    printf("Match plan %s [%zu wildcard paths] [%s]\n", name, wildcard_paths.size(), input.c_str());
+    printf("  %8zu scanned %8zu first part %8zu last part %8zu literal\n",
+           match_plan.scanned_wildcard_paths,
+           match_plan.first_part_indexed_wildcard_paths,
+           match_plan.last_part_indexed_wildcard_paths,
+           match_plan.literal_indexed_wildcard_paths);
+    printf("  %14.1f ns/lookup %14.1f ns estimated\n", ns, match_plan.estimated_lookup_ns);
+}
+
+/**
+ * @brief
+ * A sorted file list like the ones found in SBOMs, many files under few deep package directories
+ */
+std::vector<std::string> make_sbom_file_list(const std::vector<std::string>& packages)
+{
+    static const char* const ROOTS[] = {"/usr/lib64/python3.11/site-packages", "/usr/lib/python3.9/site-packages"};
+    static const char* const MODULES[] = {"core", "utils", "io", "tests", "_vendor", "api", "internal", "compat"};
+    static const char* const FILES[] = {"__init__.py", "base.py", "helpers.py", "errors.py", "config.py", "_impl.so"};
+    std::vector<std::string> file_list;
+    for (const char* root : ROOTS)
+    {
+        for (const std::string& package : packages)
+        {
+            file_list.push_back(std::string(root) + "/" + package + "-1.0.dist-info/RECORD");
+            file_list.push_back(std::string(root) + "/" + package + "-1.0.dist-info/METADATA");
+            for (const char* module : MODULES)
+            {
+                for (size_t sub_module = 0; sub_module < 4; sub_module++)
+                {
+                    for (const char* file : FILES)
+                    {
+                        file_list.push_back(std::string(root) + "/" + package + "/" + module + "/sub" +
+                                            std::to_string(sub_module) + "/" + file);
+                    }
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < 2000; i++)
+    {
+        file_list.push_back("/usr/share/doc/lib" + std::to_string(i) + "/copyright");
+        file_list.push_back("/usr/lib/x86_64-linux-gnu/lib" + std::to_string(i) + ".so.1");
+    }
+    std::sort(file_list.begin(), file_list.end());
+    return file_list;
+}
+
+void benchmark_sorted_batch()
+{
+    std::vector<std::string> packages;
+    for (size_t i = 0; i < 60; i++)
+    {
+        packages.push_back("package" + std::to_string(i));
+    }
+    std::vector<std::string> file_list = make_sbom_file_list(packages);
+
+    // Policies over the packages, their leading segments are shared by long runs of the sorted files
+    std::vector<std::string> wildcard_paths;
+    for (const std::string& package : packages)
+    {
+        wildcard_paths.push_back("/usr/lib*/python3.*/site-packages/" + package + "/tests/**");
+        wildcard_paths.push_back("/usr/lib*/python3.*/site-packages/" + package + "/_vendor/*/*.so");
+        wildcard_paths.push_back("/usr/lib*/python3.*/site-packages/" + package + "/*/sub9/*.py");
+        wildcard_paths.push_back("/usr/lib*/python3.*/site-packages/" + package + "/internal/sub*/secret*");
+        wildcard_paths.push_back("/usr/lib*/python3.*/site-packages/" + package + "-*.dist-info/INSTALLER");
+    }
+    wildcard_paths.push_back("/usr/share/doc/*/changelog*");
+    wildcard_paths.push_back("/usr/lib/*/libssl*.so*");
+    wildcard_paths.push_back("**/*.pem");
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(wildcard_paths);
+
+    std::vector<std::optional<size_t>> match_ids;
+    double single_ns = measure([&]() {
+        size_t matches = 0;
+        for (const std::string& file : file_list)
+        {
+            matches += path_matcher.get_wildcard_match_id(file).has_value() ? 1 : 0;
+        }
+        return matches;
+    });
+    double batch_ns = measure([&]() {
+        path_matcher.get_batch_wildcard_match_ids(file_list, match_ids);
+        return std::count_if(match_ids.begin(), match_ids.end(), [](const std::optional<size_t>& match_id) {
+            return match_id.has_value();
+        });
+    });
+    printf("Sorted batch [%zu wildcard paths] [%zu sorted SBOM files]\n", wildcard_paths.size(), file_list.size());
+    printf("  %14.1f ns/file single %14.1f ns/file batch\n",
+           single_ns / file_list.size(),
+           batch_ns / file_list.size());
+}
+
+std::string repeat_segment(const std::string& segment, size_t count)
+{
+    std::string path;
+    for (size_t i = 0; i < count; i++)
+    {
+        path += "/" + segment;
+    }
+    return path;
+}
+} // namespace
+
+int main()
+{
+    // Inputs that almost match the infix over and over, the worst case for a restart based scan
+    benchmark_deep_infix("Literal infix", "**/a/a/a/a/a/a/a/b/**", [](size_t depth) {
+        return repeat_segment("a", depth);
+    });
+    benchmark_deep_infix("Wildcard infix", "**/*a/*a/*a/*a/*a/*a/*a/*b/**", [](size_t depth) {
+        return repeat_segment("xa", depth);
+    });
+    benchmark_deep_infix("Build path", "**/a/b/c/d/**", [](size_t depth) {
+        return repeat_segment("a/b/c", depth / 3);
+    });
+
+    // Lookups that no wildcard path matches, so every one of them has to be rejected
+    benchmark_many_wildcard_paths("Many wildcard paths", 10000, "/home/john/Documents/report.docx");
+    benchmark_many_wildcard_paths("Many wildcard paths", 10000, "/home/john/a/b/c/d/e/f/g/h/readme");
+
+    // Several policies checked at once, against a single policy and a matcher per policy
+    benchmark_matcher_set(3000, "/srv/deny17/x/config/app.json");
+    benchmark_matcher_set(3000, "/home/john/audit/notes.txt");
+
+    // Pattern sets of different shapes, and the engines planned for them
+    benchmark_match_plan("file names", [](size_t i) { return "**/name" + std::to_string(i); }, "/a/b/c/name77");
+    benchmark_match_plan(
+        "prefixes", [](size_t i) { return "/tenant" + std::to_string(i) + "/*/*.log"; }, "/tenant77/app/x.log");
+    benchmark_match_plan(
+        "infixes", [](size_t i) { return "/srv/*/app" + std::to_string(i) + "*/**"; }, "/srv/x/app77-beta/config");
+    benchmark_match_plan(
+        "wildcard segments",
+        [](size_t i) {
+            return "/" + std::string(1, 'a' + i % 26) + "*/*" + std::string(1, 'a' + i / 26 % 26) + "/*.log";
+        },
+        "/srv/x/app.log");
+
+    // What the wildcards of the matching wildcard path stood for, against the match alone
+    benchmark_captures("/home/*/.ssh/id_*", "/home/john/.ssh/id_rsa");
+    benchmark_captures("/var/**/log/*.*.gz", "/var/lib/app/x/log/syslog.1.gz");
+
+    // Sorted file lists, matched one by one and as a batch
+    benchmark_sorted_batch();
+
+    // Loading machine generated lists, and changing them afterwards
+    benchmark_bulk_add(1000000);
+    benchmark_policy_change(100000);
+    benchmark_reload_patch_threshold(200000);
+
+    return 0;
+}
@@ -1 +1,5 @@
-OPTION(DISABLE_TESTS "Disable Tests Compilation" OFF)
\ No newline at end of file
+OPTION(DISABLE_TESTS "Disable Tests Compilation" OFF)
+OPTION(BUILD_BENCHMARKS "Enable Benchmarks Compilation" OFF)
+OPTION(DISABLE_GENERATOR "Disable Generator Compilation" OFF)
+OPTION(BUILD_DAEMON "Enable Daemon Compilation" OFF)
+OPTION(ENABLE_TRACEPOINTS "Enable Static Tracepoints for perf, bpftrace and systemtap" OFF)
@@ -0,0 +1,72 @@
+# Generates a matcher specialized to the wildcard paths of a patterns file, as a static library target
+#
+# octo_wildcard_generate(TARGET <name> PATTERNS <file>
+#                        [CLASS_NAME <name>] [NAMESPACE <name>] [FOLDER_SEPERATOR <char>]
+#                        [INPUT_FOLDER_SEPERATORS <chars>] [NORMALIZE_INPUT_PATHS]
+#                        [ALLOW_LAST_WILDCARD_AS_MANY_PATHS])
+#
+# The class is declared in <name>.hpp, it defaults to GeneratedWildcardPathMatcher in the global namespace
+# The sources are generated again whenever the patterns file changes
+FUNCTION(OCTO_WILDCARD_GENERATE)
+    # Parsed from the raw arguments, so a \ seperator is not taken as a list escape
+    CMAKE_PARSE_ARGUMENTS(PARSE_ARGV 0 GENERATE
+        "ALLOW_LAST_WILDCARD_AS_MANY_PATHS;NORMALIZE_INPUT_PATHS"
+        "TARGET;PATTERNS;CLASS_NAME;NAMESPACE;FOLDER_SEPERATOR;INPUT_FOLDER_SEPERATORS"
+        ""
+    )
+    IF(NOT GENERATE_TARGET OR NOT GENERATE_PATTERNS)
+        MESSAGE(FATAL_ERROR "octo_wildcard_generate requires TARGET and PATTERNS")
+    ENDIF()
+    IF(NOT GENERATE_CLASS_NAME)
+        SET(GENERATE_CLASS_NAME GeneratedWildcardPathMatcher)
+    ENDIF()
+
+    # Use the generator built in this tree, otherwise an installed one
+    IF(TARGET octo-wildcardmatching-cpp-generator)
+        SET(GENERATOR_COMMAND $<TARGET_FILE:octo-wildcardmatching-cpp-generator>)
+        SET(GENERATOR_DEPENDS octo-wildcardmatching-cpp-generator)
+    ELSE()
+        FIND_PROGRAM(GENERATOR_COMMAND octo-wildcardmatching-cpp-generator)
+        IF(NOT GENERATOR_COMMAND)
+            MESSAGE(FATAL_ERROR "octo-wildcardmatching-cpp-generator was not found")
+        ENDIF()
+        SET(GENERATOR_DEPENDS ${GENERATOR_COMMAND})
+    ENDIF()
+
+    GET_FILENAME_COMPONENT(PATTERNS_PATH ${GENERATE_PATTERNS} ABSOLUTE)
+    SET(OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/${GENERATE_TARGET})
+    SET(HEADER_PATH ${OUTPUT_DIR}/include/${GENERATE_TARGET}.hpp)
+    SET(SOURCE_PATH ${OUTPUT_DIR}/src/${GENERATE_TARGET}.cpp)
+    SET(GENERATOR_ARGS
+        --patterns ${PATTERNS_PATH}
+        --header ${HEADER_PATH}
+        --source ${SOURCE_PATH}
+        --class ${GENERATE_CLASS_NAME}
+    )
+    IF(GENERATE_NAMESPACE)
+        LIST(APPEND GENERATOR_ARGS --namespace ${GENERATE_NAMESPACE})
+    ENDIF()
+    IF(GENERATE_FOLDER_SEPERATOR)
+        LIST(APPEND GENERATOR_ARGS --folder-seperator ${GENERATE_FOLDER_SEPERATOR})
+    ENDIF()
+    IF(GENERATE_NORMALIZE_INPUT_PATHS)
+        LIST(APPEND GENERATOR_ARGS --normalize-input-paths)
+    ENDIF()
+    IF(GENERATE_ALLOW_LAST_WILDCARD_AS_MANY_PATHS)
+        LIST(APPEND GENERATOR_ARGS --allow-last-wildcard-as-many-paths)
+    ENDIF()
+
+    FILE(MAKE_DIRECTORY ${OUTPUT_DIR}/include ${OUTPUT_DIR}/src)
+    ADD_CUSTOM_COMMAND(
+        OUTPUT ${HEADER_PATH} ${SOURCE_PATH}
+        # The input seperators are kept out of the arguments list, a \ in a list would escape the next ;
+        COMMAND ${GENERATOR_COMMAND} ${GENERATOR_ARGS} --input-folder-seperators "${GENERATE_INPUT_FOLDER_SEPERATORS}"
+        DEPENDS ${PATTERNS_PATH} ${GENERATOR_DEPENDS}
+        COMMENT "Generating the wildcard path matcher ${GENERATE_TARGET}"
+        VERBATIM
+    )
+
+    ADD_LIBRARY(${GENERATE_TARGET} STATIC ${SOURCE_PATH} ${HEADER_PATH})
+    SET_TARGET_PROPERTIES(${GENERATE_TARGET} PROPERTIES CXX_STANDARD 17 POSITION_INDEPENDENT_CODE ON)
+    TARGET_INCLUDE_DIRECTORIES(${GENERATE_TARGET} PUBLIC ${OUTPUT_DIR}/include)
+ENDFUNCTION()
@@ -0,0 +1,148 @@
+/**
+ * @file wildcard-path-daemon.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-server.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-loader.hpp"
+#include <signal.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+static constexpr char USAGE[] =
+    "Usage: octo-wildcardmatching-cpp-daemon --patterns <file> --socket <path>\n"
+    "           [--reload-interval-ms <ms>] [--allow-last-wildcard-as-many-paths]\n";
+// Longest wait for requests, so a stop signal or a reloaded matcher is not held back by an idle socket
+static constexpr int MAX_POLL_TIMEOUT_MS = 200;
+
+volatile sig_atomic_t should_stop = 0;
+
+void handle_stop_signal(int)
+{
+    should_stop = 1;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string patterns_path;
+    std::string socket_path;
+    long reload_interval_ms = 1000;
+    bool allow_last_wildcard_as_many_paths = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = (i + 1) < argc;
+        if (strcmp(argv[i], "--allow-last-wildcard-as-many-paths") == 0)
+        {
+            allow_last_wildcard_as_many_paths = true;
+        }
+        else if (has_value && strcmp(argv[i], "--patterns") == 0)
+        {
+            patterns_path = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--socket") == 0)
+        {
+            socket_path = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--reload-interval-ms") == 0)
+        {
+            reload_interval_ms = strtol(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument: [%s]\n%s", argv[i], USAGE);
+            return 1;
+        }
+    }
+    if (patterns_path.empty() || socket_path.empty() || reload_interval_ms <= 0)
+    {
+        fprintf(stderr, "%s", USAGE);
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, handle_stop_signal);
+    signal(SIGTERM, handle_stop_signal);
+
+    try
+    {
+        octo::wildcardmatching::WildcardPathLoader loader(patterns_path, allow_last_wildcard_as_many_paths);
+        loader.reload();
+        octo::wildcardmatching::WildcardPathServer server(socket_path, loader.get_matcher());
+
+        // The patterns file is checked for changes every interval and rebuilt on its own thread, the batches keep
+        // being served by the current matcher meanwhile and switch to the new one once it is published
+        std::mutex reload_mutex;
+        std::condition_variable reload_condition;
+        bool should_stop_reloading = false;
+        std::thread reload_thread([&]() {
+            std::unique_lock<std::mutex> reload_lock(reload_mutex);
+            while (!reload_condition.wait_for(reload_lock, std::chrono::milliseconds(reload_interval_ms), [&]() {
+                return should_stop_reloading;
+            }))
+            {
+                reload_lock.unlock();
+                try
+                {
+                    loader.poll();
+                }
+                catch (const std::exception& e)
+                {
+                    // The current matcher keeps serving until the file is fixed
+                    fprintf(stderr, "%s: %s\n", patterns_path.c_str(), e.what());
+                }
+                reload_lock.lock();
+            }
+        });
+
+        std::exception_ptr serve_error;
+        try
+        {
+            while (!should_stop)
+            {
+                server.poll(MAX_POLL_TIMEOUT_MS);
+                std::shared_ptr<const octo::wildcardmatching::WildcardPathMatcher> matcher = loader.get_matcher();
+                if (matcher != server.get_matcher())
+                {
+                    server.set_matcher(std::move(matcher));
+                }
+            }
+        }
+        catch (...)
+        {
+            serve_error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> reload_lock(reload_mutex);
+            should_stop_reloading = true;
+        }
+        reload_condition.notify_one();
+        reload_thread.join();
+        if (serve_error)
+        {
+            std::rethrow_exception(serve_error);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "%s: %s\n", patterns_path.c_str(), e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file wildcard-path-generator.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-code-generator.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-loader.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+static constexpr char USAGE[] =
+    "Usage: octo-wildcardmatching-cpp-generator --patterns <file> --header <file> --source <file>\n"
+    "           --class <name> [--namespace <name>] [--include <path>] [--folder-seperator <char>]\n"
+    "           [--input-folder-seperators <chars>] [--normalize-input-paths]\n"
+    "           [--allow-last-wildcard-as-many-paths]\n";
+
+/**
+ * @brief
+ * Writes the content to the file only if it differs, so the generated sources are not rebuilt for nothing
+ */
+void write_file_if_changed(const std::string& file_path, const std::string& content)
+{
+    std::ifstream current_file(file_path, std::ios::binary);
+    if (current_file.is_open())
+    {
+        std::ostringstream current_content;
+        current_content << current_file.rdbuf();
+        if (current_content.str() == content)
+        {
+            return;
+        }
+    }
+    current_file.close();
+
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    file << content;
+    if (!file.good())
+    {
+        throw std::runtime_error(std::string("Failed to write the generated file: [") + file_path + "]");
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string patterns_path;
+    std::string header_path;
+    std::string source_path;
+    std::string class_name;
+    std::string namespace_name;
+    std::string header_include;
+    std::string folder_seperator;
+    std::string input_folder_seperators;
+    bool normalize_input_paths = false;
+    bool allow_last_wildcard_as_many_paths = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = (i + 1) < argc;
+        if (strcmp(argv[i], "--allow-last-wildcard-as-many-paths") == 0)
+        {
+            allow_last_wildcard_as_many_paths = true;
+        }
+        else if (strcmp(argv[i], "--normalize-input-paths") == 0)
+        {
+            normalize_input_paths = true;
+        }
+        else if (has_value && strcmp(argv[i], "--patterns") == 0)
+        {
+            patterns_path = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--header") == 0)
+        {
+            header_path = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--source") == 0)
+        {
+            source_path = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--class") == 0)
+        {
+            class_name = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--namespace") == 0)
+        {
+            namespace_name = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--include") == 0)
+        {
+            header_include = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--folder-seperator") == 0)
+        {
+            folder_seperator = argv[++i];
+        }
+        else if (has_value && strcmp(argv[i], "--input-folder-seperators") == 0)
+        {
+            input_folder_seperators = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument: [%s]\n%s", argv[i], USAGE);
+            return 1;
+        }
+    }
+    if (patterns_path.empty() || header_path.empty() || source_path.empty() || class_name.empty() ||
+        folder_seperator.size() > 1)
+    {
+        fprintf(stderr, "%s", USAGE);
+        return 1;
+    }
+    if (header_include.empty())
+    {
+        header_include = header_path.substr(header_path.find_last_of("/\\") + 1);
+    }
+
+    try
+    {
+        // The patterns file is read like the loader reads it, with the same validation and errors
+        octo::wildcardmatching::WildcardPathLoader loader(patterns_path, allow_last_wildcard_as_many_paths);
+        std::shared_ptr<octo::wildcardmatching::WildcardPathMatcher> matcher =
+            std::make_shared<octo::wildcardmatching::WildcardPathMatcher>(allow_last_wildcard_as_many_paths);
+        if (!folder_seperator.empty())
+        {
+            matcher->set_folder_seperator(folder_seperator[0]);
+        }
+        matcher->set_input_folder_seperators(input_folder_seperators);
+        matcher->set_normalize_input_paths(normalize_input_paths);
+        loader.reload();
+        matcher->add_wildcard_paths(loader.get_matcher()->get_wildcard_paths());
+
+        octo::wildcardmatching::WildcardPathCodeGenerator generator(*matcher);
+        std::ostringstream header;
+        generator.generate_header(header, class_name, namespace_name);
+        std::ostringstream source;
+        generator.generate_source(source, class_name, namespace_name, header_include);
+        write_file_if_changed(header_path, header.str());
+        write_file_if_changed(source_path, source.str());
+    }
+    catch (const std::exception& e)
+    {
+        fprintf(stderr, "%s: %s\n", patterns_path.c_str(), e.what());
+        return 1;
+    }
+
+    return 0;
+}
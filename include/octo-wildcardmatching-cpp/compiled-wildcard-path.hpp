@@ -0,0 +1,96 @@
+/**
+ * @file compiled-wildcard-path.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef COMPILED_WILDCARD_PATH_HPP_
+#define COMPILED_WILDCARD_PATH_HPP_
+
+#include <vector>
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * View of a validated wildcard path compiled to its segments and cards
+ * Compiled once when the path is added so that the lookups do not need to split the wildcard paths again
+ * The memory itself is owned by a WildcardPathStorage, the view is valid as long as the storage is not changed
+ */
+struct CompiledWildcardPath
+{
+    struct Wildcard
+    {
+        // Offset is relative to the start of the wildcard path
+        uint32_t offset, size;
+        Wildcard(size_t begin, size_t end);
+    };
+    struct Segment
+    {
+        // Offset is relative to the start of the wildcard path, first card to the first card of the wildcard path
+        uint32_t offset, size;
+        uint32_t first_card, card_count;
+        // Infix block data, a block is the run of segments between two **
+        // The failure is the KMP border length of the block prefix ending at this segment
+        int32_t block_failure;
+        bool in_literal_block;
+        bool is_double_wildcard;
+        bool starts_with_wildcard;
+        bool ends_with_wildcard;
+    };
+
+    std::string_view path;
+    const Segment* segments;
+    size_t segments_count;
+    const Wildcard* cards;
+
+    /**
+     * @brief
+     * Get the text of one of the segments of the path
+     *
+     * @param segment
+     * @return std::string_view
+     */
+    std::string_view get_segment_string(const Segment& segment) const
+    {
+        return std::string_view(path.data() + segment.offset, segment.size);
+    }
+    /**
+     * @brief
+     * Splits a string to views of its non empty parts by a given delimiter
+     * The tokens vector is cleared and refilled, so a reused vector will not allocate once warm
+     *
+     * @param input
+     * @param delimiter
+     * @param tokens
+     */
+    static void split_string_by_delimiter(std::string_view input,
+                                          char delimiter,
+                                          std::vector<std::string_view>& tokens);
+    /**
+     * @brief
+     * Splits a path to views of its non empty parts by any of the given seperators, all in a single scan
+     * When resolving dot segments, . parts are dropped and .. parts drop the part before them, lexically
+     * The tokens vector is cleared and refilled, so a reused vector will not allocate once warm
+     *
+     * @param input
+     * @param seperators
+     * @param resolve_dot_segments
+     * @param tokens
+     */
+    static void split_path_by_seperators(std::string_view input,
+                                         const std::bitset<256>& seperators,
+                                         bool resolve_dot_segments,
+                                         std::vector<std::string_view>& tokens);
+};
+} // namespace octo::wildcardmatching
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file literal-automaton.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef LITERAL_AUTOMATON_HPP_
+#define LITERAL_AUTOMATON_HPP_
+
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Aho-Corasick automaton over a set of literals, finds all the literals that occur in an input in a single scan
+ * The transitions are kept as sorted edges per state, with a full transition table only for the root state
+ */
+class LiteralAutomaton
+{
+  private:
+    struct State
+    {
+        uint32_t first_edge, edges_count;
+        // The state of the longest proper suffix that is also in the trie
+        uint32_t failure;
+        // The nearest state on the failure chain that ends a literal, 0 if there is none
+        uint32_t output_link;
+        // The literal that ends at this state, -1 if none
+        int32_t literal_id;
+    };
+    struct Edge
+    {
+        unsigned char c;
+        uint32_t target;
+    };
+
+  private:
+    std::vector<State> states_;
+    std::vector<Edge> edges_;
+    std::vector<uint32_t> root_transitions_;
+    size_t literals_count_;
+
+  private:
+    /**
+     * @brief
+     * Finds the trie child of a state by the given character
+     *
+     * @param state
+     * @param c
+     * @return uint32_t the child state, or UINT32_MAX if there is none
+     */
+    uint32_t find_edge(uint32_t state, unsigned char c) const;
+
+  public:
+    /**
+     * @brief
+     * Construct a new empty Literal Automaton object
+     */
+    LiteralAutomaton();
+    /**
+     * @brief
+     * Destroy the Literal Automaton object
+     */
+    virtual ~LiteralAutomaton();
+    /**
+     * @brief
+     * Builds the automaton over the given distinct non empty literals, the literal ids are their indices
+     * Anything previously built is discarded
+     *
+     * @param literals
+     */
+    void build(const std::vector<std::string_view>& literals);
+    /**
+     * @brief
+     * Appends the ids of the literals that occur in the input, once per occurrence
+     * The ids vector is not cleared, so a reused vector will not allocate once warm
+     *
+     * @param input
+     * @param literal_ids
+     */
+    void find_literals(std::string_view input, std::vector<uint32_t>& literal_ids) const;
+    /**
+     * @brief
+     * Get the amount of literals the automaton was built over
+     *
+     * @return size_t
+     */
+    size_t get_literals_count() const;
+    /**
+     * @brief
+     * Removes all the literals
+     */
+    void clear();
+    /**
+     * @brief
+     * Get the memory used by the automaton tables
+     *
+     * @return size_t
+     */
+    size_t get_memory_usage() const;
+};
+} // namespace octo::wildcardmatching
+#endif
@@ -0,0 +1,174 @@
+/**
+ * @file multi-segment-matcher.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef MULTI_SEGMENT_MATCHER_HPP_
+#define MULTI_SEGMENT_MATCHER_HPP_
+
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Shift-And matcher over a set of segments made of literal characters and single wildcards, which checks all of them
+ * against an input part in a single pass over its characters
+ * Identical segments are matched once, every distinct segment takes a bit per literal character, and as many of them
+ * as fit are packed into each 64 bit word
+ * The masks of a character are laid out across the words, so a pass goes over them in order, word after word
+ */
+class MultiSegmentMatcher
+{
+  private:
+    // Distinct segments ids start after the id of the segments that match any part
+    static constexpr uint32_t ANY_PART_SEGMENT_ID = 0;
+
+  private:
+    // Distinct segment id of every segment
+    std::vector<uint32_t> distinct_segment_ids_;
+    // Bits of every word, the first character of every distinct segment, those injected at the first character of
+    // the part, those injected at every character as they start with *, the characters followed by a * which stay
+    // matched for the rest of the part, and the last character of every distinct segment
+    std::vector<uint64_t> not_first_bits_;
+    std::vector<uint64_t> start_bits_;
+    std::vector<uint64_t> floating_bits_;
+    std::vector<uint64_t> star_bits_;
+    std::vector<uint64_t> last_bits_;
+    // Masks of the bits every character matches, a row of all the words per character
+    std::vector<uint64_t> char_masks_;
+    // Distinct segment id of every last character bit, 64 per word
+    std::vector<uint32_t> last_bit_segment_ids_;
+    size_t distinct_segments_count_;
+    // Bits taken in the last word, the next distinct segment is packed after them if it fits
+    size_t used_bits_;
+
+  private:
+    /**
+     * @brief
+     * Starts a new word of distinct segments, without its character masks
+     */
+    void append_word();
+    /**
+     * @brief
+     * Packs a distinct segment into the last word, which must have room for its literal characters
+     *
+     * @param segment
+     * @param word_masks masks of the last word for character 0
+     * @param char_stride distance between the masks of the last word of two consecutive characters
+     * @return uint32_t the distinct segment id
+     */
+    uint32_t pack_distinct_segment(std::string_view segment, uint64_t* word_masks, size_t char_stride);
+    /**
+     * @brief
+     * Packs a segment added after the build, the matching is the same but it is never shared with an identical one
+     *
+     * @param segment
+     * @return uint32_t the distinct segment id
+     */
+    uint32_t pack_added_segment(std::string_view segment);
+
+  public:
+    /**
+     * @brief
+     * Construct a new empty Multi Segment Matcher object
+     */
+    MultiSegmentMatcher();
+    /**
+     * @brief
+     * Destroy the Multi Segment Matcher object
+     */
+    virtual ~MultiSegmentMatcher();
+    /**
+     * @brief
+     * Builds the matcher over the given segments, the segment ids are their indices
+     * Segments without literal characters or with more than fit in a word are not packed, and match any part
+     * Anything previously built is discarded
+     *
+     * @param segments literal characters and single * only
+     */
+    void build(const std::vector<std::string_view>& segments);
+    /**
+     * @brief
+     * Matches all the distinct segments against the input part in one pass, and sets the bits of those that match it
+     *
+     * @param input_part
+     * @param matched_mask set to the bits of the matching distinct segments, to check the segments with is_matched
+     */
+    void match(std::string_view input_part, std::vector<uint64_t>& matched_mask) const;
+    /**
+     * @brief
+     * Inserts a segment at the given id, the ids of the segments after it move up by one
+     * Its bits are packed after the last distinct segment, without building the matcher again
+     *
+     * @param segment_id
+     * @param segment literal characters and single * only
+     */
+    void insert_segment(size_t segment_id, std::string_view segment);
+    /**
+     * @brief
+     * Sets the segment at the given id, the bits of the previous one are left unused until the next build
+     *
+     * @param segment_id
+     * @param segment literal characters and single * only
+     */
+    void set_segment(size_t segment_id, std::string_view segment);
+    /**
+     * @brief
+     * Erases the segment at the given id, the ids of the segments after it move down by one
+     * Its bits are left unused until the next build
+     *
+     * @param segment_id
+     */
+    void erase_segment(size_t segment_id);
+    /**
+     * @brief
+     * Checks if the segment matched the input part the mask was set by
+     *
+     * @param segment_id
+     * @param matched_mask
+     * @return true
+     * @return false
+     */
+    bool is_matched(size_t segment_id, const std::vector<uint64_t>& matched_mask) const
+    {
+        const uint32_t distinct_segment_id = distinct_segment_ids_[segment_id];
+        return (matched_mask[distinct_segment_id / 64] >> (distinct_segment_id % 64)) & 1;
+    }
+    /**
+     * @brief
+     * Get the amount of segments the matcher was built over
+     *
+     * @return size_t
+     */
+    size_t get_segments_count() const;
+    /**
+     * @brief
+     * Get the amount of distinct segments that are matched against the input parts
+     *
+     * @return size_t
+     */
+    size_t get_distinct_segments_count() const;
+    /**
+     * @brief
+     * Removes all the segments
+     */
+    void clear();
+    /**
+     * @brief
+     * Get the memory used by the matcher tables
+     *
+     * @return size_t
+     */
+    size_t get_memory_usage() const;
+};
+} // namespace octo::wildcardmatching
+#endif
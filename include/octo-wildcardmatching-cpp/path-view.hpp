@@ -0,0 +1,135 @@
+/**
+ * @file path-view.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef PATH_VIEW_HPP_
+#define PATH_VIEW_HPP_
+
+#include <bitset>
+#include <vector>
+#include <string_view>
+#include <cstdint>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * An input path split to its parts once, together with the facts the matchers filter by
+ * A path view can be matched against any amount of matchers without splitting the input again, as long as they
+ * split their inputs the same way it was split, otherwise the matcher splits the input by its own settings
+ * The parts are views into the input, so the input must outlive the path view
+ */
+class PathView
+{
+  public:
+    struct Facts
+    {
+        // Amount of parts
+        size_t parts;
+        // Size and hash of the last part, 0 if there are no parts
+        size_t last_part_size;
+        uint64_t last_part_hash;
+        // Amount of characters in all the parts
+        size_t chars;
+        // Signature of the characters in all the parts, a bit per character value modulo 64
+        uint64_t chars_signature;
+    };
+
+  private:
+    std::string_view input_;
+    std::vector<std::string_view> parts_;
+    Facts facts_;
+    char folder_seperator_;
+    std::bitset<256> folder_seperators_table_;
+    bool normalize_input_path_;
+
+  public:
+    /**
+     * @brief
+     * Construct a new empty Path View object
+     */
+    PathView();
+    /**
+     * @brief
+     * Construct a new Path View object over the given input
+     *
+     * @param input
+     * @param folder_seperator
+     * @param input_folder_seperators seperators to split by on top of the folder seperator
+     * @param normalize_input_path whether to resolve the . and .. parts
+     */
+    PathView(std::string_view input,
+             char folder_seperator,
+             std::string_view input_folder_seperators = std::string_view(),
+             bool normalize_input_path = false);
+    /**
+     * @brief
+     * Destroy the Path View object
+     */
+    virtual ~PathView();
+    /**
+     * @brief
+     * Splits a new input and computes its facts, reusing the memory of the previous one
+     * Once warm, a reused path view does not allocate
+     *
+     * @param input
+     * @param folder_seperator
+     * @param folder_seperators_table all the seperators to split by, including the folder seperator
+     * @param normalize_input_path
+     */
+    void assign(std::string_view input,
+                char folder_seperator,
+                const std::bitset<256>& folder_seperators_table,
+                bool normalize_input_path);
+    /**
+     * @brief
+     * Checks whether the path view was split with the given settings
+     *
+     * @param folder_seperator
+     * @param folder_seperators_table
+     * @param normalize_input_path
+     * @return true
+     * @return false
+     */
+    bool is_split_like(char folder_seperator,
+                       const std::bitset<256>& folder_seperators_table,
+                       bool normalize_input_path) const;
+    /**
+     * @brief
+     * Get the input the path view was split from
+     *
+     * @return std::string_view
+     */
+    std::string_view get_input() const;
+    /**
+     * @brief
+     * Get the non empty parts of the input
+     *
+     * @return const std::vector<std::string_view>&
+     */
+    const std::vector<std::string_view>& get_parts() const;
+    /**
+     * @brief
+     * Get the facts of the input
+     *
+     * @return const Facts&
+     */
+    const Facts& get_facts() const;
+    /**
+     * @brief
+     * Hashes a single path part, the same way the last part hash of the facts is computed
+     *
+     * @param part
+     * @return uint64_t
+     */
+    static uint64_t hash_part(std::string_view part);
+};
+} // namespace octo::wildcardmatching
+#endif
@@ -0,0 +1,134 @@
+/**
+ * @file wildcard-path-client.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_CLIENT_HPP_
+#define WILDCARD_PATH_CLIENT_HPP_
+
+#include "octo-wildcardmatching-cpp/wildcard-path-protocol.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Client of a wildcard path server, with the lookups of a wildcard path matcher answered by the matcher of the server
+ * Lookups of a batch are pipelined, so they are answered together with a single round trip per window of them
+ * A client is a single connection and is not thread safe, every thread should have its own
+ * Throws if the server can not be reached or closes the connection, the client should then be connected again
+ */
+class WildcardPathClient
+{
+  private:
+    std::string socket_path_;
+    int fd_;
+    std::vector<char> request_buffer_;
+    // Received bytes, the responses before the begin were taken already
+    std::vector<char> response_buffer_;
+    size_t response_begin_;
+    size_t response_end_;
+
+  private:
+    /**
+     * @brief
+     * Appends a request to the ones to send, throws if the input can not be a path
+     *
+     * @param request_type
+     * @param input
+     */
+    void append_request(protocol::RequestType request_type, std::string_view input);
+    /**
+     * @brief
+     * Sends all the appended requests
+     */
+    void send_requests();
+    /**
+     * @brief
+     * Receives the next response, in the order of the requests
+     *
+     * @param payload set to the payload of the response, valid until the next response is received
+     * @return protocol::ResponseStatus
+     */
+    protocol::ResponseStatus receive_response(std::string_view& payload);
+    /**
+     * @brief
+     * Sends a single request and receives its response
+     *
+     * @param request_type
+     * @param input
+     * @param payload
+     * @return protocol::ResponseStatus
+     */
+    protocol::ResponseStatus request(protocol::RequestType request_type,
+                                     std::string_view input,
+                                     std::string_view& payload);
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Client object connected to the server at the socket path
+     *
+     * @param socket_path
+     */
+    explicit WildcardPathClient(std::string socket_path);
+    /**
+     * @brief
+     * Destroy the Wildcard Path Client object, the connection is closed
+     */
+    virtual ~WildcardPathClient();
+    WildcardPathClient(const WildcardPathClient&) = delete;
+    WildcardPathClient& operator=(const WildcardPathClient&) = delete;
+    /**
+     * @brief
+     * Checks if the input matches any of the wildcard paths of the server
+     * An exceeded step budget of the server matcher is a match only if that matcher takes it as one
+     *
+     * @param input
+     * @return true
+     * @return false
+     */
+    bool has_match(std::string_view input);
+    /**
+     * @brief
+     * Get the first wildcard path of the server that matches the input
+     *
+     * @param input
+     * @return std::string empty if there is no match
+     */
+    std::string get_wildcard_match(std::string_view input);
+    /**
+     * @brief
+     * Get the id of the first wildcard path of the server that matches the input
+     *
+     * @param input
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> get_wildcard_match_id(std::string_view input);
+    /**
+     * @brief
+     * Same as get_wildcard_match_id for every input of a batch, the requests are pipelined
+     *
+     * @param inputs
+     * @param match_ids filled with the id of the first matching wildcard path of every input
+     */
+    void get_wildcard_match_ids(const std::vector<std::string>& inputs, std::vector<std::optional<size_t>>& match_ids);
+    /**
+     * @brief
+     * Get the path of the socket of the server
+     *
+     * @return const std::string&
+     */
+    const std::string& get_socket_path() const;
+};
+} // namespace octo::wildcardmatching
+#endif
@@ -0,0 +1,168 @@
+/**
+ * @file wildcard-path-code-generator.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_CODE_GENERATOR_HPP_
+#define WILDCARD_PATH_CODE_GENERATOR_HPP_
+
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-storage.hpp"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <map>
+#include <vector>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Generates the C++ source of a matcher specialized to a fixed list of wildcard paths
+ * Every wildcard path becomes a function with its segment comparisons inlined, and the lookup dispatches on the
+ * first input part for the wildcard paths that start with a literal segment, so nothing is traversed at runtime
+ * The generated class has the lookup interface of WildcardPathMatcher and matches exactly like it, with the
+ * settings of the matcher the code was generated from
+ */
+class WildcardPathCodeGenerator
+{
+  private:
+    WildcardPathStorage storage_;
+    char folder_seperator_;
+    std::string input_folder_seperators_;
+    bool normalize_input_paths_;
+    bool allow_last_wildcard_as_many_paths_;
+    // Segment comparison function per distinct segment text
+    std::map<std::string_view, size_t> segment_function_ids_;
+
+  private:
+    /**
+     * @brief
+     * Writes a string escaped for a C++ string literal or comment, with octal escapes for anything not printable
+     *
+     * @param out
+     * @param str
+     */
+    static void write_escaped_string(std::ostream& out, std::string_view str);
+    /**
+     * @brief
+     * Writes a string as a C++ string view literal, with an explicit size so any byte can be in it
+     *
+     * @param out
+     * @param str
+     */
+    static void write_string_literal(std::ostream& out, std::string_view str);
+    /**
+     * @brief
+     * Writes the namespace opening or closing line, nothing for the global namespace
+     *
+     * @param out
+     * @param namespace_name
+     * @param is_opening
+     */
+    static void write_namespace(std::ostream& out, const std::string& namespace_name, bool is_opening);
+    /**
+     * @brief
+     * Writes a comparison function for every distinct segment of the wildcard paths
+     *
+     * @param out
+     */
+    void write_segment_functions(std::ostream& out);
+    /**
+     * @brief
+     * Writes the call comparing the segment to the input part expression
+     *
+     * @param out
+     * @param wildcard_path
+     * @param wildcard_path_part_index
+     * @param input_part
+     */
+    void write_segment_call(std::ostream& out,
+                            const CompiledWildcardPath& wildcard_path,
+                            size_t wildcard_path_part_index,
+                            const std::string& input_part) const;
+    /**
+     * @brief
+     * Writes the function matching the input parts against a single wildcard path
+     * The generic comparison of WildcardPathMatcher is unrolled here, the wildcard path index of every step is
+     * known up front, so only the input part index is left to be tracked at runtime
+     *
+     * @param out
+     * @param wildcard_path_id
+     */
+    void write_wildcard_path_function(std::ostream& out, size_t wildcard_path_id) const;
+    /**
+     * @brief
+     * Decides whether reaching the end of the input at the given wildcard path index is a match
+     *
+     * @param wildcard_path
+     * @param wildcard_path_part_index
+     * @return true
+     * @return false
+     */
+    bool is_match_at_input_end(const CompiledWildcardPath& wildcard_path, size_t wildcard_path_part_index) const;
+    /**
+     * @brief
+     * Same as the matcher, whether the segment is a last one ending with a wildcard that can take many input parts
+     *
+     * @param wildcard_path
+     * @param wildcard_path_part_index
+     * @return true
+     * @return false
+     */
+    bool should_allow_last_wildcard_as_many_paths(const CompiledWildcardPath& wildcard_path,
+                                                  size_t wildcard_path_part_index) const;
+    /**
+     * @brief
+     * Whether the wildcard path can only match inputs whose first part is its literal first segment
+     *
+     * @param wildcard_path
+     * @return true
+     * @return false
+     */
+    bool is_keyed_by_first_segment(const CompiledWildcardPath& wildcard_path) const;
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Code Generator object over the wildcard paths and settings of a matcher
+     *
+     * @param matcher
+     */
+    explicit WildcardPathCodeGenerator(const WildcardPathMatcher& matcher);
+    /**
+     * @brief
+     * Destroy the Wildcard Path Code Generator object
+     */
+    virtual ~WildcardPathCodeGenerator();
+    /**
+     * @brief
+     * Writes the header declaring the generated matcher class
+     *
+     * @param out
+     * @param class_name
+     * @param namespace_name may be nested with ::, empty for the global namespace
+     */
+    void generate_header(std::ostream& out, const std::string& class_name, const std::string& namespace_name);
+    /**
+     * @brief
+     * Writes the source defining the generated matcher class
+     *
+     * @param out
+     * @param class_name
+     * @param namespace_name may be nested with ::, empty for the global namespace
+     * @param header_include the path the source includes the generated header by
+     */
+    void generate_source(std::ostream& out,
+                         const std::string& class_name,
+                         const std::string& namespace_name,
+                         const std::string& header_include);
+};
+} // namespace octo::wildcardmatching
+#endif
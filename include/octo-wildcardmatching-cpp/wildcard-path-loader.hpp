@@ -0,0 +1,133 @@
+/**
+ * @file wildcard-path-loader.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_LOADER_HPP_
+#define WILDCARD_PATH_LOADER_HPP_
+
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-pool.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Loads a wildcard paths file, one wildcard path per line, and hot reloads it when it changes
+ * Empty lines and lines starting with # are skipped
+ * A reload builds the new matcher on the side while the current one keeps serving lookups, and then publishes it
+ * atomically. When few wildcard paths changed, the current matcher is copied and only the changed ones are removed,
+ * replaced or added, so the unchanged ones are not compiled again and the indexes are patched rather than planned
+ * Reload and poll are meant to be called from a single thread, the matcher can be taken from any thread
+ */
+class WildcardPathLoader
+{
+  public:
+    struct ReloadResult
+    {
+        // Whether a new matcher was published
+        bool changed;
+        // Wildcard paths that were not in the previous version
+        size_t added;
+        // Wildcard paths of the previous version that are gone
+        size_t removed;
+        // Wildcard paths kept from the previous version
+        size_t unchanged;
+        // Whether the new matcher was patched from a copy of the previous one, rather than built from the whole file
+        bool patched;
+    };
+
+  private:
+    std::string file_path_;
+    bool allow_last_wildcard_as_many_paths_;
+    std::shared_ptr<WildcardPathPool> pool_;
+    std::shared_ptr<const WildcardPathMatcher> matcher_;
+    bool has_file_stamp_;
+    int64_t file_modification_time_;
+    int64_t file_size_;
+
+  private:
+    /**
+     * @brief
+     * Reads the wildcard paths of the file, throws with the line number of the first invalid one
+     *
+     * @param validating_matcher
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> read_wildcard_paths_file(const WildcardPathMatcher& validating_matcher) const;
+    /**
+     * @brief
+     * Reads the modification time and size of the file
+     *
+     * @param modification_time
+     * @param size
+     * @return true
+     * @return false if the file can not be accessed
+     */
+    bool read_file_stamp(int64_t& modification_time, int64_t& size) const;
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Loader object, nothing is loaded until reload or poll are called
+     * Loaders that are given the same pool share the compiled wildcard paths between their matchers, without a pool
+     * every matcher owns its compiled wildcard paths
+     *
+     * @param file_path
+     * @param allow_last_wildcard_as_many_paths
+     * @param pool
+     */
+    WildcardPathLoader(std::string file_path,
+                       bool allow_last_wildcard_as_many_paths = false,
+                       std::shared_ptr<WildcardPathPool> pool = nullptr);
+    /**
+     * @brief
+     * Destroy the Wildcard Path Loader object
+     */
+    virtual ~WildcardPathLoader();
+    /**
+     * @brief
+     * Reads the file and publishes a new matcher if its wildcard paths changed
+     * If the file can not be read or has an invalid wildcard path, throws and keeps the current matcher
+     * The file should be replaced atomically, for example by a rename, to not be read in the middle of a write
+     *
+     * @return ReloadResult
+     */
+    ReloadResult reload();
+    /**
+     * @brief
+     * Reloads if the modification time or the size of the file changed since the last time it was loaded
+     * A missing file keeps the current matcher, a file that fails to load is not retried until it changes again
+     *
+     * @return true
+     * @return false whether a new matcher was published
+     */
+    bool poll();
+    /**
+     * @brief
+     * Get the currently published matcher, safe to call from any thread while reloading
+     * The returned matcher stays valid for as long as the caller holds it
+     *
+     * @return std::shared_ptr<const WildcardPathMatcher>
+     */
+    std::shared_ptr<const WildcardPathMatcher> get_matcher() const;
+    /**
+     * @brief
+     * Get the path of the loaded file
+     *
+     * @return const std::string&
+     */
+    const std::string& get_file_path() const;
+};
+} // namespace octo::wildcardmatching
+#endif
@@ -0,0 +1,256 @@
+/**
+ * @file wildcard-path-matcher-set.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_MATCHER_SET_HPP_
+#define WILDCARD_PATH_MATCHER_SET_HPP_
+
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <memory>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Several named lists of wildcard paths, for example allow, deny and audit, merged into a single matcher
+ * The lists are consecutive ranges of ids in the merged matcher, so a single lookup splits the input, searches the
+ * required literals and walks the candidates once, and finds the first match of every list together
+ */
+class WildcardPathMatcherSet
+{
+  private:
+    WildcardPathMatcher matcher_;
+    std::vector<std::string> list_names_;
+    // Exclusive end id of every list in the merged matcher
+    std::vector<size_t> list_ends_;
+
+  private:
+    /**
+     * @brief
+     * Get the first id of a list in the merged matcher
+     *
+     * @param list_index
+     * @return size_t
+     */
+    size_t get_list_begin(size_t list_index) const;
+    /**
+     * @brief
+     * Turns the match ids of the merged matcher into ids within their lists
+     *
+     * @param match_ids
+     */
+    void to_list_match_ids(std::vector<std::optional<size_t>>& match_ids) const;
+    /**
+     * @brief
+     * Turns the match ids of the merged matcher into views of the matching wildcard paths
+     *
+     * @param match_ids
+     * @param match_views
+     */
+    void to_match_views(const std::vector<std::optional<size_t>>& match_ids,
+                        std::vector<std::optional<std::string_view>>& match_views) const;
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Matcher Set object
+     *
+     * @param allow_last_wildcard_as_many_paths
+     * @param pool
+     */
+    WildcardPathMatcherSet(bool allow_last_wildcard_as_many_paths = false,
+                           std::shared_ptr<WildcardPathPool> pool = nullptr);
+    /**
+     * @brief
+     * Destroy the Wildcard Path Matcher Set object
+     */
+    virtual ~WildcardPathMatcherSet();
+    /**
+     * @brief
+     * Get the allow last wildcard as many paths object
+     *
+     * @return true
+     * @return false
+     */
+    bool get_allow_last_wildcard_as_many_paths() const;
+    /**
+     * @brief
+     * Get the folder seperator object
+     *
+     * @return char
+     */
+    char get_folder_seperator() const;
+    /**
+     * @brief
+     * Set the folder seperator object, for all the lists
+     *
+     * @param folder_seperator
+     */
+    void set_folder_seperator(char folder_seperator);
+    /**
+     * @brief
+     * Get the seperators accepted in the inputs on top of the folder seperator
+     *
+     * @return const std::string&
+     */
+    const std::string& get_input_folder_seperators() const;
+    /**
+     * @brief
+     * Set seperators to accept in the inputs on top of the folder seperator, for all the lists
+     *
+     * @param input_folder_seperators
+     */
+    void set_input_folder_seperators(std::string_view input_folder_seperators);
+    /**
+     * @brief
+     * Get whether the input paths are normalized
+     *
+     * @return true
+     * @return false
+     */
+    bool get_normalize_input_paths() const;
+    /**
+     * @brief
+     * Set whether the input paths are normalized while they are split, for all the lists
+     *
+     * @param normalize_input_paths
+     */
+    void set_normalize_input_paths(bool normalize_input_paths);
+    /**
+     * @brief
+     * Get the step budget of a lookup
+     *
+     * @return size_t
+     */
+    size_t get_match_step_budget() const;
+    /**
+     * @brief
+     * Set the step budget of a lookup, 0 for unbounded lookups, see WildcardPathMatcher::set_match_step_budget
+     * A single lookup walks the candidates of all the lists, so the budget is shared by them
+     *
+     * @param match_step_budget
+     */
+    void set_match_step_budget(size_t match_step_budget);
+    /**
+     * @brief
+     * Splits an input the way the lists split their inputs
+     * The input must outlive the returned path view
+     *
+     * @param input
+     * @return PathView
+     */
+    PathView create_path_view(std::string_view input) const;
+    /**
+     * @brief
+     * Adds wildcard paths to the end of the named list, the list is created if it does not exist yet
+     * Nothing is added if any of the wildcard paths is invalid
+     * Adding to the last list only appends, adding to an earlier one builds the merged matcher again
+     *
+     * @param list_name
+     * @param wildcard_paths
+     * @return size_t the index of the list
+     */
+    size_t add_wildcard_paths(const std::string& list_name, const std::vector<std::string>& wildcard_paths);
+    /**
+     * @brief
+     * Removes all the lists
+     */
+    void clean_wildcard_paths();
+    /**
+     * @brief
+     * Get the amount of lists
+     *
+     * @return size_t
+     */
+    size_t get_lists_count() const;
+    /**
+     * @brief
+     * Get the name of a list
+     *
+     * @param list_index
+     * @return const std::string&
+     */
+    const std::string& get_list_name(size_t list_index) const;
+    /**
+     * @brief
+     * Get the index of the list with the given name
+     *
+     * @param list_name
+     * @return std::optional<size_t> nothing if there is no such list
+     */
+    std::optional<size_t> get_list_index(std::string_view list_name) const;
+    /**
+     * @brief
+     * Get the wildcard paths of a list
+     *
+     * @param list_index
+     * @return std::vector<std::string>
+     */
+    std::vector<std::string> get_wildcard_paths(size_t list_index) const;
+    /**
+     * @brief
+     * Get a view of a wildcard path of a list, ids are given by the order the paths were added to the list
+     * The view is valid until the wildcard paths of the set are changed
+     *
+     * @param list_index
+     * @param wildcard_path_id
+     * @return std::string_view
+     */
+    std::string_view get_wildcard_path(size_t list_index, size_t wildcard_path_id) const;
+    /**
+     * @brief
+     * Finds the first match of every list in a single pass over the input
+     * Does not allocate once the calling thread has warmed up its scratch memory and the match ids are sized
+     *
+     * @param input
+     * @param match_ids filled per list with the id of its first matching wildcard path, nothing if none matches
+     * @return WildcardPathMatcher::MatchStatus FOUND if any list matched, BUDGET_EXCEEDED if the lists left without a
+     * match are undecided
+     */
+    WildcardPathMatcher::MatchStatus get_wildcard_match_ids(std::string_view input,
+                                                            std::vector<std::optional<size_t>>& match_ids) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_ids, over an input that was already split
+     *
+     * @param path_view
+     * @param match_ids
+     * @return WildcardPathMatcher::MatchStatus
+     */
+    WildcardPathMatcher::MatchStatus get_wildcard_match_ids(const PathView& path_view,
+                                                            std::vector<std::optional<size_t>>& match_ids) const;
+    /**
+     * @brief
+     * Finds the first match of every list in a single pass over the input, as views of the matching wildcard paths
+     * The views are valid until the wildcard paths of the set are changed
+     *
+     * @param input
+     * @param match_views filled per list with its first matching wildcard path, nothing if none matches
+     * @return WildcardPathMatcher::MatchStatus same as get_wildcard_match_ids
+     */
+    WildcardPathMatcher::MatchStatus get_wildcard_match_views(
+        std::string_view input, std::vector<std::optional<std::string_view>>& match_views) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_views, over an input that was already split
+     *
+     * @param path_view
+     * @param match_views
+     * @return WildcardPathMatcher::MatchStatus
+     */
+    WildcardPathMatcher::MatchStatus get_wildcard_match_views(
+        const PathView& path_view, std::vector<std::optional<std::string_view>>& match_views) const;
+};
+} // namespace octo::wildcardmatching
+#endif
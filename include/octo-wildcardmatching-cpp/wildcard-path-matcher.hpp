@@ -12,8 +12,19 @@
 #ifndef WILDCARD_PATH_MATCHER_HPP_
 #define WILDCARD_PATH_MATCHER_HPP_
 
+#include "octo-wildcardmatching-cpp/compiled-wildcard-path.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-storage.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-pool.hpp"
+#include "octo-wildcardmatching-cpp/literal-automaton.hpp"
+#include "octo-wildcardmatching-cpp/multi-segment-matcher.hpp"
+#include "octo-wildcardmatching-cpp/path-view.hpp"
 #include <vector>
 #include <string>
+#include <string_view>
+#include <optional>
+#include <unordered_map>
+#include <bitset>
+#include <memory>
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
@@ -23,17 +34,171 @@ namespace octo::wildcardmatching
 {
 class WildcardPathMatcher
 {
-  private:
-    struct Wildcard
+  public:
+    struct MemoryUsage
+    {
+        // Amount of wildcard paths in the matcher
+        size_t wildcard_paths;
+        // Breakdown of the flat storage the matcher owns its compiled paths in, when it has no pool
+        WildcardPathStorage::MemoryUsage storage;
+        // Memory of the required literals automaton and its posting lists
+        size_t required_literals_bytes;
+        // Memory of the first and last part indexes
+        size_t part_indexes_bytes;
+        // Memory of the matchers of the leading segments of the scanned wildcard paths
+        size_t leading_segments_bytes;
+        // Memory owned only by this matcher, including compiled paths no other matcher references
+        size_t owned_bytes;
+        // Memory of compiled paths that are also referenced by other matchers through a pool
+        size_t shared_bytes;
+    };
+
+    /**
+     * @brief
+     * How the lookups find the wildcard paths to compare, planned when the wildcard paths are added
+     * Every wildcard path is given to the engine that finds it among the fewest candidates, or scanned on every lookup
+     * if that is estimated to be cheaper
+     */
+    struct MatchPlan
     {
+        // Wildcard paths compared on every lookup, pre filter first
+        size_t scanned_wildcard_paths;
+        // Wildcard paths found by the hash of their literal first segment
+        size_t first_part_indexed_wildcard_paths;
+        // Wildcard paths found by the hash of their literal last segment, like **/name
+        size_t last_part_indexed_wildcard_paths;
+        // Wildcard paths found by their rarest required literal through the automaton
+        size_t literal_indexed_wildcard_paths;
+        // Wildcard paths added one by one since the last plan, which are all compared
+        size_t unplanned_wildcard_paths;
+        // Estimated cost of a lookup by the measured cost of every engine
+        double estimated_lookup_ns;
+    };
+    /**
+     * @brief
+     * Span of the input that one wildcard of the matching wildcard path stood for
+     */
+    struct WildcardCapture
+    {
+        // Offset and size within the input, a ** or a last * taking many paths also spans the seperators between parts
         size_t offset, size;
-        Wildcard(size_t begin, size_t end);
+    };
+    enum class MatchStatus
+    {
+        // No wildcard path matches the input
+        NOT_FOUND,
+        // A wildcard path matches the input
+        FOUND,
+        // The lookup stopped undecided, since comparing the next candidate could exceed the step budget
+        BUDGET_EXCEEDED
+    };
+    /**
+     * @brief
+     * Result of a lookup that accounts for its work
+     */
+    struct MatchResult
+    {
+        MatchStatus status;
+        // Id of the matching wildcard path, when one was found
+        size_t wildcard_path_id;
+        // Steps the lookup was charged for its candidates
+        size_t steps;
+    };
+    /**
+     * @brief
+     * Worst case work of comparing a wildcard path to an input, where a step is one card of a segment compared against
+     * an input part
+     * The segments after a ** are searched for along the input, so their work grows with the amount of input parts
+     */
+    struct WildcardPathCost
+    {
+        size_t fixed_steps;
+        size_t steps_per_part;
+    };
+
+  private:
+    /**
+     * @brief
+     * Facts every input matching a wildcard path must have, checked before comparing the segments, and its rank
+     * They depend on the allow last wildcard as many paths setting, so they are kept per matcher
+     */
+    struct WildcardPathFilter
+    {
+        // Bounds on the amount of input parts, max is UINT32_MAX if unbounded
+        uint32_t min_parts, max_parts;
+        // Amount of literal characters the input parts must have in total
+        uint32_t min_chars;
+        // Exact size of the last input part if the last segment is literal, otherwise UINT32_MAX
+        uint32_t last_part_size;
+        // Hash of the last input part if the last segment is literal
+        uint64_t last_part_hash;
+        // Signature of the literal characters the input must contain
+        uint64_t required_chars;
+        // Rank for the most specific lookups, higher is more specific
+        uint64_t specificity;
+        // Worst case cost of comparing the wildcard path, charged by the bounded lookups
+        uint32_t fixed_steps, steps_per_part;
+        // Place in the order the most specific lookups compare in, given by the plan, UINT32_MAX until then
+        uint32_t specificity_rank;
+    };
+    /**
+     * @brief
+     * Index of the wildcard paths by the hash of a literal segment that is always compared to a known input part
+     */
+    struct PartIndex
+    {
+        // Sorted part hashes, with the id of the wildcard path of every one, ascending within the same hash
+        std::vector<uint64_t> part_hashes;
+        std::vector<uint32_t> wildcard_path_ids;
+    };
+    /**
+     * @brief
+     * Captures buffer given by the caller, the count keeps going past the capacity
+     */
+    struct CaptureBuffer
+    {
+        WildcardCapture* captures;
+        size_t capacity;
+        size_t count;
     };
 
   private:
-    std::vector<std::string> wildcard_paths_;
+    WildcardPathStorage storage_;
+    std::vector<std::shared_ptr<const CompiledWildcardPath>> pooled_wildcard_paths_;
+    std::vector<WildcardPathFilter> wildcard_path_filters_;
+    // Required literals index over the first indexed wildcard paths, the ones added later are always compared
+    LiteralAutomaton required_literals_;
+    std::vector<uint32_t> required_literal_postings_offsets_;
+    std::vector<uint32_t> required_literal_postings_;
+    PartIndex first_part_index_;
+    PartIndex last_part_index_;
+    std::vector<uint32_t> scanned_wildcard_path_ids_;
+    // Matchers of the segment at every depth of the scanned wildcard paths, by their place in the scanned ids, while
+    // the segments before it are compared one to one with the input parts as well
+    std::vector<MultiSegmentMatcher> leading_segment_matchers_;
+    size_t indexed_wildcard_paths_count_;
+    MatchPlan match_plan_;
+    // Slots of the removed wildcard paths in ascending order, released once enough are stale
+    // A slot is the place of a wildcard path in the compiled storage and the match order, ids skip the removed slots
+    std::vector<uint32_t> removed_wildcard_path_slots_;
+    // Wildcard paths removed or replaced since the slots were last released
+    size_t stale_wildcard_paths_count_;
+    // Slots of the kept wildcard paths by the hash of their string, for the removals by string
+    // Built by the first one, and dropped whenever the slots are renumbered
+    std::unordered_multimap<size_t, uint32_t> wildcard_path_slots_by_hash_;
+    std::shared_ptr<WildcardPathPool> pool_;
     char folder_seperator_;
+    // Seperators accepted in the inputs on top of the folder seperator, and the table of all of them
+    std::string input_folder_seperators_;
+    std::bitset<256> input_folder_seperators_table_;
+    bool normalize_input_paths_;
     bool allow_last_wildcard_as_many_paths_;
+    // Steps a lookup may be charged, 0 if unbounded
+    size_t match_step_budget_;
+    // Whether the lookups that only tell if there is a match take an exceeded budget as one
+    bool match_on_budget_exceeded_;
+    // Steps per input part a wildcard path may cost to be added, 0 if unlimited
+    size_t max_wildcard_path_cost_;
 
   private:
     /**
@@ -43,85 +208,396 @@ class WildcardPathMatcher
     void evaluate_os_folder_seperator();
     /**
      * @brief
-     * Splits a string to a vector of strings by a given delimiter
+     * Computes the table of the seperators accepted in the inputs, the folder seperator and the additional ones
+     */
+    void update_input_folder_seperators_table();
+    /**
+     * @brief
+     * Get a path view split the way this matcher splits its inputs
+     * The given one is returned if it already is, otherwise its input is split again on the thread scratch memory
      *
-     * @param input
-     * @param delimiter
-     * @return std::vector<std::string>
+     * @param path_view
+     * @return const PathView&
+     */
+    const PathView& get_matching_path_view(const PathView& path_view) const;
+    /**
+     * @brief
+     * Compiles a validated wildcard path to its segments and cards and appends it, done once when the path is added
+     * If the matcher has a pool, the compiled path is shared through it, otherwise it goes to the matcher storage
+     *
+     * @param wildcard_path
+     */
+    void compile_wildcard_path(std::string_view wildcard_path);
+    /**
+     * @brief
+     * Compiles all the current wildcard paths again, used when a setting that affects compilation changes
+     */
+    void recompile_wildcard_paths();
+    /**
+     * @brief
+     * Computes the pre filter facts of a compiled wildcard path under the current settings
+     *
+     * @param wildcard_path
+     * @return WildcardPathFilter
+     */
+    WildcardPathFilter compute_wildcard_path_filter(const CompiledWildcardPath& wildcard_path) const;
+    /**
+     * @brief
+     * Computes the worst case cost of comparing a compiled wildcard path under the current settings
+     *
+     * @param wildcard_path
+     * @return WildcardPathCost
+     */
+    WildcardPathCost compute_wildcard_path_cost(const CompiledWildcardPath& wildcard_path) const;
+    /**
+     * @brief
+     * Computes the pre filter facts of all the wildcard paths again, used when the settings change
+     */
+    void recompute_wildcard_path_filters();
+    /**
+     * @brief
+     * Makes the pre filter of a removed wildcard path reject every input, so the indexes that still hold it never
+     * compare it
+     *
+     * @param wildcard_path_slot
+     */
+    void disable_wildcard_path_filter(size_t wildcard_path_slot);
+    /**
+     * @brief
+     * Releases the removed wildcard paths and the memory left unused by the replaced ones, the slots are
+     * renumbered to the ids
+     */
+    void release_stale_wildcard_paths();
+    /**
+     * @brief
+     * Releases the stale wildcard paths once enough were removed or replaced, and renumbers the slots the indexes hold
+     * to match, without planning the lookups again
+     */
+    void count_stale_wildcard_path();
+    /**
+     * @brief
+     * Ranks all the wildcard paths by descending specificity, and by slot within the same specificity
+     * The ranks keep their order as slots are removed or inserted, a replaced wildcard path is unranked until the next
+     * plan
+     */
+    void rank_wildcard_paths_by_specificity();
+    /**
+     * @brief
+     * Whether the most specific lookups compare the first wildcard path before the second one
+     *
+     * @param first_slot
+     * @param second_slot
+     * @return true
+     * @return false
+     */
+    bool is_more_specific_wildcard_path(size_t first_slot, size_t second_slot) const;
+    /**
+     * @brief
+     * Removes a planned wildcard path from the index that holds it, so it is no longer a candidate
+     *
+     * @param wildcard_path_slot
+     */
+    void unindex_wildcard_path(size_t wildcard_path_slot);
+    /**
+     * @brief
+     * Adds a planned wildcard path to the index of its literal first or last segment, or to the scanned ones and
+     * their leading segments matchers, without planning the lookups again
+     *
+     * @param wildcard_path_slot
+     */
+    void index_wildcard_path(size_t wildcard_path_slot);
+    /**
+     * @brief
+     * Adds a wildcard path to the slots by hash, if they were built
+     *
+     * @param wildcard_path_slot
+     */
+    void insert_wildcard_path_slot_by_hash(size_t wildcard_path_slot);
+    /**
+     * @brief
+     * Removes a wildcard path from the slots by hash, if they were built
+     *
+     * @param wildcard_path_slot
+     */
+    void erase_wildcard_path_slot_by_hash(size_t wildcard_path_slot);
+    /**
+     * @brief
+     * Get the amount of slots, the wildcard paths including the removed ones that were not released yet
+     *
+     * @return size_t
      */
-    std::vector<std::string> split_string_by_delimiter(const std::string& input, char delimiter) const;
+    size_t get_wildcard_path_slots_count() const;
     /**
      * @brief
-     * Splits a given wildcard string to wildcard structs
+     * Checks whether a slot holds a removed wildcard path
      *
-     * @param wildcard_str
-     * @return std::vector<Wildcard>
+     * @param wildcard_path_slot
+     * @return true
+     * @return false
+     */
+    bool is_removed_wildcard_path_slot(size_t wildcard_path_slot) const;
+    /**
+     * @brief
+     * Get the id of the wildcard path in a slot, which skips the removed slots before it
+     *
+     * @param wildcard_path_slot
+     * @return size_t
+     */
+    size_t to_wildcard_path_id(size_t wildcard_path_slot) const;
+    /**
+     * @brief
+     * Get the slot of the wildcard path with the given id
+     *
+     * @param wildcard_path_id
+     * @return size_t
+     */
+    size_t to_wildcard_path_slot(size_t wildcard_path_id) const;
+    /**
+     * @brief
+     * Checks whether a segment must be matched by an input part for the wildcard path to match
+     * Double wildcards and a last segment that can be left without input parts are not required
+     *
+     * @param wildcard_path
+     * @param wildcard_path_part_index
+     * @return true
+     * @return false
+     */
+    bool is_required_wildcard_segment(const CompiledWildcardPath& wildcard_path,
+                                      size_t wildcard_path_part_index) const;
+    /**
+     * @brief
+     * Plans the lookups over all the current wildcard paths and builds the indexes of the plan
+     * Every wildcard path can be found by its literal first segment, its literal last segment or its rarest required
+     * literal, the combination of these engines with the lowest estimated cost is picked and the rest is scanned
+     */
+    void rebuild_match_plan();
+    /**
+     * @brief
+     * Builds the matchers of the leading segments of the scanned wildcard paths, when there are enough of them
+     */
+    void build_leading_segment_matchers();
+    /**
+     * @brief
+     * Get the amount of leading segments of a wildcard path, the ones before the first ** or a last segment that takes
+     * many paths, which are compared to the input part at their own depth
+     *
+     * @param wildcard_path
+     * @return size_t
+     */
+    size_t get_leading_segments_count(const CompiledWildcardPath& wildcard_path) const;
+    /**
+     * @brief
+     * Appends the ids of the wildcard paths indexed by the given part hash
+     *
+     * @param part_index
+     * @param part_hash
+     * @param candidate_ids
+     */
+    static void find_part_index_candidates(const PartIndex& part_index,
+                                           uint64_t part_hash,
+                                           std::vector<uint32_t>& candidate_ids);
+    /**
+     * @brief
+     * Adds a wildcard path to a part index under the given part hash, keeping the ids ascending within the hash
+     *
+     * @param part_index
+     * @param part_hash
+     * @param wildcard_path_id
      */
-    std::vector<Wildcard> split_by_wildcards(const std::string& wildcard_str) const;
+    static void insert_part_index_entry(PartIndex& part_index, uint64_t part_hash, uint32_t wildcard_path_id);
     /**
      * @brief
-     * Compares the given two strings with wildcard possibility on the given string (*)
+     * Removes a wildcard path from a part index
      *
-     * @param wildcard_str
+     * @param part_index
+     * @param part_hash
+     * @param wildcard_path_id
+     * @return true if the part index held it under the given part hash
+     * @return false
+     */
+    static bool erase_part_index_entry(PartIndex& part_index, uint64_t part_hash, uint32_t wildcard_path_id);
+    /**
+     * @brief
+     * Checks the pre filter facts of a single wildcard path against the split input
+     *
+     * @param wildcard_path_id
+     * @param path_view
+     * @return true
+     * @return false
+     */
+    bool fits_wildcard_path_filter(size_t wildcard_path_id, const PathView& path_view) const;
+    /**
+     * @brief
+     * Get the view of the compiled wildcard path with the given id, from the pool or from the matcher storage
+     *
+     * @param wildcard_path_id
+     * @return CompiledWildcardPath
+     */
+    CompiledWildcardPath get_compiled_wildcard_path(size_t wildcard_path_id) const;
+    /**
+     * @brief
+     * Goes over the wildcard paths that are candidates for the input, in ascending ids, until the visitor stops
+     * Only instantiated by the lookups of the matcher, so it is defined with them
+     *
+     * @tparam CandidateVisitor callable taking the candidate id and returning whether to stop
+     * @param path_view split the way this matcher splits its inputs
+     * @param candidate_visitor
+     */
+    template <typename CandidateVisitor>
+    void for_each_candidate_wildcard_path(const PathView& path_view, CandidateVisitor&& candidate_visitor) const;
+    /**
+     * @brief
+     * Goes over the candidates that fit the pre filter of the input, the way every lookup does
+     * Every candidate is charged a step for the pre filter, and the worst case cost of comparing it before it is
+     * given to the visitor, so the walk stops once the next candidate could exceed the step budget
+     *
+     * @tparam CandidateVisitor callable taking the candidate id and the MatchStatus to set once the candidate matched,
+     * and returning whether to stop
+     * @param path_view split the way this matcher splits its inputs
+     * @param match_slot set to the slot of the last candidate the visitor found a match in
+     * @param steps set to the steps the lookup was charged
+     * @param candidate_visitor
+     * @return MatchStatus FOUND if the visitor found any match, BUDGET_EXCEEDED if the budget stopped the walk
+     */
+    template <typename CandidateVisitor>
+    MatchStatus visit_candidate_wildcard_paths(const PathView& path_view,
+                                               size_t& match_slot,
+                                               size_t& steps,
+                                               CandidateVisitor&& candidate_visitor) const;
+    /**
+     * @brief
+     * Finds the first compiled wildcard path that matches the input
+     * Only the wildcard paths whose required literal occurs in the input are candidates, and candidates whose
+     * pre filter facts do not fit the input are skipped without comparing their segments
+     *
+     * @param path_view split the way this matcher splits its inputs
+     * @param match_slot set to the slot of the matching wildcard path, when one was found
+     * @param steps set to the steps the lookup was charged
+     * @return MatchStatus
+     */
+    MatchStatus find_wildcard_match(const PathView& path_view, size_t& match_slot, size_t& steps) const;
+    /**
+     * @brief
+     * Finds the most specific compiled wildcard path that matches the input
+     * The candidates are compared by their specificity rank, so the first one that matches is the result, and the rest
+     * are only pre filtered and heaped once the most specific candidate did not match
+     *
+     * @param path_view split the way this matcher splits its inputs
+     * @param match_slot set to the slot of the matching wildcard path, when one was found
+     * @param steps set to the steps the lookup was charged
+     * @return MatchStatus
+     */
+    MatchStatus find_most_specific_wildcard_match(const PathView& path_view, size_t& match_slot, size_t& steps) const;
+    /**
+     * @brief
+     * Finds the first match of every input of a batch, see get_batch_wildcard_match_ids
+     * Only instantiated by the batch lookups of the matcher, so it is defined with them
+     *
+     * @tparam MatchVisitor callable taking the input index, the MatchStatus, the matching slot and the steps
+     * @param inputs
+     * @param match_visitor
+     */
+    template <typename MatchVisitor>
+    void visit_batch_wildcard_matches(const std::vector<std::string>& inputs, MatchVisitor&& match_visitor) const;
+    /**
+     * @brief
+     * Turns the status of a lookup into whether the input has a match, as decided for the exceeded budgets
+     *
+     * @param match_status
+     * @return true
+     * @return false
+     */
+    bool is_match_status_matched(MatchStatus match_status) const;
+    /**
+     * @brief
+     * Compares the given compiled segment with wildcard possibility (*) against the input string
+     *
+     * @param wildcard_path
+     * @param wildcard_segment
      * @param input_str
      * @return true
      * @return false
      */
-    bool compare_validated_wildcard_strings(const std::string& wildcard_str, const std::string& input_str) const;
+    bool compare_validated_wildcard_strings(const CompiledWildcardPath& wildcard_path,
+                                            const CompiledWildcardPath::Segment& wildcard_segment,
+                                            std::string_view input_str) const;
     /**
      * @brief
      * Compares the given input parts with the wildcard path
+     * The comparison can be resumed past leading segments that are already known to match their parts one to one
      *
      * @param input_path_parts
      * @param wildcard_path
+     * @param wildcard_path_part_index
+     * @param input_path_part_index
      * @return true
      * @return false
      */
-    bool compare_validated_wildcard_paths(const std::vector<std::string>& input_path_parts,
-                                          const std::string& wildcard_path) const;
+    bool compare_validated_wildcard_paths(const std::vector<std::string_view>& input_path_parts,
+                                          const CompiledWildcardPath& wildcard_path,
+                                          int wildcard_path_part_index = 0,
+                                          int input_path_part_index = 0) const;
+    /**
+     * @brief
+     * Finds the first occurrence of the infix block in the input parts, starting at the given input index
+     * Literal blocks are searched with KMP over the segments, blocks with wildcards with a bit parallel
+     * Shift-And over the segments, so the input parts are never scanned again on a mismatch
+     *
+     * @param wildcard_path
+     * @param wildcard_infix_begin
+     * @param wildcard_infix_size
+     * @param input_path_parts
+     * @param input_path_part_index
+     * @return int the input index right after the occurrence, or -1 if not found
+     */
+    int find_validated_wildcard_infix(const CompiledWildcardPath& wildcard_path,
+                                      int wildcard_infix_begin,
+                                      int wildcard_infix_size,
+                                      const std::vector<std::string_view>& input_path_parts,
+                                      int input_path_part_index) const;
     /**
      * @brief
      * Handles the check for double wildcard or single wildcard at the end
      *
-     * @param wildcard_path_parts
+     * @param wildcard_path
      * @param input_path_parts
      * @param wildcard_path_part_index
      * @param input_path_part_index
      * @return true
      * @return false
      */
-    bool handle_double_wildcard_part_comparison(const std::vector<std::string>& wildcard_path_parts,
-                                                const std::vector<std::string>& input_path_parts,
+    bool handle_double_wildcard_part_comparison(const CompiledWildcardPath& wildcard_path,
+                                                const std::vector<std::string_view>& input_path_parts,
                                                 int& wildcard_path_part_index,
                                                 int& input_path_part_index) const;
     /**
      * @brief
      * Handles the check for normal part which is not double wildcard or single wildcard at the end
      *
-     * @param wildcard_path_parts
+     * @param wildcard_path
      * @param input_path_parts
      * @param wildcard_path_part_index
      * @param input_path_part_index
      * @return true
      * @return false
      */
-    bool handle_normal_part_comparison(const std::vector<std::string>& wildcard_path_parts,
-                                       const std::vector<std::string>& input_path_parts,
+    bool handle_normal_part_comparison(const CompiledWildcardPath& wildcard_path,
+                                       const std::vector<std::string_view>& input_path_parts,
                                        int& wildcard_path_part_index,
                                        int& input_path_part_index) const;
     /**
      * @brief
      * Makes the final decision if a match was found or not
      *
-     * @param wildcard_path_parts
+     * @param wildcard_path
      * @param input_path_parts
      * @param wildcard_path_part_index
      * @param input_path_part_index
      * @return true
      * @return false
      */
-    bool decide_if_match_is_found(const std::vector<std::string>& wildcard_path_parts,
-                                  const std::vector<std::string>& input_path_parts,
+    bool decide_if_match_is_found(const CompiledWildcardPath& wildcard_path,
+                                  const std::vector<std::string_view>& input_path_parts,
                                   int& wildcard_path_part_index,
                                   int& input_path_part_index) const;
     /**
@@ -129,24 +605,67 @@ class WildcardPathMatcher
      * Checkes whether we can allow treating last part as a double wildcard while it being a single
      * For example if allowed then /home/\* will be good agasint /home/x/y/z
      *
-     * @param wildcard_path_part
-     * @param wildcard_path_parts
+     * @param wildcard_path
      * @param wildcard_path_part_index
      * @return true
      * @return false
      */
-    bool should_allow_last_wildcard_as_many_paths(const std::string& wildcard_path_part,
-                                                  const std::vector<std::string>& wildcard_path_parts,
+    bool should_allow_last_wildcard_as_many_paths(const CompiledWildcardPath& wildcard_path,
                                                   size_t wildcard_path_part_index) const;
+    /**
+     * @brief
+     * Adds a capture to the buffer, or only counts it once the buffer is full
+     *
+     * @param capture_buffer
+     * @param offset
+     * @param size
+     */
+    static void add_capture(CaptureBuffer& capture_buffer, size_t offset, size_t size);
+    /**
+     * @brief
+     * Captures what every * of a segment stood for within the input part it was matched to
+     * The cards are placed the way compare_validated_wildcard_strings places them, prefix and suffix anchored and the
+     * infix cards at their first occurrence
+     *
+     * @param wildcard_path
+     * @param wildcard_segment
+     * @param input
+     * @param input_part
+     * @param capture_end end offset of the last * capture, to let a last * take many paths
+     * @param capture_buffer
+     */
+    void capture_segment_wildcards(const CompiledWildcardPath& wildcard_path,
+                                   const CompiledWildcardPath::Segment& wildcard_segment,
+                                   std::string_view input,
+                                   std::string_view input_part,
+                                   size_t capture_end,
+                                   CaptureBuffer& capture_buffer) const;
+    /**
+     * @brief
+     * Captures what every wildcard of a wildcard path that is known to match stood for
+     * Follows the same decisions as compare_validated_wildcard_paths, so the captures agree with the match
+     *
+     * @param input
+     * @param input_path_parts
+     * @param wildcard_path
+     * @param capture_buffer
+     */
+    void capture_wildcard_path(std::string_view input,
+                               const std::vector<std::string_view>& input_path_parts,
+                               const CompiledWildcardPath& wildcard_path,
+                               CaptureBuffer& capture_buffer) const;
 
   public:
     /**
      * @brief
      * Construct a new Wildcard Path Matcher object
+     * Matchers constructed with the same pool share the compiled form of the wildcard paths they have in common
      *
      * @param allow_last_wildcard_as_many_paths
+     * @param pool
      */
-    WildcardPathMatcher(bool allow_last_wildcard_as_many_paths = false);
+    WildcardPathMatcher(bool allow_last_wildcard_as_many_paths = false,
+                        std::shared_ptr<WildcardPathPool> pool = nullptr);
     /**
      * @brief
      * Destroy the Wildcard Path Matcher object
@@ -164,6 +683,7 @@ class WildcardPathMatcher
     /**
      * @brief
      * Set the allow last wildcard as many paths object
+     * The pre filter facts and the required literals index of the already added wildcard paths are computed again
      *
      * @param allow_last_wildcard_as_many_paths
      */
@@ -178,10 +698,146 @@ class WildcardPathMatcher
     /**
      * @brief
      * Set the folder seperator object
+     * Already added wildcard paths are compiled again with the new seperator
      *
      * @param folder_seperator
      */
     void set_folder_seperator(char folder_seperator);
+    /**
+     * @brief
+     * Get the seperators accepted in the inputs on top of the folder seperator
+     *
+     * @return const std::string&
+     */
+    const std::string& get_input_folder_seperators() const;
+    /**
+     * @brief
+     * Set seperators to accept in the inputs on top of the folder seperator, for example both / and \
+     * They only apply to the inputs, the wildcard paths are still split by the folder seperator alone
+     *
+     * @param input_folder_seperators
+     */
+    void set_input_folder_seperators(std::string_view input_folder_seperators);
+    /**
+     * @brief
+     * Get whether the input paths are normalized
+     *
+     * @return true
+     * @return false
+     */
+    bool get_normalize_input_paths() const;
+    /**
+     * @brief
+     * Set whether the input paths are normalized while they are split, off by default
+     * Normalized inputs have their . parts dropped and their .. parts resolved lexically, on top of the repeated
+     * and trailing seperators that are always skipped, without building a normalized copy of the input
+     * Wildcard paths are not normalized, so one with . or .. parts does not match normalized inputs
+     *
+     * @param normalize_input_paths
+     */
+    void set_normalize_input_paths(bool normalize_input_paths);
+    /**
+     * @brief
+     * Splits an input the way this matcher splits its inputs, to be matched against this matcher and any other
+     * matcher with the same folder seperators and normalization without being split again
+     * The input must outlive the returned path view
+     *
+     * @param input
+     * @return PathView
+     */
+    PathView create_path_view(std::string_view input) const;
+    /**
+     * @brief
+     * Get the pool the compiled wildcard paths are shared through, nullptr if they are owned by the matcher
+     *
+     * @return std::shared_ptr<WildcardPathPool>
+     */
+    std::shared_ptr<WildcardPathPool> get_pool() const;
+    /**
+     * @brief
+     * Get the memory usage report of the matcher
+     *
+     * @return MemoryUsage
+     */
+    MemoryUsage get_memory_usage() const;
+    /**
+     * @brief
+     * Get the plan the lookups follow, which engines find how many of the wildcard paths
+     *
+     * @return MatchPlan
+     */
+    MatchPlan get_match_plan() const;
+    /**
+     * @brief
+     * Get the step budget of a lookup
+     *
+     * @return size_t
+     */
+    size_t get_match_step_budget() const;
+    /**
+     * @brief
+     * Set the step budget of a lookup, 0 for unbounded lookups
+     * Every lookup charges every candidate the worst case cost of comparing it before it does, so it never does more
+     * work than its budget. Once the next candidate could exceed it, the lookups that return a MatchStatus report the
+     * budget was exceeded, has_match follows get_match_on_budget_exceeded and the lookups of an id or a wildcard path
+     * report no match
+     *
+     * @param match_step_budget
+     */
+    void set_match_step_budget(size_t match_step_budget);
+    /**
+     * @brief
+     * Get whether has_match takes an exceeded step budget as a match
+     *
+     * @return true
+     * @return false
+     */
+    bool get_match_on_budget_exceeded() const;
+    /**
+     * @brief
+     * Set whether has_match takes an exceeded step budget as a match, false by default
+     * Set it for deny lists, so an input that was too costly to decide is denied rather than let through
+     *
+     * @param match_on_budget_exceeded
+     */
+    void set_match_on_budget_exceeded(bool match_on_budget_exceeded);
+    /**
+     * @brief
+     * Get the max cost per input part of the wildcard paths that are added
+     *
+     * @return size_t
+     */
+    size_t get_max_wildcard_path_cost() const;
+    /**
+     * @brief
+     * Set the max cost per input part of the wildcard paths that are added, 0 for no limit
+     * Wildcard paths that cost more steps per input part are invalid, so a single costly rule can not slow every lookup
+     *
+     * @param max_wildcard_path_cost
+     */
+    void set_max_wildcard_path_cost(size_t max_wildcard_path_cost);
+    /**
+     * @brief
+     * Estimates the worst case cost of comparing a wildcard path to an input under the current settings, to flag
+     * costly wildcard paths before they are added
+     *
+     * @param wildcard_path
+     * @return WildcardPathCost
+     */
+    WildcardPathCost estimate_wildcard_path_cost(std::string_view wildcard_path) const;
+    /**
+     * @brief
+     * Reserves memory ahead for the given amount of wildcard paths and total wildcard paths characters
+     *
+     * @param wildcard_paths_count
+     * @param wildcard_paths_bytes
+     */
+    void reserve(size_t wildcard_paths_count, size_t wildcard_paths_bytes = 0);
+    /**
+     * @brief
+     * Releases the memory reserved beyond the wildcard paths the matcher currently has
+     */
+    void shrink_to_fit();
     /**
      * @brief
      * Validates whether a string is a valid wildcard string
@@ -191,7 +847,7 @@ class WildcardPathMatcher
      * @return true
      * @return false
      */
-    bool validate_wildcard_path(const std::string& wildcard_path) const;
+    bool validate_wildcard_path(std::string_view wildcard_path) const;
     /**
      * @brief
      *
@@ -208,6 +864,67 @@ class WildcardPathMatcher
      * @return false
      */
     void add_wildcard_paths(const std::vector<std::string>& wildcard_paths);
+    /**
+     * @brief
+     * Same as the copying overload, but the wildcard paths strings are consumed and released as soon as they are
+     * compiled into the matcher storage
+     *
+     * @param wildcard_paths
+     */
+    void add_wildcard_paths(std::vector<std::string>&& wildcard_paths);
+    /**
+     * @brief
+     * Same as add_wildcard_paths, but the wildcard paths are validated and compiled on many threads
+     * and the indexes are built once at the end, meant for very large lists
+     * All the invalid wildcard paths are reported together in a single error, by their line number in the list
+     *
+     * @param wildcard_paths
+     * @param threads_count 0 to use the hardware concurrency
+     */
+    void add_wildcard_paths_parallel(const std::vector<std::string>& wildcard_paths, size_t threads_count = 0);
+    /**
+     * @brief
+     * Removes the wildcard path with the given id, the ids of the wildcard paths added after it move down by one
+     * It is taken out of the indexes right away, its memory is released once enough wildcard paths were removed or
+     * replaced
+     * The indexes are flat sorted arrays, so taking it out moves their tail and the cost is linear in the amount of
+     * wildcard paths
+     *
+     * @param wildcard_path_id
+     */
+    void remove_wildcard_path(size_t wildcard_path_id);
+    /**
+     * @brief
+     * Removes the first wildcard path equal to the given one, found by the hash of its string
+     *
+     * @param wildcard_path
+     * @return true if a wildcard path was removed
+     * @return false if there is no such wildcard path
+     */
+    bool remove_wildcard_path(std::string_view wildcard_path);
+    /**
+     * @brief
+     * Replaces the wildcard path with the given id, the new one keeps the id and the place in the match order
+     * It is compiled over the memory of the old one when it fits, and the indexes are patched in place: the old one is
+     * taken out, and the new one is found by its literal first or last segment, or scanned
+     * Patching the flat sorted indexes moves their tail, so the cost is linear in the amount of wildcard paths
+     *
+     * @param wildcard_path_id
+     * @param wildcard_path
+     */
+    void replace_wildcard_path(size_t wildcard_path_id, const std::string& wildcard_path);
+    /**
+     * @brief
+     * Inserts a wildcard path at the given id, the ids of the wildcard paths from it on move up by one
+     * The indexes are patched in place like for a replaced wildcard path, an id equal to the amount of wildcard paths
+     * adds it at the end
+     * The slots after it and the indexes are shifted, so the cost is linear in the amount of wildcard paths, loading
+     * the whole list is the faster way to make many changes at once
+     *
+     * @param wildcard_path_id
+     * @param wildcard_path
+     */
+    void insert_wildcard_path(size_t wildcard_path_id, const std::string& wildcard_path);
     /**
      * @brief
      *
@@ -220,24 +937,269 @@ class WildcardPathMatcher
      * @return std::vector<std::string>
      */
     std::vector<std::string> get_wildcard_paths() const;
+    /**
+     * @brief
+     * Get the amount of wildcard paths added
+     *
+     * @return size_t
+     */
+    size_t get_wildcard_paths_count() const;
+    /**
+     * @brief
+     * Get a view of the wildcard path with the given id, ids are given by the order the paths were added
+     * The view is valid until the matcher wildcard paths are changed
+     *
+     * @param wildcard_path_id
+     * @return std::string_view
+     */
+    std::string_view get_wildcard_path(size_t wildcard_path_id) const;
     /**
      * @brief
      * Checks whether a given input has a match against any of the wildcard paths added
+     * An exceeded step budget is a match only if set with set_match_on_budget_exceeded
+     * Once the calling thread has warmed up its scratch memory, this does not allocate
      *
      * @param input
      * @return true
      * @return false
      */
-    bool has_match(const std::string& input) const;
+    bool has_match(std::string_view input) const;
+    /**
+     * @brief
+     * Same as has_match, over an input that was already split, so it can be checked against many matchers
+     *
+     * @param path_view
+     * @return true
+     * @return false
+     */
+    bool has_match(const PathView& path_view) const;
+    /**
+     * @brief
+     * Checks whether any path under the given directory could match one of the wildcard paths
+     * This may return true for directories that end up with no match, but never false for one that has a match, so it
+     * also returns true once the step budget is exceeded
+     * Used to avoid walking or watching directories that can not lead to a match
+     *
+     * @param directory
+     * @return true
+     * @return false
+     */
+    bool can_match_under_directory(std::string_view directory) const;
+    /**
+     * @brief
+     * Same as can_match_under_directory, over a directory that was already split
+     *
+     * @param directory
+     * @return true
+     * @return false
+     */
+    bool can_match_under_directory(const PathView& directory) const;
     /**
      * @brief
      * If a match exists between the input and the wildcard paths, will be returned
      * Otherwise empty string will be returned
+     * Apart from the returned copy, this does not allocate once the calling thread has warmed up its scratch memory
      *
      * @param input
      * @return std::string
      */
-    std::string get_wildcard_match(const std::string& input) const;
+    std::string get_wildcard_match(std::string_view input) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match, over an input that was already split
+     *
+     * @param path_view
+     * @return std::string
+     */
+    std::string get_wildcard_match(const PathView& path_view) const;
+    /**
+     * @brief
+     * If a match exists between the input and the wildcard paths, the id of the matching wildcard path is returned
+     * Does not allocate once the calling thread has warmed up its scratch memory
+     *
+     * @param input
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> get_wildcard_match_id(std::string_view input) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_id, over an input that was already split
+     *
+     * @param path_view
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> get_wildcard_match_id(const PathView& path_view) const;
+    /**
+     * @brief
+     * If a match exists between the input and the wildcard paths, a view of the matching wildcard path is returned
+     * The view is valid until the matcher wildcard paths are changed
+     * Does not allocate once the calling thread has warmed up its scratch memory
+     *
+     * @param input
+     * @return std::optional<std::string_view>
+     */
+    std::optional<std::string_view> get_wildcard_match_view(std::string_view input) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_view, over an input that was already split
+     *
+     * @param path_view
+     * @return std::optional<std::string_view>
+     */
+    std::optional<std::string_view> get_wildcard_match_view(const PathView& path_view) const;
+    /**
+     * @brief
+     * Looks for a match between the input and the wildcard paths within the step budget, and reports the steps it was
+     * charged and whether it found a match, found none or stopped since the budget was exceeded
+     * Does not allocate once the calling thread has warmed up its scratch memory
+     *
+     * @param input
+     * @return MatchResult
+     */
+    MatchResult get_wildcard_match_result(std::string_view input) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_result, over an input that was already split
+     *
+     * @param path_view
+     * @return MatchResult
+     */
+    MatchResult get_wildcard_match_result(const PathView& path_view) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_id, and writes what every wildcard of the matching wildcard path stood for as spans of
+     * the input, in the order of the wildcards: one capture per run of * within a segment and one per ** segment
+     * A wildcard that took nothing gets an empty span where it would have started
+     * The captures are only made for the matching wildcard path once it was found, so the other lookups do not pay for
+     * them, and nothing is allocated
+     *
+     * @param input
+     * @param captures buffer of the caller, filled up to its capacity
+     * @param captures_capacity
+     * @param captures_count set to the amount of wildcards of the matching wildcard path, which can exceed the capacity
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> get_wildcard_match_captures(std::string_view input,
+                                                      WildcardCapture* captures,
+                                                      size_t captures_capacity,
+                                                      size_t& captures_count) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_captures, over an input that was already split
+     * The offsets are within the input of the path view
+     *
+     * @param path_view
+     * @param captures
+     * @param captures_capacity
+     * @param captures_count
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> get_wildcard_match_captures(const PathView& path_view,
+                                                      WildcardCapture* captures,
+                                                      size_t captures_capacity,
+                                                      size_t& captures_count) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_id, but the most specific matching wildcard path wins instead of the first added
+     * Wildcard paths are ranked by their amount of literal segments, then literal characters, then the fewer double
+     * wildcards, and by the order they were added when all of these are equal
+     * Does not allocate once the calling thread has warmed up its scratch memory
+     *
+     * @param input
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> get_most_specific_wildcard_match_id(std::string_view input) const;
+    /**
+     * @brief
+     * Same as get_most_specific_wildcard_match_id, over an input that was already split
+     *
+     * @param path_view
+     * @return std::optional<size_t>
+     */
+    std::optional<size_t> get_most_specific_wildcard_match_id(const PathView& path_view) const;
+    /**
+     * @brief
+     * Same as get_most_specific_wildcard_match_id, as a view of the matching wildcard path
+     * The view is valid until the matcher wildcard paths are changed
+     *
+     * @param input
+     * @return std::optional<std::string_view>
+     */
+    std::optional<std::string_view> get_most_specific_wildcard_match_view(std::string_view input) const;
+    /**
+     * @brief
+     * Same as get_most_specific_wildcard_match_view, over an input that was already split
+     *
+     * @param path_view
+     * @return std::optional<std::string_view>
+     */
+    std::optional<std::string_view> get_most_specific_wildcard_match_view(const PathView& path_view) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_result, but the most specific matching wildcard path wins instead of the first added
+     *
+     * @param input
+     * @return MatchResult
+     */
+    MatchResult get_most_specific_wildcard_match_result(std::string_view input) const;
+    /**
+     * @brief
+     * Same as get_most_specific_wildcard_match_result, over an input that was already split
+     *
+     * @param path_view
+     * @return MatchResult
+     */
+    MatchResult get_most_specific_wildcard_match_result(const PathView& path_view) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_id for every input of a batch, fastest when the inputs are sorted
+     * Every wildcard path keeps how far its leading segments, the ones before any double wildcard, matched the
+     * previous inputs. Leading parts shared with those inputs are not compared again, and a wildcard path whose
+     * leading segments failed on a shared part is skipped
+     * Does not allocate once the calling thread has warmed up its scratch memory and the match ids are sized
+     *
+     * @param inputs
+     * @param match_ids filled with the id of the first matching wildcard path of every input
+     */
+    void get_batch_wildcard_match_ids(const std::vector<std::string>& inputs,
+                                      std::vector<std::optional<size_t>>& match_ids) const;
+    /**
+     * @brief
+     * Same as get_batch_wildcard_match_ids, with the result of every input as get_wildcard_match_result reports it
+     * The step budget applies to every input on its own
+     *
+     * @param inputs
+     * @param match_results
+     */
+    void get_batch_wildcard_match_results(const std::vector<std::string>& inputs,
+                                          std::vector<MatchResult>& match_results) const;
+    /**
+     * @brief
+     * Finds the first match of every group of wildcard paths in a single pass over the input
+     * Groups are consecutive ranges of ids, given by their exclusive end ids in ascending order, the last one being
+     * the amount of wildcard paths. The input is split, and the required literals searched, once for all groups
+     * Does not allocate once the calling thread has warmed up its scratch memory and the match ids are sized
+     *
+     * @param input
+     * @param group_ends
+     * @param match_ids filled with the id of the first matching wildcard path of every group
+     * @return MatchStatus FOUND if any group matched, BUDGET_EXCEEDED if the groups left without a match are undecided
+     */
+    MatchStatus get_wildcard_match_ids_by_group(std::string_view input,
+                                                const std::vector<size_t>& group_ends,
+                                                std::vector<std::optional<size_t>>& match_ids) const;
+    /**
+     * @brief
+     * Same as get_wildcard_match_ids_by_group, over an input that was already split
+     *
+     * @param path_view
+     * @param group_ends
+     * @param match_ids
+     * @return MatchStatus
+     */
+    MatchStatus get_wildcard_match_ids_by_group(const PathView& path_view,
+                                                const std::vector<size_t>& group_ends,
+                                                std::vector<std::optional<size_t>>& match_ids) const;
 };
 } // namespace octo::wildcardmatching
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+/**
+ * @file wildcard-path-pool.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_POOL_HPP_
+#define WILDCARD_PATH_POOL_HPP_
+
+#include "octo-wildcardmatching-cpp/wildcard-path-storage.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Thread safe intern pool of compiled wildcard paths, shared between many matchers
+ * Matchers that are given the same pool share a single compiled copy of every wildcard path they have in common
+ * The compiled paths are packed into chunk storages, each chunk is reserved ahead so it never moves the paths in it
+ * Entries are reference counted, a compiled path leaves the pool once the last matcher using it drops it, and a chunk
+ * is released once all of its paths left the pool
+ */
+class WildcardPathPool
+{
+  public:
+    struct MemoryUsage
+    {
+        // Amount of distinct compiled paths alive in the pool
+        size_t entries;
+        // Amount of matcher references to the compiled paths
+        size_t references;
+        // Amount of chunk storages the compiled paths are packed into
+        size_t chunks;
+        // Memory of the chunk storages of the compiled paths
+        size_t compiled_paths_bytes;
+        // Memory of the pool lookup table and its entries
+        size_t index_bytes;
+    };
+
+  private:
+    struct State;
+    struct Chunk;
+    struct Entry;
+
+  private:
+    std::shared_ptr<State> state_;
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Pool object
+     */
+    WildcardPathPool();
+    /**
+     * @brief
+     * Destroy the Wildcard Path Pool object
+     * Compiled paths that are still used by matchers stay valid
+     */
+    virtual ~WildcardPathPool();
+    WildcardPathPool(const WildcardPathPool&) = delete;
+    WildcardPathPool& operator=(const WildcardPathPool&) = delete;
+    /**
+     * @brief
+     * Returns the shared compiled form of the given validated wildcard path, compiling it only if it is not in the
+     * pool yet, the returned view stays valid as long as it is referenced
+     *
+     * @param wildcard_path
+     * @param folder_seperator
+     * @return std::shared_ptr<const CompiledWildcardPath>
+     */
+    std::shared_ptr<const CompiledWildcardPath> intern(std::string_view wildcard_path, char folder_seperator);
+    /**
+     * @brief
+     * Get the amount of distinct compiled paths alive in the pool
+     *
+     * @return size_t
+     */
+    size_t get_entries_count() const;
+    /**
+     * @brief
+     * Get the memory usage report of the pool
+     *
+     * @return MemoryUsage
+     */
+    MemoryUsage get_memory_usage() const;
+};
+} // namespace octo::wildcardmatching
+#endif
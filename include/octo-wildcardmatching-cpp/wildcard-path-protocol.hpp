@@ -0,0 +1,53 @@
+/**
+ * @file wildcard-path-protocol.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_PROTOCOL_HPP_
+#define WILDCARD_PATH_PROTOCOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace octo::wildcardmatching::protocol
+{
+/**
+ * Binary protocol of the wildcard path server, over a Unix domain socket so in the byte order of the host
+ *
+ * Request:  uint32 input size | uint8 request type    | input
+ * Response: uint32 payload size | uint8 response status | payload
+ *
+ * Requests can be pipelined, the responses of a connection are sent in the order of its requests
+ */
+enum class RequestType : uint8_t
+{
+    // No payload
+    HAS_MATCH = 1,
+    // uint64 id of the first matching wildcard path when found
+    GET_WILDCARD_MATCH_ID = 2,
+    // The first matching wildcard path when found
+    GET_WILDCARD_MATCH = 3
+};
+
+enum class ResponseStatus : uint8_t
+{
+    NOT_FOUND = 0,
+    FOUND = 1,
+    // Unknown request type, the connection stays usable
+    INVALID_REQUEST = 2,
+    // The lookup stopped undecided at the step budget of the server matcher, no payload
+    BUDGET_EXCEEDED = 3
+};
+
+static constexpr size_t REQUEST_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint8_t);
+static constexpr size_t RESPONSE_HEADER_SIZE = sizeof(uint32_t) + sizeof(uint8_t);
+// Inputs above this size close the connection, they can not be a path
+static constexpr size_t MAX_INPUT_SIZE = 64 * 1024;
+} // namespace octo::wildcardmatching::protocol
+#endif
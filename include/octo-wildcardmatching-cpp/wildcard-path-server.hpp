@@ -0,0 +1,176 @@
+/**
+ * @file wildcard-path-server.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_SERVER_HPP_
+#define WILDCARD_PATH_SERVER_HPP_
+
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Serves the lookups of a single matcher to the processes of the host over a Unix domain socket, so they do not
+ * each load and compile the same wildcard paths, with the binary protocol of wildcard-path-protocol.hpp
+ * Every poll reads whatever all the connections sent, and answers all the complete requests as one batch against
+ * the same matcher, sorted so inputs that share leading parts are looked up together, with a single write per
+ * connection. Clients can pipeline their requests to fill the batches
+ * The server is not thread safe, it is meant to be polled from a single thread, the matcher can be set from any thread
+ */
+class WildcardPathServer
+{
+  private:
+    struct Connection
+    {
+        int fd;
+        // Received bytes, the requests between the begin and the end were not answered yet
+        std::vector<char> input_buffer;
+        size_t input_begin;
+        size_t input_end;
+        // Responses to send, the bytes before the offset were sent already
+        std::vector<char> output_buffer;
+        size_t output_offset;
+        // The peer is done sending, the connection is closed once its responses are sent
+        bool is_input_closed;
+        bool is_closed;
+    };
+    struct BatchRequest
+    {
+        size_t connection_index;
+        uint8_t request_type;
+        // Input within the input buffer of the connection
+        size_t input_offset;
+        size_t input_size;
+        // Place of the input in the sorted batch
+        size_t sorted_index;
+    };
+
+  private:
+    std::string socket_path_;
+    // Device and inode of the socket file this server bound
+    uint64_t socket_device_;
+    uint64_t socket_inode_;
+    std::shared_ptr<const WildcardPathMatcher> matcher_;
+    int listen_fd_;
+    std::vector<Connection> connections_;
+    // Batch of the current poll, kept to reuse their memory
+    std::vector<BatchRequest> batch_requests_;
+    std::vector<size_t> batch_order_;
+    std::vector<std::string> sorted_batch_inputs_;
+    std::vector<WildcardPathMatcher::MatchResult> batch_match_results_;
+    size_t requests_count_;
+    size_t batches_count_;
+
+  private:
+    /**
+     * @brief
+     * Accepts all the pending connections
+     */
+    void accept_connections();
+    /**
+     * @brief
+     * Reads what is available on the connection, until it would block or enough is buffered for a batch
+     *
+     * @param connection
+     */
+    void read_connection(Connection& connection);
+    /**
+     * @brief
+     * Sends as much of the pending responses of the connection as the socket takes
+     *
+     * @param connection
+     */
+    void write_connection(Connection& connection);
+    /**
+     * @brief
+     * Answers all the complete requests of all the connections together
+     *
+     * @return size_t the amount of requests answered
+     */
+    size_t serve_batch();
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Server object listening on the socket path
+     * A socket file left at the path by a server that is gone is replaced, throws if a server still listens on it
+     * or if anything other than a socket is at the path
+     *
+     * @param socket_path
+     * @param matcher
+     */
+    WildcardPathServer(std::string socket_path, std::shared_ptr<const WildcardPathMatcher> matcher);
+    /**
+     * @brief
+     * Destroy the Wildcard Path Server object, all the connections are closed and the socket file is removed, unless
+     * it was replaced meanwhile
+     */
+    virtual ~WildcardPathServer();
+    WildcardPathServer(const WildcardPathServer&) = delete;
+    WildcardPathServer& operator=(const WildcardPathServer&) = delete;
+    /**
+     * @brief
+     * Waits up to the timeout for connections and requests, and answers all the requests that arrived as one batch
+     *
+     * @param timeout_ms negative to wait forever, 0 to not wait at all
+     * @return size_t the amount of requests answered
+     */
+    size_t poll(int timeout_ms);
+    /**
+     * @brief
+     * Publishes another matcher, for example the one of a loader after a reload
+     * Batches that already started are answered by the previous matcher
+     *
+     * @param matcher
+     */
+    void set_matcher(std::shared_ptr<const WildcardPathMatcher> matcher);
+    /**
+     * @brief
+     * Get the published matcher
+     *
+     * @return std::shared_ptr<const WildcardPathMatcher>
+     */
+    std::shared_ptr<const WildcardPathMatcher> get_matcher() const;
+    /**
+     * @brief
+     * Get the path of the socket
+     *
+     * @return const std::string&
+     */
+    const std::string& get_socket_path() const;
+    /**
+     * @brief
+     * Get the amount of open connections
+     *
+     * @return size_t
+     */
+    size_t get_connections_count() const;
+    /**
+     * @brief
+     * Get the amount of requests answered
+     *
+     * @return size_t
+     */
+    size_t get_requests_count() const;
+    /**
+     * @brief
+     * Get the amount of batches the requests were answered in
+     *
+     * @return size_t
+     */
+    size_t get_batches_count() const;
+};
+} // namespace octo::wildcardmatching
+#endif
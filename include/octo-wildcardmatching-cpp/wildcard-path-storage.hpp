@@ -0,0 +1,207 @@
+/**
+ * @file wildcard-path-storage.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_STORAGE_HPP_
+#define WILDCARD_PATH_STORAGE_HPP_
+
+#include "octo-wildcardmatching-cpp/compiled-wildcard-path.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Flat storage of compiled wildcard paths, laid out as a struct of arrays
+ * All the path strings live in one contiguous character buffer, the segments and cards of all the paths
+ * live in one array each, and every path is a small record of offsets into those arrays
+ */
+class WildcardPathStorage
+{
+  public:
+    struct MemoryUsage
+    {
+        // Amount of wildcard paths in the storage
+        size_t wildcard_paths;
+        // Memory of the contiguous character buffer
+        size_t chars_bytes;
+        // Memory of the segments array
+        size_t segments_bytes;
+        // Memory of the cards array
+        size_t cards_bytes;
+        // Memory of the path records array
+        size_t records_bytes;
+        // All of the above, including the storage object itself
+        size_t total_bytes;
+    };
+
+  private:
+    struct PathRecord
+    {
+        uint32_t path_offset, path_size;
+        uint32_t first_segment, segments_count;
+        uint32_t first_card;
+    };
+
+  private:
+    std::vector<char> chars_;
+    std::vector<CompiledWildcardPath::Segment> segments_;
+    std::vector<CompiledWildcardPath::Wildcard> cards_;
+    std::vector<PathRecord> records_;
+
+  private:
+    /**
+     * @brief
+     * Appends the cards of a single segment, split by the * wildcards
+     *
+     * @param segment_str
+     * @param segment_offset
+     */
+    void append_segment_cards(std::string_view segment_str, size_t segment_offset);
+    /**
+     * @brief
+     * Computes the infix block data of the segments of a path, literal blocks get a KMP failure table
+     *
+     * @param record
+     */
+    void compile_wildcard_blocks(const PathRecord& record);
+    /**
+     * @brief
+     * Get the amount of cards of a path, the cards of all its segments
+     *
+     * @param record
+     * @return uint32_t
+     */
+    uint32_t get_cards_count(const PathRecord& record) const;
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Storage object
+     */
+    WildcardPathStorage();
+    /**
+     * @brief
+     * Destroy the Wildcard Path Storage object
+     */
+    virtual ~WildcardPathStorage();
+    /**
+     * @brief
+     * Compiles an already validated wildcard path and appends it to the storage
+     *
+     * @param wildcard_path
+     * @param folder_seperator
+     * @return size_t the index of the path within the storage
+     */
+    size_t add_wildcard_path(std::string_view wildcard_path, char folder_seperator);
+    /**
+     * @brief
+     * Appends all the compiled wildcard paths of another storage, without compiling them again
+     *
+     * @param other
+     */
+    void append(const WildcardPathStorage& other);
+    /**
+     * @brief
+     * Compiles an already validated wildcard path in place of the path at the given index
+     * The new path is written over the memory of the old one when it fits in it, otherwise it is appended and the
+     * memory of the old one is left unused until the storage is compacted
+     *
+     * @param index
+     * @param wildcard_path
+     * @param folder_seperator
+     */
+    void replace_wildcard_path(size_t index, std::string_view wildcard_path, char folder_seperator);
+    /**
+     * @brief
+     * Compiles an already validated wildcard path in at the given index, the paths from it on move up by one
+     * The new path is appended to the memory, only its place in the order is taken in the middle
+     *
+     * @param index
+     * @param wildcard_path
+     * @param folder_seperator
+     */
+    void insert_wildcard_path(size_t index, std::string_view wildcard_path, char folder_seperator);
+    /**
+     * @brief
+     * Removes the paths at the given ascending indexes, the rest keep their order and move down to fill the gaps
+     * The storage is compacted on the way, dropping the memory left unused by replaced paths
+     *
+     * @param indexes
+     */
+    void remove_wildcard_paths(const std::vector<uint32_t>& indexes);
+    /**
+     * @brief
+     * Checks whether compiling the given validated wildcard path fits in the memory already reserved
+     * Adding a path that fits keeps the views of the paths already in the storage valid
+     *
+     * @param wildcard_path
+     * @param folder_seperator
+     * @return true
+     * @return false
+     */
+    bool fits_in_reserved(std::string_view wildcard_path, char folder_seperator) const;
+    /**
+     * @brief
+     * Get a view of the compiled wildcard path at the given index
+     * Views are invalidated when paths that do not fit in the reserved memory are added to the storage
+     *
+     * @param index
+     * @return CompiledWildcardPath
+     */
+    CompiledWildcardPath get_wildcard_path(size_t index) const;
+    /**
+     * @brief
+     * Get the amount of wildcard paths in the storage
+     *
+     * @return size_t
+     */
+    size_t get_wildcard_paths_count() const;
+    /**
+     * @brief
+     * Reserves memory ahead for the given amount of wildcard paths and total path characters
+     * The segments and cards are reserved by the average of the paths already in the storage, if any
+     *
+     * @param wildcard_paths_count
+     * @param wildcard_paths_bytes
+     */
+    void reserve(size_t wildcard_paths_count, size_t wildcard_paths_bytes);
+    /**
+     * @brief
+     * Reserves memory ahead for the given amount of wildcard paths, total path characters, segments and cards
+     *
+     * @param wildcard_paths_count
+     * @param wildcard_paths_bytes
+     * @param segments_count
+     * @param cards_count
+     */
+    void reserve(size_t wildcard_paths_count, size_t wildcard_paths_bytes, size_t segments_count, size_t cards_count);
+    /**
+     * @brief
+     * Releases the memory reserved beyond the current size of the arrays
+     */
+    void shrink_to_fit();
+    /**
+     * @brief
+     * Removes all the wildcard paths, keeping the reserved memory
+     */
+    void clear();
+    /**
+     * @brief
+     * Get the memory usage breakdown of the storage
+     *
+     * @return MemoryUsage
+     */
+    MemoryUsage get_memory_usage() const;
+};
+} // namespace octo::wildcardmatching
+#endif
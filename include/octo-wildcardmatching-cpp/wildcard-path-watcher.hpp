@@ -0,0 +1,164 @@
+/**
+ * @file wildcard-path-watcher.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef WILDCARD_PATH_WATCHER_HPP_
+#define WILDCARD_PATH_WATCHER_HPP_
+
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace octo::wildcardmatching
+{
+/**
+ * @brief
+ * Linux inotify based watcher that reports the filesystem events of paths matching a wildcard path matcher
+ * Watches are only registered on directories that can still lead to a match, the events are drained from the
+ * inotify descriptor in large batches, matched together as a batch and delivered with a single callback per batch
+ * The watcher is not thread safe, it is meant to be polled from a single thread
+ */
+class WildcardPathWatcher
+{
+  public:
+    enum class EventType
+    {
+        // The path was created or moved into a watched directory
+        CREATED,
+        // The path content was modified
+        MODIFIED,
+        // The path was deleted or moved out of a watched directory
+        DELETED
+    };
+    struct Event
+    {
+        EventType type;
+        std::string path;
+        // Id of the first wildcard path the path matched
+        size_t wildcard_path_id;
+        bool is_directory;
+    };
+    typedef std::function<void(const std::vector<Event>&)> EventsCallback;
+
+  private:
+    std::shared_ptr<const WildcardPathMatcher> matcher_;
+    EventsCallback callback_;
+    int inotify_fd_;
+    std::vector<char> events_buffer_;
+    std::unordered_map<int, std::string> watched_directories_;
+    size_t max_events_per_poll_;
+    std::vector<Event> pending_events_;
+    // Scratch memory of the batch lookup, reused by every poll
+    std::vector<std::string> pending_paths_;
+    std::vector<std::optional<size_t>> pending_match_ids_;
+    size_t overflows_count_;
+
+  private:
+    /**
+     * @brief
+     * Registers a watch on the directory and on every directory under it that can still lead to a match
+     * For a directory that was just created, the paths already in it are queued as created, since they may have
+     * been created before the watch was registered
+     *
+     * @param directory
+     * @param queue_existing_paths
+     * @return true
+     * @return false whether the directory itself is watched
+     */
+    bool watch_directory_tree(const std::string& directory, bool queue_existing_paths);
+    /**
+     * @brief
+     * Removes the watches of a directory that was moved away and of the directories under it
+     *
+     * @param directory
+     */
+    void unwatch_directory_tree(const std::string& directory);
+    /**
+     * @brief
+     * Reads the events currently available on the inotify descriptor and queues them
+     *
+     * @return true
+     * @return false whether any event was read
+     */
+    bool drain_events();
+    /**
+     * @brief
+     * Matches the paths of all the queued events as a single batch and keeps only the matching events
+     */
+    void match_pending_events();
+
+  public:
+    /**
+     * @brief
+     * Construct a new Wildcard Path Watcher object
+     *
+     * @param matcher
+     * @param callback
+     * @param events_buffer_size the size of every read from the inotify descriptor
+     * @param max_events_per_poll the amount of events after which a poll stops draining, the rest are left for the
+     * next poll
+     */
+    WildcardPathWatcher(std::shared_ptr<const WildcardPathMatcher> matcher,
+                        EventsCallback callback,
+                        size_t events_buffer_size = 64 * 1024,
+                        size_t max_events_per_poll = 16 * 1024);
+    /**
+     * @brief
+     * Destroy the Wildcard Path Watcher object, all the watches are removed
+     */
+    virtual ~WildcardPathWatcher();
+    WildcardPathWatcher(const WildcardPathWatcher&) = delete;
+    WildcardPathWatcher& operator=(const WildcardPathWatcher&) = delete;
+    /**
+     * @brief
+     * Starts watching a directory tree, paths that already exist are not reported
+     * Nothing is watched if no path under the directory can match, otherwise throws if it can not be watched
+     *
+     * @param directory
+     */
+    void add_directory(const std::string& directory);
+    /**
+     * @brief
+     * Waits up to the timeout for events, drains what is available up to the max events per poll and delivers the
+     * matching ones with a single callback call
+     *
+     * @param timeout_ms negative to wait forever, 0 to not wait at all
+     * @return size_t the amount of events delivered
+     */
+    size_t poll(int timeout_ms);
+    /**
+     * @brief
+     * Get the inotify descriptor, to wait on it from an external event loop before calling poll
+     *
+     * @return int
+     */
+    int get_fd() const;
+    /**
+     * @brief
+     * Get the amount of directories currently watched
+     *
+     * @return size_t
+     */
+    size_t get_watched_directories_count() const;
+    /**
+     * @brief
+     * Get the amount of times the kernel event queue overflowed and events were lost
+     *
+     * @return size_t
+     */
+    size_t get_overflows_count() const;
+};
+} // namespace octo::wildcardmatching
+#endif
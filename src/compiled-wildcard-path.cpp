@@ -0,0 +1,78 @@
+/**
+ * @file compiled-wildcard-path.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/compiled-wildcard-path.hpp"
+
+namespace octo::wildcardmatching
+{
+
+CompiledWildcardPath::Wildcard::Wildcard(size_t begin, size_t end)
+{
+    offset = begin;
+    size = end - begin;
+}
+
+void CompiledWildcardPath::split_string_by_delimiter(std::string_view input,
+                                                     char delimiter,
+                                                     std::vector<std::string_view>& tokens)
+{
+    tokens.clear();
+    size_t token_begin = 0;
+    while (token_begin <= input.size())
+    {
+        size_t token_end = input.find(delimiter, token_begin);
+        if (token_end == std::string_view::npos)
+        {
+            token_end = input.size();
+        }
+        // If this is an empty string, move on, case of lots of /// in the same path part
+        if (token_end != token_begin)
+        {
+            tokens.push_back(input.substr(token_begin, token_end - token_begin));
+        }
+        token_begin = token_end + 1;
+    }
+}
+
+void CompiledWildcardPath::split_path_by_seperators(std::string_view input,
+                                                    const std::bitset<256>& seperators,
+                                                    bool resolve_dot_segments,
+                                                    std::vector<std::string_view>& tokens)
+{
+    tokens.clear();
+    size_t token_begin = 0;
+    for (size_t i = 0; i <= input.size(); i++)
+    {
+        if (i < input.size() && !seperators[(unsigned char)input[i]])
+        {
+            continue;
+        }
+
+        std::string_view token = input.substr(token_begin, i - token_begin);
+        token_begin = i + 1;
+        // Empty tokens are skipped like in the single delimiter split, case of lots of /// in the same path part
+        if (token.empty() || (resolve_dot_segments && token == "."))
+        {
+            continue;
+        }
+        // Going above the first part is dropped, like .. of the root directory
+        if (resolve_dot_segments && token == "..")
+        {
+            if (!tokens.empty())
+            {
+                tokens.pop_back();
+            }
+            continue;
+        }
+        tokens.push_back(token);
+    }
+}
+} // namespace octo::wildcardmatching
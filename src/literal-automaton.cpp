@@ -0,0 +1,212 @@
+/**
+ * @file literal-automaton.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/literal-automaton.hpp"
+#include <algorithm>
+
+namespace
+{
+static constexpr uint32_t ROOT_STATE = 0;
+static constexpr uint32_t NO_STATE = UINT32_MAX;
+static constexpr size_t ALPHABET_SIZE = 256;
+} // namespace
+
+namespace octo::wildcardmatching
+{
+LiteralAutomaton::LiteralAutomaton()
+{
+    literals_count_ = 0;
+}
+
+LiteralAutomaton::~LiteralAutomaton()
+{
+}
+
+uint32_t LiteralAutomaton::find_edge(uint32_t state, unsigned char c) const
+{
+    const Edge* edges_begin = edges_.data() + states_[state].first_edge;
+    const Edge* edges_end = edges_begin + states_[state].edges_count;
+    const Edge* edge =
+        std::lower_bound(edges_begin, edges_end, c, [](const Edge& edge, unsigned char c) { return edge.c < c; });
+    if (edge != edges_end && edge->c == c)
+    {
+        return edge->target;
+    }
+    return NO_STATE;
+}
+
+void LiteralAutomaton::build(const std::vector<std::string_view>& literals)
+{
+    clear();
+    literals_count_ = literals.size();
+
+    // Build the trie over the sorted literals, every literal only adds the states past its common prefix with
+    // the previous one, and the children of every state are created in increasing character order
+    std::vector<uint32_t> sorted_literal_ids(literals.size());
+    for (size_t literal_id = 0; literal_id < literals.size(); literal_id++)
+    {
+        sorted_literal_ids[literal_id] = literal_id;
+    }
+    std::sort(sorted_literal_ids.begin(), sorted_literal_ids.end(), [&literals](uint32_t left, uint32_t right) {
+        return literals[left] < literals[right];
+    });
+    std::vector<uint32_t> parents(1, ROOT_STATE);
+    std::vector<unsigned char> chars(1, 0);
+    std::vector<int32_t> literal_ids(1, -1);
+    std::vector<uint32_t> path_states(1, ROOT_STATE);
+    std::string_view previous_literal;
+    for (std::vector<uint32_t>::const_iterator literal_iter = sorted_literal_ids.begin();
+         literal_iter != sorted_literal_ids.end();
+         ++literal_iter)
+    {
+        const std::string_view literal = literals[*literal_iter];
+        size_t common_prefix_size = 0;
+        while (common_prefix_size < literal.size() && common_prefix_size < previous_literal.size() &&
+               literal[common_prefix_size] == previous_literal[common_prefix_size])
+        {
+            common_prefix_size++;
+        }
+        path_states.resize(common_prefix_size + 1);
+        for (size_t i = common_prefix_size; i < literal.size(); i++)
+        {
+            parents.push_back(path_states.back());
+            chars.push_back(literal[i]);
+            literal_ids.push_back(-1);
+            path_states.push_back(parents.size() - 1);
+        }
+        literal_ids[path_states.back()] = *literal_iter;
+        previous_literal = literal;
+    }
+
+    // Lay the edges out grouped by their parent state, a stable counting sort keeps them ordered by character
+    states_.resize(parents.size());
+    for (size_t state = 0; state < states_.size(); state++)
+    {
+        states_[state].first_edge = 0;
+        states_[state].edges_count = 0;
+        states_[state].failure = ROOT_STATE;
+        states_[state].output_link = ROOT_STATE;
+        states_[state].literal_id = literal_ids[state];
+    }
+    for (size_t state = 1; state < states_.size(); state++)
+    {
+        states_[parents[state]].edges_count++;
+    }
+    uint32_t edges_count = 0;
+    for (size_t state = 0; state < states_.size(); state++)
+    {
+        states_[state].first_edge = edges_count;
+        edges_count += states_[state].edges_count;
+    }
+    edges_.resize(edges_count);
+    std::vector<uint32_t> edges_ends(states_.size());
+    for (size_t state = 0; state < states_.size(); state++)
+    {
+        edges_ends[state] = states_[state].first_edge;
+    }
+    for (size_t state = 1; state < states_.size(); state++)
+    {
+        edges_[edges_ends[parents[state]]++] = Edge{chars[state], uint32_t(state)};
+    }
+    root_transitions_.assign(ALPHABET_SIZE, ROOT_STATE);
+    for (uint32_t edge_index = 0; edge_index < states_[ROOT_STATE].edges_count; edge_index++)
+    {
+        root_transitions_[edges_[edge_index].c] = edges_[edge_index].target;
+    }
+
+    // Compute the failure and output links breadth first, so the links of shorter prefixes are ready
+    std::vector<uint32_t> queue(states_[ROOT_STATE].edges_count);
+    for (size_t i = 0; i < queue.size(); i++)
+    {
+        queue[i] = edges_[states_[ROOT_STATE].first_edge + i].target;
+    }
+    for (size_t queue_index = 0; queue_index < queue.size(); queue_index++)
+    {
+        uint32_t state = queue[queue_index];
+        for (uint32_t edge_index = states_[state].first_edge;
+             edge_index < states_[state].first_edge + states_[state].edges_count;
+             edge_index++)
+        {
+            const Edge& edge = edges_[edge_index];
+            uint32_t failure = states_[state].failure;
+            uint32_t target = find_edge(failure, edge.c);
+            while (failure != ROOT_STATE && target == NO_STATE)
+            {
+                failure = states_[failure].failure;
+                target = find_edge(failure, edge.c);
+            }
+            states_[edge.target].failure = target == NO_STATE ? ROOT_STATE : target;
+
+            const State& failure_state = states_[states_[edge.target].failure];
+            states_[edge.target].output_link =
+                failure_state.literal_id >= 0 ? states_[edge.target].failure : failure_state.output_link;
+            queue.push_back(edge.target);
+        }
+    }
+}
+
+void LiteralAutomaton::find_literals(std::string_view input, std::vector<uint32_t>& literal_ids) const
+{
+    if (literals_count_ == 0)
+    {
+        return;
+    }
+
+    uint32_t state = ROOT_STATE;
+    for (std::string_view::const_iterator char_iter = input.begin(); char_iter != input.end(); ++char_iter)
+    {
+        const unsigned char c = *char_iter;
+        // Follow the failure links until a state has the edge, the root has all of them
+        for (;;)
+        {
+            if (state == ROOT_STATE)
+            {
+                state = root_transitions_[c];
+                break;
+            }
+            uint32_t target = find_edge(state, c);
+            if (target != NO_STATE)
+            {
+                state = target;
+                break;
+            }
+            state = states_[state].failure;
+        }
+
+        // Report the literal ending here and every literal that is a suffix of it
+        uint32_t output = states_[state].literal_id >= 0 ? state : states_[state].output_link;
+        while (output != ROOT_STATE)
+        {
+            literal_ids.push_back(states_[output].literal_id);
+            output = states_[output].output_link;
+        }
+    }
+}
+
+size_t LiteralAutomaton::get_literals_count() const
+{
+    return literals_count_;
+}
+
+void LiteralAutomaton::clear()
+{
+    states_.clear();
+    edges_.clear();
+    root_transitions_.clear();
+    literals_count_ = 0;
+}
+
+size_t LiteralAutomaton::get_memory_usage() const
+{
+    return states_.capacity() * sizeof(State) + edges_.capacity() * sizeof(Edge) +
+           root_transitions_.capacity() * sizeof(uint32_t);
+}
+} // namespace octo::wildcardmatching
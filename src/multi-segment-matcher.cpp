@@ -0,0 +1,272 @@
+/**
+ * @file multi-segment-matcher.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/multi-segment-matcher.hpp"
+#include <unordered_map>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+static constexpr char SINGLE_WILDCARD_CHAR = '*';
+static constexpr size_t ALPHABET_SIZE = 256;
+static constexpr size_t WORD_BITS = 64;
+// Words matched together in one pass over the input part, their states are kept on the stack
+static constexpr size_t WORDS_PER_PASS = 64;
+
+int count_trailing_zeros(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (int)index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+size_t count_literal_chars(std::string_view segment)
+{
+    return segment.size() - std::count(segment.begin(), segment.end(), SINGLE_WILDCARD_CHAR);
+}
+} // namespace
+
+namespace octo::wildcardmatching
+{
+MultiSegmentMatcher::MultiSegmentMatcher()
+{
+    distinct_segments_count_ = 1;
+    used_bits_ = WORD_BITS;
+}
+
+MultiSegmentMatcher::~MultiSegmentMatcher()
+{
+}
+
+void MultiSegmentMatcher::build(const std::vector<std::string_view>& segments)
+{
+    clear();
+    distinct_segment_ids_.resize(segments.size(), ANY_PART_SEGMENT_ID);
+
+    // Pack the distinct segments in order, a new word is started once the next one does not fit the current one
+    // The masks are gathered per word first, since the amount of words is only known at the end
+    std::unordered_map<std::string_view, uint32_t> distinct_segments;
+    std::vector<uint64_t> word_char_masks;
+    for (size_t segment_id = 0; segment_id < segments.size(); segment_id++)
+    {
+        std::string_view segment = segments[segment_id];
+        const size_t literal_chars = count_literal_chars(segment);
+        if (literal_chars == 0 || literal_chars > WORD_BITS)
+        {
+            continue;
+        }
+        std::unordered_map<std::string_view, uint32_t>::const_iterator distinct_iter = distinct_segments.find(segment);
+        if (distinct_iter != distinct_segments.end())
+        {
+            distinct_segment_ids_[segment_id] = distinct_iter->second;
+            continue;
+        }
+
+        if (used_bits_ + literal_chars > WORD_BITS)
+        {
+            append_word();
+            word_char_masks.resize(word_char_masks.size() + ALPHABET_SIZE, 0);
+        }
+        const uint32_t distinct_segment_id =
+            pack_distinct_segment(segment, word_char_masks.data() + (last_bits_.size() - 1) * ALPHABET_SIZE, 1);
+        distinct_segments.emplace(segment, distinct_segment_id);
+        distinct_segment_ids_[segment_id] = distinct_segment_id;
+    }
+
+    // Lay the masks of every character out across the words
+    const size_t words_count = last_bits_.size();
+    char_masks_.resize(words_count * ALPHABET_SIZE);
+    for (size_t word_index = 0; word_index < words_count; word_index++)
+    {
+        for (size_t c = 0; c < ALPHABET_SIZE; c++)
+        {
+            char_masks_[c * words_count + word_index] = word_char_masks[word_index * ALPHABET_SIZE + c];
+        }
+    }
+}
+
+void MultiSegmentMatcher::append_word()
+{
+    not_first_bits_.push_back(~uint64_t(0));
+    start_bits_.push_back(0);
+    floating_bits_.push_back(0);
+    star_bits_.push_back(0);
+    last_bits_.push_back(0);
+    last_bit_segment_ids_.resize(last_bit_segment_ids_.size() + WORD_BITS, ANY_PART_SEGMENT_ID);
+    used_bits_ = 0;
+}
+
+uint32_t MultiSegmentMatcher::pack_distinct_segment(std::string_view segment, uint64_t* word_masks, size_t char_stride)
+{
+    const uint32_t distinct_segment_id = (uint32_t)distinct_segments_count_++;
+    const size_t word_index = last_bits_.size() - 1;
+
+    // A segment starting with * may start matching at any character, the others only at the first one
+    const uint64_t first_bit = uint64_t(1) << used_bits_;
+    not_first_bits_[word_index] &= ~first_bit;
+    start_bits_[word_index] |= first_bit;
+    if (segment.front() == SINGLE_WILDCARD_CHAR)
+    {
+        floating_bits_[word_index] |= first_bit;
+    }
+    size_t bit = used_bits_;
+    for (std::string_view::const_iterator char_iter = segment.begin(); char_iter != segment.end(); ++char_iter)
+    {
+        if (*char_iter == SINGLE_WILDCARD_CHAR)
+        {
+            if (bit > used_bits_)
+            {
+                star_bits_[word_index] |= uint64_t(1) << (bit - 1);
+            }
+            continue;
+        }
+        word_masks[(unsigned char)*char_iter * char_stride] |= uint64_t(1) << bit;
+        bit++;
+    }
+    last_bits_[word_index] |= uint64_t(1) << (bit - 1);
+    last_bit_segment_ids_[word_index * WORD_BITS + bit - 1] = distinct_segment_id;
+    used_bits_ = bit;
+    return distinct_segment_id;
+}
+
+uint32_t MultiSegmentMatcher::pack_added_segment(std::string_view segment)
+{
+    const size_t literal_chars = count_literal_chars(segment);
+    if (literal_chars == 0 || literal_chars > WORD_BITS)
+    {
+        return ANY_PART_SEGMENT_ID;
+    }
+
+    // A new word takes a column in the row of every character, so the rows are laid out again
+    if (used_bits_ + literal_chars > WORD_BITS)
+    {
+        const size_t words_count = last_bits_.size();
+        std::vector<uint64_t> char_masks((words_count + 1) * ALPHABET_SIZE, 0);
+        for (size_t c = 0; c < ALPHABET_SIZE; c++)
+        {
+            std::copy(char_masks_.begin() + c * words_count,
+                      char_masks_.begin() + (c + 1) * words_count,
+                      char_masks.begin() + c * (words_count + 1));
+        }
+        char_masks_.swap(char_masks);
+        append_word();
+    }
+    const size_t words_count = last_bits_.size();
+    return pack_distinct_segment(segment, char_masks_.data() + words_count - 1, words_count);
+}
+
+void MultiSegmentMatcher::insert_segment(size_t segment_id, std::string_view segment)
+{
+    distinct_segment_ids_.insert(distinct_segment_ids_.begin() + segment_id, pack_added_segment(segment));
+}
+
+void MultiSegmentMatcher::set_segment(size_t segment_id, std::string_view segment)
+{
+    distinct_segment_ids_[segment_id] = pack_added_segment(segment);
+}
+
+void MultiSegmentMatcher::erase_segment(size_t segment_id)
+{
+    distinct_segment_ids_.erase(distinct_segment_ids_.begin() + segment_id);
+}
+
+void MultiSegmentMatcher::match(std::string_view input_part, std::vector<uint64_t>& matched_mask) const
+{
+    matched_mask.assign((distinct_segments_count_ + WORD_BITS - 1) / WORD_BITS, 0);
+    matched_mask[ANY_PART_SEGMENT_ID / WORD_BITS] |= uint64_t(1) << (ANY_PART_SEGMENT_ID % WORD_BITS);
+    if (input_part.empty())
+    {
+        return;
+    }
+
+    // The bit of a character is set once the segment matched up to it, shifting into the next character of the same
+    // segment, and staying set past a *
+    // The words of a pass are independent of each other, so the compiler can match several of them at once
+    const size_t words_count = last_bits_.size();
+    uint64_t states[WORDS_PER_PASS];
+    for (size_t pass_begin = 0; pass_begin < words_count; pass_begin += WORDS_PER_PASS)
+    {
+        const size_t pass_words = std::min(WORDS_PER_PASS, words_count - pass_begin);
+        const uint64_t* not_first_bits = not_first_bits_.data() + pass_begin;
+        const uint64_t* star_bits = star_bits_.data() + pass_begin;
+        const uint64_t* start_bits = start_bits_.data() + pass_begin;
+        const uint64_t* first_masks = char_masks_.data() + (unsigned char)input_part.front() * words_count + pass_begin;
+        for (size_t i = 0; i < pass_words; i++)
+        {
+            states[i] = start_bits[i] & first_masks[i];
+        }
+        const uint64_t* floating_bits = floating_bits_.data() + pass_begin;
+        for (std::string_view::const_iterator char_iter = input_part.begin() + 1; char_iter != input_part.end();
+             ++char_iter)
+        {
+            const uint64_t* masks = char_masks_.data() + (unsigned char)*char_iter * words_count + pass_begin;
+            for (size_t i = 0; i < pass_words; i++)
+            {
+                states[i] = ((((states[i] << 1) & not_first_bits[i]) | floating_bits[i]) & masks[i]) |
+                            (states[i] & star_bits[i]);
+            }
+        }
+
+        // A segment matches the whole part if its last character is set at the end of it
+        for (size_t i = 0; i < pass_words; i++)
+        {
+            uint64_t matched_bits = last_bits_[pass_begin + i] & states[i];
+            while (matched_bits)
+            {
+                const uint32_t distinct_segment_id =
+                    last_bit_segment_ids_[(pass_begin + i) * WORD_BITS + count_trailing_zeros(matched_bits)];
+                matched_bits &= matched_bits - 1;
+                matched_mask[distinct_segment_id / WORD_BITS] |= uint64_t(1) << (distinct_segment_id % WORD_BITS);
+            }
+        }
+    }
+}
+
+size_t MultiSegmentMatcher::get_segments_count() const
+{
+    return distinct_segment_ids_.size();
+}
+
+size_t MultiSegmentMatcher::get_distinct_segments_count() const
+{
+    return distinct_segments_count_ - 1;
+}
+
+void MultiSegmentMatcher::clear()
+{
+    distinct_segment_ids_.clear();
+    not_first_bits_.clear();
+    start_bits_.clear();
+    floating_bits_.clear();
+    star_bits_.clear();
+    last_bits_.clear();
+    char_masks_.clear();
+    last_bit_segment_ids_.clear();
+    distinct_segments_count_ = 1;
+    used_bits_ = WORD_BITS;
+}
+
+size_t MultiSegmentMatcher::get_memory_usage() const
+{
+    return distinct_segment_ids_.capacity() * sizeof(uint32_t) +
+           (not_first_bits_.capacity() + start_bits_.capacity() + floating_bits_.capacity() + star_bits_.capacity() +
+            last_bits_.capacity() + char_masks_.capacity()) *
+               sizeof(uint64_t) +
+           last_bit_segment_ids_.capacity() * sizeof(uint32_t);
+}
+} // namespace octo::wildcardmatching
@@ -0,0 +1,120 @@
+/**
+ * @file path-view.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/path-view.hpp"
+#include "octo-wildcardmatching-cpp/compiled-wildcard-path.hpp"
+
+namespace
+{
+// FNV-1a, cheap enough to compute for the last part of every input
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+} // namespace
+
+namespace octo::wildcardmatching
+{
+PathView::PathView()
+{
+    facts_ = Facts{0, 0, hash_part(std::string_view()), 0, 0};
+    folder_seperator_ = 0;
+    normalize_input_path_ = false;
+}
+
+PathView::PathView(std::string_view input,
+                   char folder_seperator,
+                   std::string_view input_folder_seperators,
+                   bool normalize_input_path)
+{
+    std::bitset<256> folder_seperators_table;
+    folder_seperators_table.set((unsigned char)folder_seperator);
+    for (std::string_view::const_iterator seperator_iter = input_folder_seperators.begin();
+         seperator_iter != input_folder_seperators.end();
+         ++seperator_iter)
+    {
+        folder_seperators_table.set((unsigned char)*seperator_iter);
+    }
+    assign(input, folder_seperator, folder_seperators_table, normalize_input_path);
+}
+
+PathView::~PathView()
+{
+}
+
+void PathView::assign(std::string_view input,
+                      char folder_seperator,
+                      const std::bitset<256>& folder_seperators_table,
+                      bool normalize_input_path)
+{
+    input_ = input;
+    folder_seperator_ = folder_seperator;
+    folder_seperators_table_ = folder_seperators_table;
+    normalize_input_path_ = normalize_input_path;
+
+    // The single seperator split is a memchr scan, keep it for the inputs that do not need more
+    if (!normalize_input_path && folder_seperators_table.count() == 1)
+    {
+        CompiledWildcardPath::split_string_by_delimiter(input, folder_seperator, parts_);
+    }
+    else
+    {
+        CompiledWildcardPath::split_path_by_seperators(input, folder_seperators_table, normalize_input_path, parts_);
+    }
+
+    facts_.parts = parts_.size();
+    facts_.last_part_size = parts_.empty() ? 0 : parts_.back().size();
+    facts_.last_part_hash = hash_part(parts_.empty() ? std::string_view() : parts_.back());
+    facts_.chars = 0;
+    facts_.chars_signature = 0;
+    for (std::vector<std::string_view>::const_iterator part_iter = parts_.begin(); part_iter != parts_.end();
+         ++part_iter)
+    {
+        facts_.chars += part_iter->size();
+        for (std::string_view::const_iterator char_iter = part_iter->begin(); char_iter != part_iter->end();
+             ++char_iter)
+        {
+            facts_.chars_signature |= uint64_t(1) << ((unsigned char)*char_iter & 63);
+        }
+    }
+}
+
+bool PathView::is_split_like(char folder_seperator,
+                             const std::bitset<256>& folder_seperators_table,
+                             bool normalize_input_path) const
+{
+    return folder_seperator_ == folder_seperator && normalize_input_path_ == normalize_input_path &&
+           folder_seperators_table_ == folder_seperators_table;
+}
+
+std::string_view PathView::get_input() const
+{
+    return input_;
+}
+
+const std::vector<std::string_view>& PathView::get_parts() const
+{
+    return parts_;
+}
+
+const PathView::Facts& PathView::get_facts() const
+{
+    return facts_;
+}
+
+uint64_t PathView::hash_part(std::string_view part)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (std::string_view::const_iterator char_iter = part.begin(); char_iter != part.end(); ++char_iter)
+    {
+        hash = (hash ^ (unsigned char)*char_iter) * FNV_PRIME;
+    }
+    return hash;
+}
+} // namespace octo::wildcardmatching
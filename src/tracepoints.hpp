@@ -0,0 +1,39 @@
+/**
+ * @file tracepoints.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef TRACEPOINTS_HPP_
+#define TRACEPOINTS_HPP_
+
+/**
+ * Static tracepoints of the library, under the octo_wildcard provider
+ * They are compiled in with the ENABLE_TRACEPOINTS option, and each one is a single nop until perf, bpftrace or
+ * systemtap attaches to it. Every lookup fires match_start and match_done, once per input for batches, for example:
+ *     bpftrace -e 'usdt:./agent:octo_wildcard:match_done { @steps = hist(arg2); }'
+ *
+ * match_start          input, input size
+ * match_done           MatchStatus, id of the matched wildcard path or -1, steps charged, candidates compared
+ * budget_exceeded      input, input size, steps charged
+ * serve_batch          requests answered by the batch, connections of the server
+ * pool_hit, pool_miss  wildcard path, wildcard path size
+ * plan                 engines mask, scanned, first part, last part and literal indexed wildcard paths
+ * publish              wildcard paths, added, removed
+ */
+#ifdef OCTO_WILDCARD_TRACEPOINTS
+#include <sys/sdt.h>
+#define OCTO_WILDCARD_TRACE(name, ...) STAP_PROBEV(octo_wildcard, name, __VA_ARGS__)
+#else
+#define OCTO_WILDCARD_TRACE(name, ...) \
+    do                                 \
+    {                                  \
+    } while (0)
+#endif
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * @file wildcard-path-client.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-client.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+// Bytes received from the server at a time
+static constexpr size_t RECEIVE_SIZE = 16 * 1024;
+// Requests of a batch sent before their responses are received, their responses are small enough to fit the socket
+// buffer, so the server never waits on the client to send them
+static constexpr size_t PIPELINE_WINDOW = 256;
+
+#ifdef MSG_NOSIGNAL
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_FLAGS = 0;
+#endif
+} // namespace
+
+namespace octo::wildcardmatching
+{
+WildcardPathClient::WildcardPathClient(std::string socket_path) : socket_path_(std::move(socket_path))
+{
+    response_begin_ = 0;
+    response_end_ = 0;
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path_.empty() || socket_path_.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error(std::string("Invalid wildcard path server socket path: [") + socket_path_ + "]");
+    }
+    memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size());
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0)
+    {
+        throw std::runtime_error(std::string("Failed to create the client socket: [") + strerror(errno) + "]");
+    }
+#ifdef SO_NOSIGPIPE
+    int no_sigpipe = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+    if (fcntl(fd_, F_SETFD, FD_CLOEXEC) < 0 ||
+        connect(fd_, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        const int connect_errno = errno;
+        close(fd_);
+        throw std::runtime_error(std::string("Failed to connect to the wildcard path server: [") + socket_path_ +
+                                 "] [" + strerror(connect_errno) + "]");
+    }
+}
+
+WildcardPathClient::~WildcardPathClient()
+{
+    close(fd_);
+}
+
+void WildcardPathClient::append_request(protocol::RequestType request_type, std::string_view input)
+{
+    if (input.size() > protocol::MAX_INPUT_SIZE)
+    {
+        // The requests appended with it are dropped as well, none of them was sent
+        request_buffer_.clear();
+        throw std::runtime_error("Input is too large for the wildcard path server");
+    }
+    const uint32_t input_size = (uint32_t)input.size();
+    const uint8_t header_request_type = (uint8_t)request_type;
+    const size_t request_offset = request_buffer_.size();
+    request_buffer_.resize(request_offset + protocol::REQUEST_HEADER_SIZE + input.size());
+    memcpy(request_buffer_.data() + request_offset, &input_size, sizeof(input_size));
+    memcpy(request_buffer_.data() + request_offset + sizeof(input_size),
+           &header_request_type,
+           sizeof(header_request_type));
+    std::copy(input.begin(), input.end(), request_buffer_.begin() + request_offset + protocol::REQUEST_HEADER_SIZE);
+}
+
+void WildcardPathClient::send_requests()
+{
+    size_t sent_size = 0;
+    while (sent_size < request_buffer_.size())
+    {
+        ssize_t write_size =
+            send(fd_, request_buffer_.data() + sent_size, request_buffer_.size() - sent_size, SEND_FLAGS);
+        if (write_size < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            request_buffer_.clear();
+            throw std::runtime_error(std::string("Failed to send to the wildcard path server: [") + strerror(errno) +
+                                     "]");
+        }
+        sent_size += write_size;
+    }
+    request_buffer_.clear();
+}
+
+protocol::ResponseStatus WildcardPathClient::receive_response(std::string_view& payload)
+{
+    size_t response_size = protocol::RESPONSE_HEADER_SIZE;
+    for (;;)
+    {
+        const size_t received_size = response_end_ - response_begin_;
+        if (received_size >= protocol::RESPONSE_HEADER_SIZE)
+        {
+            uint32_t payload_size;
+            memcpy(&payload_size, response_buffer_.data() + response_begin_, sizeof(payload_size));
+            response_size = protocol::RESPONSE_HEADER_SIZE + payload_size;
+            if (received_size >= response_size)
+            {
+                break;
+            }
+        }
+
+        // Keep only the bytes of the responses not taken yet, with room for the rest of the response
+        if (response_begin_ > 0)
+        {
+            std::copy(response_buffer_.begin() + response_begin_,
+                      response_buffer_.begin() + response_end_,
+                      response_buffer_.begin());
+            response_end_ -= response_begin_;
+            response_begin_ = 0;
+        }
+        if (response_buffer_.size() < std::max(response_end_ + RECEIVE_SIZE, response_size))
+        {
+            response_buffer_.resize(std::max(response_end_ + RECEIVE_SIZE, response_size));
+        }
+        ssize_t read_size =
+            recv(fd_, response_buffer_.data() + response_end_, response_buffer_.size() - response_end_, 0);
+        if (read_size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (read_size == 0)
+        {
+            throw std::runtime_error("The wildcard path server closed the connection");
+        }
+        if (read_size < 0)
+        {
+            throw std::runtime_error(std::string("Failed to receive from the wildcard path server: [") +
+                                     strerror(errno) + "]");
+        }
+        response_end_ += read_size;
+    }
+
+    uint8_t response_status;
+    memcpy(&response_status, response_buffer_.data() + response_begin_ + sizeof(uint32_t), sizeof(response_status));
+    payload = std::string_view(response_buffer_.data() + response_begin_ + protocol::RESPONSE_HEADER_SIZE,
+                               response_size - protocol::RESPONSE_HEADER_SIZE);
+    response_begin_ += response_size;
+    if ((protocol::ResponseStatus)response_status == protocol::ResponseStatus::INVALID_REQUEST)
+    {
+        throw std::runtime_error("The wildcard path server rejected the request");
+    }
+    return (protocol::ResponseStatus)response_status;
+}
+
+protocol::ResponseStatus WildcardPathClient::request(protocol::RequestType request_type,
+                                                     std::string_view input,
+                                                     std::string_view& payload)
+{
+    append_request(request_type, input);
+    send_requests();
+    return receive_response(payload);
+}
+
+bool WildcardPathClient::has_match(std::string_view input)
+{
+    std::string_view payload;
+    return request(protocol::RequestType::HAS_MATCH, input, payload) == protocol::ResponseStatus::FOUND;
+}
+
+std::string WildcardPathClient::get_wildcard_match(std::string_view input)
+{
+    std::string_view payload;
+    if (request(protocol::RequestType::GET_WILDCARD_MATCH, input, payload) != protocol::ResponseStatus::FOUND)
+    {
+        return "";
+    }
+    return std::string(payload);
+}
+
+std::optional<size_t> WildcardPathClient::get_wildcard_match_id(std::string_view input)
+{
+    std::string_view payload;
+    if (request(protocol::RequestType::GET_WILDCARD_MATCH_ID, input, payload) != protocol::ResponseStatus::FOUND ||
+        payload.size() != sizeof(uint64_t))
+    {
+        return std::nullopt;
+    }
+    uint64_t wildcard_path_id;
+    memcpy(&wildcard_path_id, payload.data(), sizeof(wildcard_path_id));
+    return wildcard_path_id;
+}
+
+void WildcardPathClient::get_wildcard_match_ids(const std::vector<std::string>& inputs,
+                                                std::vector<std::optional<size_t>>& match_ids)
+{
+    match_ids.assign(inputs.size(), std::nullopt);
+    for (size_t window_begin = 0; window_begin < inputs.size(); window_begin += PIPELINE_WINDOW)
+    {
+        const size_t window_end = std::min(window_begin + PIPELINE_WINDOW, inputs.size());
+        for (size_t input_index = window_begin; input_index < window_end; input_index++)
+        {
+            append_request(protocol::RequestType::GET_WILDCARD_MATCH_ID, inputs[input_index]);
+        }
+        send_requests();
+        for (size_t input_index = window_begin; input_index < window_end; input_index++)
+        {
+            std::string_view payload;
+            if (receive_response(payload) == protocol::ResponseStatus::FOUND && payload.size() == sizeof(uint64_t))
+            {
+                uint64_t wildcard_path_id;
+                memcpy(&wildcard_path_id, payload.data(), sizeof(wildcard_path_id));
+                match_ids[input_index] = wildcard_path_id;
+            }
+        }
+    }
+}
+
+const std::string& WildcardPathClient::get_socket_path() const
+{
+    return socket_path_;
+}
+} // namespace octo::wildcardmatching
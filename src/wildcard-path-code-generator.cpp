@@ -0,0 +1,570 @@
+/**
+ * @file wildcard-path-code-generator.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-code-generator.hpp"
+#include <bitset>
+#include <cstdint>
+
+namespace
+{
+static constexpr char GENERATED_NOTICE[] = "// Generated by octo-wildcardmatching-cpp-generator, do not edit\n";
+
+// Splits the input by the folder seperator alone, like the matcher does when it has no input options
+static constexpr char GENERATED_SPLIT[] = R"(
+void split_input_path(std::string_view input, std::vector<std::string_view>& input_path_parts)
+{
+    input_path_parts.clear();
+    size_t token_begin = 0;
+    while (token_begin <= input.size())
+    {
+        size_t token_end = input.find(FOLDER_SEPERATOR, token_begin);
+        if (token_end == std::string_view::npos)
+        {
+            token_end = input.size();
+        }
+        if (token_end != token_begin)
+        {
+            input_path_parts.push_back(input.substr(token_begin, token_end - token_begin));
+        }
+        token_begin = token_end + 1;
+    }
+}
+)";
+
+// Splits the input by all the input seperators and resolves its dot segments if normalized, in a single scan
+static constexpr char GENERATED_NORMALIZING_SPLIT[] = R"(
+void split_input_path(std::string_view input, std::vector<std::string_view>& input_path_parts)
+{
+    input_path_parts.clear();
+    size_t token_begin = 0;
+    for (size_t i = 0; i <= input.size(); i++)
+    {
+        if (i < input.size() && !is_input_folder_seperator(input[i]))
+        {
+            continue;
+        }
+        std::string_view token = input.substr(token_begin, i - token_begin);
+        token_begin = i + 1;
+        if (token.empty() || (NORMALIZE_INPUT_PATHS && token == "."))
+        {
+            continue;
+        }
+        if (NORMALIZE_INPUT_PATHS && token == "..")
+        {
+            if (!input_path_parts.empty())
+            {
+                input_path_parts.pop_back();
+            }
+            continue;
+        }
+        input_path_parts.push_back(token);
+    }
+}
+)";
+
+// Shared helpers of every generated source, the segment functions are built on them
+static constexpr char GENERATED_HELPERS[] = R"(
+inline bool find_infix_card(std::string_view part, size_t& begin, size_t end, std::string_view card)
+{
+    size_t found = std::string_view(part.data() + begin, end - begin).find(card);
+    if (found == std::string_view::npos)
+    {
+        return false;
+    }
+    begin += found + card.size();
+    return true;
+}
+)";
+} // namespace
+
+namespace octo::wildcardmatching
+{
+WildcardPathCodeGenerator::WildcardPathCodeGenerator(const WildcardPathMatcher& matcher)
+{
+    folder_seperator_ = matcher.get_folder_seperator();
+    input_folder_seperators_ = matcher.get_input_folder_seperators();
+    normalize_input_paths_ = matcher.get_normalize_input_paths();
+    allow_last_wildcard_as_many_paths_ = matcher.get_allow_last_wildcard_as_many_paths();
+    for (size_t wildcard_path_id = 0; wildcard_path_id < matcher.get_wildcard_paths_count(); wildcard_path_id++)
+    {
+        storage_.add_wildcard_path(matcher.get_wildcard_path(wildcard_path_id), folder_seperator_);
+    }
+
+    // The storage is complete, so the segment views stay valid as keys
+    for (size_t wildcard_path_id = 0; wildcard_path_id < storage_.get_wildcard_paths_count(); wildcard_path_id++)
+    {
+        CompiledWildcardPath wildcard_path = storage_.get_wildcard_path(wildcard_path_id);
+        for (size_t i = 0; i < wildcard_path.segments_count; i++)
+        {
+            if (!wildcard_path.segments[i].is_double_wildcard)
+            {
+                segment_function_ids_.emplace(wildcard_path.get_segment_string(wildcard_path.segments[i]),
+                                              segment_function_ids_.size());
+            }
+        }
+    }
+}
+
+WildcardPathCodeGenerator::~WildcardPathCodeGenerator()
+{
+}
+
+void WildcardPathCodeGenerator::write_escaped_string(std::ostream& out, std::string_view str)
+{
+    static constexpr char OCTAL_DIGITS[] = "01234567";
+    for (std::string_view::const_iterator char_iter = str.begin(); char_iter != str.end(); ++char_iter)
+    {
+        const unsigned char c = *char_iter;
+        // Octal escapes always take three digits, so they can not run into the next character
+        if (c < 0x20 || c >= 0x7f || c == '"' || c == '\\' || c == '?')
+        {
+            out << '\\' << OCTAL_DIGITS[c >> 6] << OCTAL_DIGITS[(c >> 3) & 7] << OCTAL_DIGITS[c & 7];
+        }
+        else
+        {
+            out << c;
+        }
+    }
+}
+
+void WildcardPathCodeGenerator::write_string_literal(std::ostream& out, std::string_view str)
+{
+    out << "std::string_view(\"";
+    write_escaped_string(out, str);
+    out << "\", " << str.size() << ")";
+}
+
+void WildcardPathCodeGenerator::write_namespace(std::ostream& out, const std::string& namespace_name, bool is_opening)
+{
+    if (namespace_name.empty())
+    {
+        return;
+    }
+    if (is_opening)
+    {
+        out << "namespace " << namespace_name << "\n{\n";
+    }
+    else
+    {
+        out << "} // namespace " << namespace_name << "\n";
+    }
+}
+
+void WildcardPathCodeGenerator::write_segment_functions(std::ostream& out)
+{
+    for (std::map<std::string_view, size_t>::const_iterator segment_iter = segment_function_ids_.begin();
+         segment_iter != segment_function_ids_.end();
+         ++segment_iter)
+    {
+        // Split the segment to its cards the same way the storage does
+        std::vector<std::string_view> cards;
+        const std::string_view segment_str = segment_iter->first;
+        size_t card_begin = 0;
+        for (size_t pos = segment_str.find('*'); pos != std::string_view::npos; pos = segment_str.find('*', card_begin))
+        {
+            if (pos != card_begin || cards.empty())
+            {
+                cards.push_back(segment_str.substr(card_begin, pos - card_begin));
+            }
+            card_begin = pos + 1;
+        }
+        cards.push_back(segment_str.substr(card_begin));
+
+        out << "\n// ";
+        write_escaped_string(out, segment_str);
+        // A lone * matches any part, without looking at it
+        const size_t min_part_size = cards.front().size() + cards.back().size();
+        const bool is_any_part = cards.size() == 2 && min_part_size == 0;
+        out << "\ninline bool match_segment_" << segment_iter->second
+            << (is_any_part ? "(std::string_view)\n{\n" : "(std::string_view part)\n{\n");
+        if (cards.size() == 1)
+        {
+            out << "    return part == ";
+            write_string_literal(out, cards[0]);
+            out << ";\n}\n";
+            continue;
+        }
+
+        const std::string_view prefix_card = cards.front();
+        const std::string_view suffix_card = cards.back();
+        if (min_part_size > 0)
+        {
+            out << "    if (part.size() < " << min_part_size << ")\n    {\n        return false;\n    }\n";
+        }
+        if (!prefix_card.empty())
+        {
+            out << "    if (part.compare(0, " << prefix_card.size() << ", ";
+            write_string_literal(out, prefix_card);
+            out << ") != 0)\n    {\n        return false;\n    }\n";
+        }
+        if (!suffix_card.empty())
+        {
+            out << "    if (part.compare(part.size() - " << suffix_card.size() << ", " << suffix_card.size() << ", ";
+            write_string_literal(out, suffix_card);
+            out << ") != 0)\n    {\n        return false;\n    }\n";
+        }
+        if (cards.size() > 2)
+        {
+            // The infix cards are searched in order, each one after the previous, between the prefix and suffix
+            out << "    size_t begin = " << prefix_card.size() << ";\n";
+            out << "    const size_t end = part.size() - " << suffix_card.size() << ";\n";
+            out << "    return";
+            for (size_t i = 1; i + 1 < cards.size(); i++)
+            {
+                out << (i == 1 ? " " : " &&\n           ") << "find_infix_card(part, begin, end, ";
+                write_string_literal(out, cards[i]);
+                out << ")";
+            }
+            out << ";\n}\n";
+        }
+        else
+        {
+            out << "    return true;\n}\n";
+        }
+    }
+}
+
+void WildcardPathCodeGenerator::write_segment_call(std::ostream& out,
+                                                   const CompiledWildcardPath& wildcard_path,
+                                                   size_t wildcard_path_part_index,
+                                                   const std::string& input_part) const
+{
+    out << "match_segment_"
+        << segment_function_ids_.at(wildcard_path.get_segment_string(wildcard_path.segments[wildcard_path_part_index]))
+        << "(" << input_part << ")";
+}
+
+bool WildcardPathCodeGenerator::should_allow_last_wildcard_as_many_paths(const CompiledWildcardPath& wildcard_path,
+                                                                         size_t wildcard_path_part_index) const
+{
+    return allow_last_wildcard_as_many_paths_ && wildcard_path.segments[wildcard_path_part_index].ends_with_wildcard &&
+           (wildcard_path_part_index + 1) == wildcard_path.segments_count;
+}
+
+bool WildcardPathCodeGenerator::is_match_at_input_end(const CompiledWildcardPath& wildcard_path,
+                                                      size_t wildcard_path_part_index) const
+{
+    while (wildcard_path_part_index < wildcard_path.segments_count &&
+           wildcard_path.segments[wildcard_path_part_index].is_double_wildcard)
+    {
+        wildcard_path_part_index++;
+    }
+    return wildcard_path_part_index == wildcard_path.segments_count ||
+           ((wildcard_path_part_index + 1) == wildcard_path.segments_count &&
+            wildcard_path.segments[wildcard_path_part_index].starts_with_wildcard &&
+            allow_last_wildcard_as_many_paths_);
+}
+
+bool WildcardPathCodeGenerator::is_keyed_by_first_segment(const CompiledWildcardPath& wildcard_path) const
+{
+    // A literal first segment is compared to the first input part before anything else, and never left unmatched
+    return wildcard_path.segments_count > 0 && !wildcard_path.segments[0].is_double_wildcard &&
+           wildcard_path.segments[0].card_count == 1;
+}
+
+void WildcardPathCodeGenerator::write_wildcard_path_function(std::ostream& out, size_t wildcard_path_id) const
+{
+    CompiledWildcardPath wildcard_path = storage_.get_wildcard_path(wildcard_path_id);
+    const size_t wildcard_path_parts_count = wildcard_path.segments_count;
+
+    out << "\n// ";
+    write_escaped_string(out, wildcard_path.path);
+    out << "\nbool match_wildcard_path_" << wildcard_path_id
+        << "(const std::string_view* parts, size_t parts_count)\n{\n";
+    out << "    size_t index = 0;\n";
+
+    size_t wildcard_path_part_index = 0;
+    for (;;)
+    {
+        if (wildcard_path_part_index == wildcard_path_parts_count)
+        {
+            out << "    return index == parts_count;\n";
+            break;
+        }
+        out << "    if (index == parts_count)\n    {\n        return "
+            << (is_match_at_input_end(wildcard_path, wildcard_path_part_index) ? "true" : "false") << ";\n    }\n";
+
+        if (!wildcard_path.segments[wildcard_path_part_index].is_double_wildcard &&
+            !should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_path_part_index))
+        {
+            out << "    if (!";
+            write_segment_call(out, wildcard_path, wildcard_path_part_index, "parts[index]");
+            out << ")\n    {\n        return false;\n    }\n    index++;\n";
+            wildcard_path_part_index++;
+            continue;
+        }
+
+        while (wildcard_path_part_index < wildcard_path_parts_count &&
+               wildcard_path.segments[wildcard_path_part_index].is_double_wildcard)
+        {
+            wildcard_path_part_index++;
+        }
+        if (wildcard_path_part_index == wildcard_path_parts_count)
+        {
+            out << "    return true;\n";
+            break;
+        }
+
+        // The block up to the next double wildcard is looked for at its first occurrence
+        const size_t infix_begin = wildcard_path_part_index;
+        while (wildcard_path_part_index < wildcard_path_parts_count &&
+               !wildcard_path.segments[wildcard_path_part_index].is_double_wildcard)
+        {
+            wildcard_path_part_index++;
+        }
+        const size_t infix_size = wildcard_path_part_index - infix_begin;
+        out << "    {\n        size_t found = NO_MATCH;\n";
+        out << "        for (size_t start = index; start + " << infix_size << " <= parts_count; start++)\n        {\n";
+        out << "            if (";
+        for (size_t i = 0; i < infix_size; i++)
+        {
+            out << (i == 0 ? "" : " &&\n                ");
+            write_segment_call(out,
+                               wildcard_path,
+                               infix_begin + i,
+                               i == 0 ? "parts[start]" : "parts[start + " + std::to_string(i) + "]");
+        }
+        out << ")\n            {\n                found = start + " << infix_size << ";\n                break;\n"
+            << "            }\n        }\n";
+        out << "        if (found == NO_MATCH)\n        {\n            return false;\n        }\n";
+        out << "        index = found;\n    }\n";
+
+        if (wildcard_path_part_index == wildcard_path_parts_count &&
+            should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_path_part_index - 1))
+        {
+            out << "    return true;\n";
+            break;
+        }
+        if (wildcard_path_part_index == wildcard_path_parts_count)
+        {
+            // The last block must also fit the end of the input exactly
+            out << "    return index == parts_count ||\n           (";
+            for (size_t i = 0; i < infix_size; i++)
+            {
+                out << (i == 0 ? "" : " &&\n            ");
+                write_segment_call(out,
+                                   wildcard_path,
+                                   infix_begin + i,
+                                   "parts[parts_count - " + std::to_string(infix_size - i) + "]");
+            }
+            out << ");\n";
+            break;
+        }
+    }
+    out << "}\n";
+}
+
+void WildcardPathCodeGenerator::generate_header(std::ostream& out,
+                                                const std::string& class_name,
+                                                const std::string& namespace_name)
+{
+    std::string include_guard = namespace_name + "_" + class_name + "_HPP_";
+    for (std::string::iterator char_iter = include_guard.begin(); char_iter != include_guard.end(); ++char_iter)
+    {
+        *char_iter = isalnum((unsigned char)*char_iter) ? toupper((unsigned char)*char_iter) : '_';
+    }
+
+    out << GENERATED_NOTICE << "\n";
+    out << "#ifndef " << include_guard << "\n#define " << include_guard << "\n\n";
+    out << "#include <optional>\n#include <string>\n#include <string_view>\n#include <vector>\n\n";
+    write_namespace(out, namespace_name, true);
+    out << "class " << class_name << "\n{\n  public:\n";
+    out << "    bool get_allow_last_wildcard_as_many_paths() const;\n";
+    out << "    char get_folder_seperator() const;\n";
+    out << "    std::string get_input_folder_seperators() const;\n";
+    out << "    bool get_normalize_input_paths() const;\n";
+    out << "    std::vector<std::string> get_wildcard_paths() const;\n";
+    out << "    size_t get_wildcard_paths_count() const;\n";
+    out << "    std::string_view get_wildcard_path(size_t wildcard_path_id) const;\n";
+    out << "    bool has_match(std::string_view input) const;\n";
+    out << "    std::string get_wildcard_match(std::string_view input) const;\n";
+    out << "    std::optional<size_t> get_wildcard_match_id(std::string_view input) const;\n";
+    out << "    std::optional<std::string_view> get_wildcard_match_view(std::string_view input) const;\n";
+    out << "};\n";
+    write_namespace(out, namespace_name, false);
+    out << "#endif\n";
+}
+
+void WildcardPathCodeGenerator::generate_source(std::ostream& out,
+                                                const std::string& class_name,
+                                                const std::string& namespace_name,
+                                                const std::string& header_include)
+{
+    const size_t wildcard_paths_count = storage_.get_wildcard_paths_count();
+
+    out << GENERATED_NOTICE << "\n";
+    out << "#include \"" << header_include << "\"\n";
+    out << "#include <cstdint>\n#include <stdexcept>\n\n";
+    out << "namespace\n{\n";
+    out << "static constexpr char FOLDER_SEPERATOR = " << int((unsigned char)folder_seperator_) << ";\n";
+    out << "static constexpr bool ALLOW_LAST_WILDCARD_AS_MANY_PATHS = "
+        << (allow_last_wildcard_as_many_paths_ ? "true" : "false") << ";\n";
+    out << "static constexpr size_t WILDCARD_PATHS_COUNT = " << wildcard_paths_count << ";\n";
+    out << "static constexpr std::string_view WILDCARD_PATHS[] = {\n";
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
+    {
+        out << "    ";
+        write_string_literal(out, storage_.get_wildcard_path(wildcard_path_id).path);
+        out << ",\n";
+    }
+    // Keeps the array valid when there are no wildcard paths
+    out << "    std::string_view()};\n";
+    out << "static constexpr size_t NO_MATCH = SIZE_MAX;\n";
+    if (!normalize_input_paths_ && input_folder_seperators_.empty())
+    {
+        out << GENERATED_SPLIT;
+    }
+    else
+    {
+        out << "static constexpr bool NORMALIZE_INPUT_PATHS = " << (normalize_input_paths_ ? "true" : "false")
+            << ";\n";
+        out << "\ninline bool is_input_folder_seperator(char c)\n{\n    switch ((unsigned char)c)\n    {\n";
+        // Every seperator is written once, a repeated case label would not compile
+        std::bitset<256> seperators;
+        seperators.set((unsigned char)folder_seperator_);
+        for (std::string::const_iterator seperator_iter = input_folder_seperators_.begin();
+             seperator_iter != input_folder_seperators_.end();
+             ++seperator_iter)
+        {
+            seperators.set((unsigned char)*seperator_iter);
+        }
+        for (size_t c = 0; c < seperators.size(); c++)
+        {
+            if (seperators[c])
+            {
+                out << "        case " << c << ":\n";
+            }
+        }
+        out << "            return true;\n        default:\n            return false;\n    }\n}\n";
+        out << GENERATED_NORMALIZING_SPLIT;
+    }
+    out << GENERATED_HELPERS;
+
+    write_segment_functions(out);
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
+    {
+        write_wildcard_path_function(out, wildcard_path_id);
+    }
+
+    // Group the wildcard paths by their literal first segment, the rest are checked for every input
+    std::map<std::string_view, std::vector<size_t>> keyed_wildcard_path_ids;
+    std::vector<size_t> unkeyed_wildcard_path_ids;
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
+    {
+        CompiledWildcardPath wildcard_path = storage_.get_wildcard_path(wildcard_path_id);
+        if (is_keyed_by_first_segment(wildcard_path))
+        {
+            keyed_wildcard_path_ids[wildcard_path.get_segment_string(wildcard_path.segments[0])].push_back(
+                wildcard_path_id);
+        }
+        else
+        {
+            unkeyed_wildcard_path_ids.push_back(wildcard_path_id);
+        }
+    }
+
+    std::map<size_t, std::vector<std::pair<std::string_view, size_t>>> groups_by_size;
+    size_t group_id = 0;
+    for (std::map<std::string_view, std::vector<size_t>>::const_iterator group_iter = keyed_wildcard_path_ids.begin();
+         group_iter != keyed_wildcard_path_ids.end();
+         ++group_iter, ++group_id)
+    {
+        groups_by_size[group_iter->first.size()].push_back(std::make_pair(group_iter->first, group_id));
+        out << "\n// ";
+        write_escaped_string(out, group_iter->first);
+        out << "\nsize_t match_keyed_wildcard_paths_" << group_id
+            << "(const std::string_view* parts, size_t parts_count)\n{\n";
+        for (std::vector<size_t>::const_iterator id_iter = group_iter->second.begin();
+             id_iter != group_iter->second.end();
+             ++id_iter)
+        {
+            out << "    if (match_wildcard_path_" << *id_iter << "(parts, parts_count))\n    {\n        return "
+                << *id_iter << ";\n    }\n";
+        }
+        out << "    return NO_MATCH;\n}\n";
+    }
+
+    // Only the wildcard paths added before the keyed match can take precedence over it
+    out << "\nsize_t match_unkeyed_wildcard_paths(const std::string_view* parts, size_t parts_count, size_t "
+           "first_match)\n{\n";
+    for (std::vector<size_t>::const_iterator id_iter = unkeyed_wildcard_path_ids.begin();
+         id_iter != unkeyed_wildcard_path_ids.end();
+         ++id_iter)
+    {
+        out << "    if (first_match < " << *id_iter << ")\n    {\n        return first_match;\n    }\n";
+        out << "    if (match_wildcard_path_" << *id_iter << "(parts, parts_count))\n    {\n        return "
+            << *id_iter << ";\n    }\n";
+    }
+    out << "    return first_match;\n}\n";
+
+    out << "\nsize_t find_wildcard_match(std::string_view input)\n{\n";
+    out << "    thread_local std::vector<std::string_view> input_path_parts;\n";
+    out << "    split_input_path(input, input_path_parts);\n";
+    out << "    const std::string_view* parts = input_path_parts.data();\n";
+    out << "    const size_t parts_count = input_path_parts.size();\n";
+    out << "    size_t first_match = NO_MATCH;\n";
+    if (!groups_by_size.empty())
+    {
+        out << "    if (parts_count > 0)\n    {\n        switch (parts[0].size())\n        {\n";
+        for (std::map<size_t, std::vector<std::pair<std::string_view, size_t>>>::const_iterator size_iter =
+                 groups_by_size.begin();
+             size_iter != groups_by_size.end();
+             ++size_iter)
+        {
+            out << "            case " << size_iter->first << ":\n";
+            for (size_t i = 0; i < size_iter->second.size(); i++)
+            {
+                out << "                " << (i == 0 ? "if" : "else if") << " (parts[0] == ";
+                write_string_literal(out, size_iter->second[i].first);
+                out << ")\n                {\n                    first_match = match_keyed_wildcard_paths_"
+                    << size_iter->second[i].second << "(parts, parts_count);\n                }\n";
+            }
+            out << "                break;\n";
+        }
+        out << "            default:\n                break;\n        }\n    }\n";
+    }
+    out << "    return match_unkeyed_wildcard_paths(parts, parts_count, first_match);\n}\n";
+    out << "} // namespace\n\n";
+
+    write_namespace(out, namespace_name, true);
+    const std::string scope = class_name + "::";
+    out << "bool " << scope << "get_allow_last_wildcard_as_many_paths() const\n{\n"
+        << "    return ALLOW_LAST_WILDCARD_AS_MANY_PATHS;\n}\n\n";
+    out << "char " << scope << "get_folder_seperator() const\n{\n    return FOLDER_SEPERATOR;\n}\n\n";
+    out << "std::string " << scope << "get_input_folder_seperators() const\n{\n    return std::string(";
+    write_string_literal(out, input_folder_seperators_);
+    out << ");\n}\n\n";
+    out << "bool " << scope << "get_normalize_input_paths() const\n{\n    return "
+        << (normalize_input_paths_ ? "true" : "false") << ";\n}\n\n";
+    out << "std::vector<std::string> " << scope << "get_wildcard_paths() const\n{\n"
+        << "    return std::vector<std::string>(WILDCARD_PATHS, WILDCARD_PATHS + WILDCARD_PATHS_COUNT);\n}\n\n";
+    out << "size_t " << scope << "get_wildcard_paths_count() const\n{\n    return WILDCARD_PATHS_COUNT;\n}\n\n";
+    out << "std::string_view " << scope << "get_wildcard_path(size_t wildcard_path_id) const\n{\n"
+        << "    if (wildcard_path_id >= WILDCARD_PATHS_COUNT)\n    {\n"
+        << "        throw std::runtime_error(std::string(\"The wildcard path id is invalid: [\") + "
+           "std::to_string(wildcard_path_id) +\n                                 \"]\");\n    }\n"
+        << "    return WILDCARD_PATHS[wildcard_path_id];\n}\n\n";
+    out << "bool " << scope << "has_match(std::string_view input) const\n{\n"
+        << "    return find_wildcard_match(input) != NO_MATCH;\n}\n\n";
+    out << "std::string " << scope << "get_wildcard_match(std::string_view input) const\n{\n"
+        << "    size_t match_id = find_wildcard_match(input);\n"
+        << "    return match_id != NO_MATCH ? std::string(WILDCARD_PATHS[match_id]) : std::string();\n}\n\n";
+    out << "std::optional<size_t> " << scope << "get_wildcard_match_id(std::string_view input) const\n{\n"
+        << "    size_t match_id = find_wildcard_match(input);\n"
+        << "    return match_id != NO_MATCH ? std::optional<size_t>(match_id) : std::nullopt;\n}\n\n";
+    out << "std::optional<std::string_view> " << scope
+        << "get_wildcard_match_view(std::string_view input) const\n{\n"
+        << "    size_t match_id = find_wildcard_match(input);\n"
+        << "    return match_id != NO_MATCH ? std::optional<std::string_view>(WILDCARD_PATHS[match_id]) : "
+           "std::nullopt;\n}\n";
+    write_namespace(out, namespace_name, false);
+}
+} // namespace octo::wildcardmatching
@@ -0,0 +1,254 @@
+/**
+ * @file wildcard-path-loader.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-loader.hpp"
+#include "tracepoints.hpp"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+static constexpr char COMMENT_CHAR = '#';
+static constexpr char WHITESPACE_CHARS[] = " \t\r\n";
+// Up to this many added or removed wildcard paths are patched into a copy of the current matcher, more are loaded
+// into a new one. Every edit of the copy shifts the indexes, so it is linear in the amount of wildcard paths like a
+// build is, and the break even is a fixed amount of edits whatever the size of the file
+static constexpr size_t MAX_PATCHED_WILDCARD_PATHS = 64;
+} // namespace
+
+namespace octo::wildcardmatching
+{
+WildcardPathLoader::WildcardPathLoader(std::string file_path,
+                                       bool allow_last_wildcard_as_many_paths,
+                                       std::shared_ptr<WildcardPathPool> pool)
+    : file_path_(std::move(file_path)), pool_(std::move(pool))
+{
+    allow_last_wildcard_as_many_paths_ = allow_last_wildcard_as_many_paths;
+    matcher_ = std::make_shared<const WildcardPathMatcher>(allow_last_wildcard_as_many_paths_, pool_);
+    has_file_stamp_ = false;
+    file_modification_time_ = 0;
+    file_size_ = 0;
+}
+
+WildcardPathLoader::~WildcardPathLoader()
+{
+}
+
+std::vector<std::string> WildcardPathLoader::read_wildcard_paths_file(
+    const WildcardPathMatcher& validating_matcher) const
+{
+    std::ifstream file(file_path_);
+    if (!file.is_open())
+    {
+        throw std::runtime_error(std::string("Failed to open the wildcard paths file: [") + file_path_ + "]");
+    }
+
+    std::vector<std::string> wildcard_paths;
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number++;
+        size_t line_begin = line.find_first_not_of(WHITESPACE_CHARS);
+        if (line_begin == std::string::npos || line[line_begin] == COMMENT_CHAR)
+        {
+            continue;
+        }
+        size_t line_end = line.find_last_not_of(WHITESPACE_CHARS) + 1;
+        std::string wildcard_path = line.substr(line_begin, line_end - line_begin);
+        if (!validating_matcher.validate_wildcard_path(wildcard_path))
+        {
+            throw std::runtime_error(std::string("The path is invalid at line ") + std::to_string(line_number) +
+                                     ": [" + wildcard_path + "]");
+        }
+        wildcard_paths.push_back(std::move(wildcard_path));
+    }
+    if (file.bad())
+    {
+        throw std::runtime_error(std::string("Failed to read the wildcard paths file: [") + file_path_ + "]");
+    }
+
+    return wildcard_paths;
+}
+
+bool WildcardPathLoader::read_file_stamp(int64_t& modification_time, int64_t& size) const
+{
+    struct stat file_stat;
+    if (stat(file_path_.c_str(), &file_stat) != 0)
+    {
+        return false;
+    }
+#ifdef __linux__
+    modification_time = int64_t(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec;
+#else
+    modification_time = int64_t(file_stat.st_mtime);
+#endif
+    size = int64_t(file_stat.st_size);
+    return true;
+}
+
+WildcardPathLoader::ReloadResult WildcardPathLoader::reload()
+{
+    std::shared_ptr<const WildcardPathMatcher> current_matcher = get_matcher();
+    std::vector<std::string> wildcard_paths = read_wildcard_paths_file(*current_matcher);
+
+    // Diff against the current version, as multisets since a wildcard path may appear more than once
+    // The first occurrences of a wildcard path in both versions are taken as the kept ones
+    const size_t current_count = current_matcher->get_wildcard_paths_count();
+    ReloadResult result;
+    result.added = 0;
+    result.unchanged = 0;
+    result.patched = false;
+    std::unordered_map<std::string_view, size_t> current_wildcard_paths;
+    for (size_t wildcard_path_id = 0; wildcard_path_id < current_count; wildcard_path_id++)
+    {
+        current_wildcard_paths[current_matcher->get_wildcard_path(wildcard_path_id)]++;
+    }
+    std::unordered_map<std::string_view, size_t> new_wildcard_paths;
+    std::vector<bool> is_added_wildcard_path(wildcard_paths.size(), false);
+    for (size_t i = 0; i < wildcard_paths.size(); i++)
+    {
+        new_wildcard_paths[wildcard_paths[i]]++;
+        std::unordered_map<std::string_view, size_t>::iterator current_iter =
+            current_wildcard_paths.find(wildcard_paths[i]);
+        if (current_iter != current_wildcard_paths.end() && current_iter->second > 0)
+        {
+            current_iter->second--;
+            result.unchanged++;
+        }
+        else
+        {
+            is_added_wildcard_path[i] = true;
+            result.added++;
+        }
+    }
+    result.removed = current_count - result.unchanged;
+    std::vector<bool> is_removed_wildcard_path(current_count, false);
+    for (size_t wildcard_path_id = 0; wildcard_path_id < current_count; wildcard_path_id++)
+    {
+        std::unordered_map<std::string_view, size_t>::iterator new_iter =
+            new_wildcard_paths.find(current_matcher->get_wildcard_path(wildcard_path_id));
+        if (new_iter != new_wildcard_paths.end() && new_iter->second > 0)
+        {
+            new_iter->second--;
+        }
+        else
+        {
+            is_removed_wildcard_path[wildcard_path_id] = true;
+        }
+    }
+
+    // The order decides which wildcard path matches first, so a reordered file is a change as well
+    bool is_reordered = false;
+    size_t current_id = 0;
+    for (size_t i = 0; !is_reordered && i < wildcard_paths.size(); i++)
+    {
+        if (is_added_wildcard_path[i])
+        {
+            continue;
+        }
+        while (is_removed_wildcard_path[current_id])
+        {
+            current_id++;
+        }
+        is_reordered = current_matcher->get_wildcard_path(current_id++) != wildcard_paths[i];
+    }
+    result.changed = result.added > 0 || result.removed > 0 || is_reordered;
+    if (!result.changed)
+    {
+        return result;
+    }
+
+    std::shared_ptr<WildcardPathMatcher> new_matcher;
+    result.patched = !is_reordered && std::max(result.added, result.removed) <= MAX_PATCHED_WILDCARD_PATHS;
+    if (result.patched)
+    {
+        // Copy on write, the current matcher keeps serving the lookups while the copy is patched
+        // Both versions are walked together, a removed wildcard path with an added one in its place is replaced
+        new_matcher = std::make_shared<WildcardPathMatcher>(*current_matcher);
+        size_t wildcard_path_id = 0;
+        size_t i = 0;
+        current_id = 0;
+        while (i < wildcard_paths.size() || current_id < current_count)
+        {
+            const bool is_removed = current_id < current_count && is_removed_wildcard_path[current_id];
+            const bool is_added = i < wildcard_paths.size() && is_added_wildcard_path[i];
+            if (is_removed && is_added)
+            {
+                new_matcher->replace_wildcard_path(wildcard_path_id++, wildcard_paths[i++]);
+                current_id++;
+            }
+            else if (is_removed)
+            {
+                new_matcher->remove_wildcard_path(wildcard_path_id);
+                current_id++;
+            }
+            else if (is_added)
+            {
+                new_matcher->insert_wildcard_path(wildcard_path_id++, wildcard_paths[i++]);
+            }
+            else
+            {
+                wildcard_path_id++;
+                current_id++;
+                i++;
+            }
+        }
+    }
+    else
+    {
+        // With a pool, the unchanged wildcard paths are still held by the current matcher, so it hands out their
+        // compiled form
+        new_matcher = std::make_shared<WildcardPathMatcher>(allow_last_wildcard_as_many_paths_, pool_);
+        new_matcher->add_wildcard_paths(std::move(wildcard_paths));
+        new_matcher->shrink_to_fit();
+    }
+    OCTO_WILDCARD_TRACE(publish, new_matcher->get_wildcard_paths_count(), result.added, result.removed);
+    std::atomic_store(&matcher_, std::shared_ptr<const WildcardPathMatcher>(std::move(new_matcher)));
+
+    return result;
+}
+
+bool WildcardPathLoader::poll()
+{
+    int64_t modification_time;
+    int64_t size;
+    if (!read_file_stamp(modification_time, size))
+    {
+        return false;
+    }
+    if (has_file_stamp_ && modification_time == file_modification_time_ && size == file_size_)
+    {
+        return false;
+    }
+
+    // Keep the stamp even if the reload fails, so a broken file is not reloaded again until it changes
+    has_file_stamp_ = true;
+    file_modification_time_ = modification_time;
+    file_size_ = size;
+    return reload().changed;
+}
+
+std::shared_ptr<const WildcardPathMatcher> WildcardPathLoader::get_matcher() const
+{
+    return std::atomic_load(&matcher_);
+}
+
+const std::string& WildcardPathLoader::get_file_path() const
+{
+    return file_path_;
+}
+} // namespace octo::wildcardmatching
@@ -0,0 +1,255 @@
+/**
+ * @file wildcard-path-matcher-set.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher-set.hpp"
+
+namespace
+{
+/**
+ * @brief
+ * Per thread scratch memory for the match ids of the merged matcher, so the views lookup does not allocate
+ */
+std::vector<std::optional<size_t>>& get_thread_match_ids_scratch()
+{
+    thread_local std::vector<std::optional<size_t>> match_ids;
+    return match_ids;
+}
+} // namespace
+
+namespace octo::wildcardmatching
+{
+WildcardPathMatcherSet::WildcardPathMatcherSet(bool allow_last_wildcard_as_many_paths,
+                                               std::shared_ptr<WildcardPathPool> pool)
+    : matcher_(allow_last_wildcard_as_many_paths, std::move(pool))
+{
+}
+
+WildcardPathMatcherSet::~WildcardPathMatcherSet()
+{
+}
+
+size_t WildcardPathMatcherSet::get_list_begin(size_t list_index) const
+{
+    return list_index == 0 ? 0 : list_ends_[list_index - 1];
+}
+
+bool WildcardPathMatcherSet::get_allow_last_wildcard_as_many_paths() const
+{
+    return matcher_.get_allow_last_wildcard_as_many_paths();
+}
+
+char WildcardPathMatcherSet::get_folder_seperator() const
+{
+    return matcher_.get_folder_seperator();
+}
+
+void WildcardPathMatcherSet::set_folder_seperator(char folder_seperator)
+{
+    matcher_.set_folder_seperator(folder_seperator);
+}
+
+const std::string& WildcardPathMatcherSet::get_input_folder_seperators() const
+{
+    return matcher_.get_input_folder_seperators();
+}
+
+void WildcardPathMatcherSet::set_input_folder_seperators(std::string_view input_folder_seperators)
+{
+    matcher_.set_input_folder_seperators(input_folder_seperators);
+}
+
+bool WildcardPathMatcherSet::get_normalize_input_paths() const
+{
+    return matcher_.get_normalize_input_paths();
+}
+
+void WildcardPathMatcherSet::set_normalize_input_paths(bool normalize_input_paths)
+{
+    matcher_.set_normalize_input_paths(normalize_input_paths);
+}
+
+size_t WildcardPathMatcherSet::get_match_step_budget() const
+{
+    return matcher_.get_match_step_budget();
+}
+
+void WildcardPathMatcherSet::set_match_step_budget(size_t match_step_budget)
+{
+    matcher_.set_match_step_budget(match_step_budget);
+}
+
+PathView WildcardPathMatcherSet::create_path_view(std::string_view input) const
+{
+    return matcher_.create_path_view(input);
+}
+
+size_t WildcardPathMatcherSet::add_wildcard_paths(const std::string& list_name,
+                                                  const std::vector<std::string>& wildcard_paths)
+{
+    std::optional<size_t> list_index = get_list_index(list_name);
+    if (!list_index)
+    {
+        // A new list is appended after all the others
+        matcher_.add_wildcard_paths(wildcard_paths);
+        list_names_.push_back(list_name);
+        list_ends_.push_back(matcher_.get_wildcard_paths_count());
+        return list_names_.size() - 1;
+    }
+    if (*list_index + 1 == list_names_.size())
+    {
+        matcher_.add_wildcard_paths(wildcard_paths);
+        list_ends_.back() = matcher_.get_wildcard_paths_count();
+        return *list_index;
+    }
+
+    // The ids of a list must stay consecutive, so the wildcard paths are inserted at the end of the list
+    // and the merged matcher is built again, once they are all known to be valid
+    for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end(); ++iter)
+    {
+        if (!matcher_.validate_wildcard_path(*iter))
+        {
+            throw std::runtime_error(std::string("A path is invalid: [") + *iter + "]");
+        }
+    }
+    std::vector<std::string> merged_wildcard_paths = matcher_.get_wildcard_paths();
+    merged_wildcard_paths.insert(merged_wildcard_paths.begin() + list_ends_[*list_index],
+                                 wildcard_paths.begin(),
+                                 wildcard_paths.end());
+    matcher_.clean_wildcard_paths();
+    matcher_.add_wildcard_paths(std::move(merged_wildcard_paths));
+    for (size_t i = *list_index; i < list_ends_.size(); i++)
+    {
+        list_ends_[i] += wildcard_paths.size();
+    }
+
+    return *list_index;
+}
+
+void WildcardPathMatcherSet::clean_wildcard_paths()
+{
+    matcher_.clean_wildcard_paths();
+    list_names_.clear();
+    list_ends_.clear();
+}
+
+size_t WildcardPathMatcherSet::get_lists_count() const
+{
+    return list_names_.size();
+}
+
+const std::string& WildcardPathMatcherSet::get_list_name(size_t list_index) const
+{
+    return list_names_.at(list_index);
+}
+
+std::optional<size_t> WildcardPathMatcherSet::get_list_index(std::string_view list_name) const
+{
+    for (size_t list_index = 0; list_index < list_names_.size(); list_index++)
+    {
+        if (list_names_[list_index] == list_name)
+        {
+            return list_index;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<std::string> WildcardPathMatcherSet::get_wildcard_paths(size_t list_index) const
+{
+    std::vector<std::string> wildcard_paths;
+    for (size_t wildcard_path_id = get_list_begin(list_index); wildcard_path_id < list_ends_.at(list_index);
+         wildcard_path_id++)
+    {
+        wildcard_paths.emplace_back(matcher_.get_wildcard_path(wildcard_path_id));
+    }
+
+    return wildcard_paths;
+}
+
+std::string_view WildcardPathMatcherSet::get_wildcard_path(size_t list_index, size_t wildcard_path_id) const
+{
+    const size_t list_begin = get_list_begin(list_index);
+    if (wildcard_path_id >= list_ends_.at(list_index) - list_begin)
+    {
+        throw std::runtime_error(std::string("The wildcard path id is invalid: [") + std::to_string(wildcard_path_id) +
+                                 "]");
+    }
+
+    return matcher_.get_wildcard_path(list_begin + wildcard_path_id);
+}
+
+void WildcardPathMatcherSet::to_list_match_ids(std::vector<std::optional<size_t>>& match_ids) const
+{
+    for (size_t list_index = 1; list_index < match_ids.size(); list_index++)
+    {
+        if (match_ids[list_index])
+        {
+            *match_ids[list_index] -= list_ends_[list_index - 1];
+        }
+    }
+}
+
+void WildcardPathMatcherSet::to_match_views(const std::vector<std::optional<size_t>>& match_ids,
+                                            std::vector<std::optional<std::string_view>>& match_views) const
+{
+    match_views.assign(match_ids.size(), std::nullopt);
+    for (size_t list_index = 0; list_index < match_ids.size(); list_index++)
+    {
+        if (match_ids[list_index])
+        {
+            match_views[list_index] = matcher_.get_wildcard_path(*match_ids[list_index]);
+        }
+    }
+}
+
+WildcardPathMatcher::MatchStatus
+WildcardPathMatcherSet::get_wildcard_match_ids(std::string_view input,
+                                               std::vector<std::optional<size_t>>& match_ids) const
+{
+    WildcardPathMatcher::MatchStatus match_status =
+        matcher_.get_wildcard_match_ids_by_group(input, list_ends_, match_ids);
+    to_list_match_ids(match_ids);
+    return match_status;
+}
+
+WildcardPathMatcher::MatchStatus
+WildcardPathMatcherSet::get_wildcard_match_ids(const PathView& path_view,
+                                               std::vector<std::optional<size_t>>& match_ids) const
+{
+    WildcardPathMatcher::MatchStatus match_status =
+        matcher_.get_wildcard_match_ids_by_group(path_view, list_ends_, match_ids);
+    to_list_match_ids(match_ids);
+    return match_status;
+}
+
+WildcardPathMatcher::MatchStatus
+WildcardPathMatcherSet::get_wildcard_match_views(std::string_view input,
+                                                 std::vector<std::optional<std::string_view>>& match_views) const
+{
+    std::vector<std::optional<size_t>>& match_ids = get_thread_match_ids_scratch();
+    WildcardPathMatcher::MatchStatus match_status =
+        matcher_.get_wildcard_match_ids_by_group(input, list_ends_, match_ids);
+    to_match_views(match_ids, match_views);
+    return match_status;
+}
+
+WildcardPathMatcher::MatchStatus
+WildcardPathMatcherSet::get_wildcard_match_views(const PathView& path_view,
+                                                 std::vector<std::optional<std::string_view>>& match_views) const
+{
+    std::vector<std::optional<size_t>>& match_ids = get_thread_match_ids_scratch();
+    WildcardPathMatcher::MatchStatus match_status =
+        matcher_.get_wildcard_match_ids_by_group(path_view, list_ends_, match_ids);
+    to_match_views(match_ids, match_views);
+    return match_status;
+}
+} // namespace octo::wildcardmatching
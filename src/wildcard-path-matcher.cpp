@@ -10,30 +10,425 @@
  */
 
 #include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include "tracepoints.hpp"
 #include <string.h>
+#include <cstdint>
+#include <unordered_map>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <cmath>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace
 {
 static constexpr char UNIX_FOLDER_SEPERATOR_CHAR = '/';
 static constexpr char WINDOWS_FOLDER_SEPERATOR_CHAR = '\\';
 static constexpr char SINGLE_WILDCARD_CHAR = '*';
-static constexpr char SINGLE_WILDCARD_STRING[] = "*";
 static constexpr char DOUBLE_WILDCARD_STRING[] = "**";
-} // namespace
+// Literals shorter than this occur in too many inputs to be worth indexing by, unless nothing longer exists
+static constexpr size_t MIN_SELECTIVE_LITERAL_SIZE = 3;
+// Single adds are compared without the index until they are this many, or a quarter of the indexed ones
+static constexpr size_t MIN_UNINDEXED_WILDCARD_PATHS = 64;
+// Smaller chunks are not worth a thread of their own when adding in parallel
+static constexpr size_t MIN_PARALLEL_CHUNK_SIZE = 4096;
+// A literal block is searched with KMP, which compares every input part at most twice amortized
+static constexpr size_t LITERAL_BLOCK_STEPS_PER_PART = 2;
+// Fewer scanned wildcard paths are cheaper to compare one by one than to filter by their leading segments
+static constexpr size_t MIN_SEGMENT_FILTERED_WILDCARD_PATHS = 64;
+// Leading segments deeper than this rarely filter out more of the scanned wildcard paths
+static constexpr size_t MAX_LEADING_SEGMENT_DEPTH = 4;
 
-namespace octo::wildcardmatching
+// Cost model of the lookup engines in nanoseconds, measured with the benchmarks on x86-64
+// A wildcard path compared on every lookup, which its pre filter usually rejects
+static constexpr double SCANNED_WILDCARD_PATH_NS = 4;
+// A candidate found by an index, which usually passes the pre filter and has its segments compared
+static constexpr double CANDIDATE_WILDCARD_PATH_NS = 40;
+// Scan of a typical 64 characters input by the required literals automaton, and gathering its posting lists
+static constexpr double LITERAL_SCAN_NS = 220;
+// Binary search of a part hash, a fixed cost and a cost per halving of the hashes
+static constexpr double PART_INDEX_NS = 10;
+static constexpr double PART_INDEX_STEP_NS = 2;
+
+/**
+ * @brief
+ * The engines a wildcard path can be found by, anything not found by one of them is scanned on every lookup
+ */
+enum PlannedEngine : uint8_t
+{
+    FIRST_PART_ENGINE = 0,
+    LAST_PART_ENGINE,
+    LITERAL_ENGINE,
+    ENGINES_COUNT,
+    SCAN_ENGINE = ENGINES_COUNT
+};
+static constexpr uint32_t NO_KEY = UINT32_MAX;
+
+/**
+ * @brief
+ * The keys a single engine can find the wildcard paths by, a dense key id per wildcard path and the amount of
+ * wildcard paths that have every key
+ */
+struct EngineKeys
+{
+    std::vector<uint32_t> wildcard_path_key_ids;
+    std::vector<uint32_t> key_frequencies;
+    // Keys that occur in almost every input, like the short literals
+    std::vector<bool> is_common_key;
+};
+
+/**
+ * @brief
+ * Assigns every wildcard path to the enabled engine whose key it shares with the fewest other wildcard paths,
+ * or to the scan if none of them applies, and returns the estimated cost of a lookup
+ * An input is assumed to hit a key as often as the wildcard paths have it, so the expected candidates of a key are
+ * its postings times its frequency over the amount of wildcard paths
+ */
+double plan_engines(const EngineKeys (&engine_keys)[ENGINES_COUNT],
+                    unsigned enabled_engines,
+                    size_t wildcard_paths_count,
+                    std::vector<uint8_t>& wildcard_path_engines)
+{
+    std::vector<uint32_t> posting_counts[ENGINES_COUNT];
+    for (unsigned engine = 0; engine < ENGINES_COUNT; engine++)
+    {
+        if (enabled_engines & (1u << engine))
+        {
+            posting_counts[engine].assign(engine_keys[engine].key_frequencies.size(), 0);
+        }
+    }
+
+    size_t scanned_wildcard_paths = 0;
+    wildcard_path_engines.resize(wildcard_paths_count);
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
+    {
+        uint8_t best_engine = SCAN_ENGINE;
+        uint32_t best_frequency = UINT32_MAX;
+        for (unsigned engine = 0; engine < ENGINES_COUNT; engine++)
+        {
+            const uint32_t key_id = engine_keys[engine].wildcard_path_key_ids[wildcard_path_id];
+            if ((enabled_engines & (1u << engine)) && key_id != NO_KEY &&
+                engine_keys[engine].key_frequencies[key_id] < best_frequency)
+            {
+                best_engine = engine;
+                best_frequency = engine_keys[engine].key_frequencies[key_id];
+            }
+        }
+        wildcard_path_engines[wildcard_path_id] = best_engine;
+        if (best_engine == SCAN_ENGINE)
+        {
+            scanned_wildcard_paths++;
+        }
+        else
+        {
+            posting_counts[best_engine][engine_keys[best_engine].wildcard_path_key_ids[wildcard_path_id]]++;
+        }
+    }
+
+    double cost = scanned_wildcard_paths * SCANNED_WILDCARD_PATH_NS;
+    for (unsigned engine = 0; engine < ENGINES_COUNT; engine++)
+    {
+        size_t used_keys = 0;
+        double expected_candidates = 0;
+        for (size_t key_id = 0; key_id < posting_counts[engine].size(); key_id++)
+        {
+            if (posting_counts[engine][key_id] == 0)
+            {
+                continue;
+            }
+            used_keys++;
+            expected_candidates +=
+                posting_counts[engine][key_id] *
+                (engine_keys[engine].is_common_key[key_id]
+                     ? 1.0
+                     : double(engine_keys[engine].key_frequencies[key_id]) / wildcard_paths_count);
+        }
+        if (used_keys == 0)
+        {
+            continue;
+        }
+        cost += expected_candidates * CANDIDATE_WILDCARD_PATH_NS;
+        cost += engine == LITERAL_ENGINE ? LITERAL_SCAN_NS : PART_INDEX_NS + PART_INDEX_STEP_NS * std::log2(used_keys);
+    }
+
+    return cost;
+}
+
+/**
+ * @brief
+ * Gives dense key ids to the part hashes of the wildcard paths, the pairs of hash and id are sorted on the way
+ */
+void make_part_engine_keys(std::vector<std::pair<uint64_t, uint32_t>>& part_hashes,
+                           size_t wildcard_paths_count,
+                           EngineKeys& engine_keys)
+{
+    std::sort(part_hashes.begin(), part_hashes.end());
+    engine_keys.wildcard_path_key_ids.assign(wildcard_paths_count, NO_KEY);
+    for (size_t i = 0; i < part_hashes.size(); i++)
+    {
+        if (i == 0 || part_hashes[i].first != part_hashes[i - 1].first)
+        {
+            engine_keys.key_frequencies.push_back(0);
+        }
+        engine_keys.key_frequencies.back()++;
+        engine_keys.wildcard_path_key_ids[part_hashes[i].second] = engine_keys.key_frequencies.size() - 1;
+    }
+    engine_keys.is_common_key.assign(engine_keys.key_frequencies.size(), false);
+}
+
+/**
+ * @brief
+ * Keeps the sorted pairs of hash and id of the wildcard paths planned to a part engine, split into two arrays
+ */
+void build_part_index(const std::vector<std::pair<uint64_t, uint32_t>>& sorted_part_hashes,
+                      const std::vector<uint8_t>& wildcard_path_engines,
+                      uint8_t engine,
+                      std::vector<uint64_t>& part_hashes,
+                      std::vector<uint32_t>& wildcard_path_ids)
+{
+    part_hashes.clear();
+    wildcard_path_ids.clear();
+    for (std::vector<std::pair<uint64_t, uint32_t>>::const_iterator part_hash_iter = sorted_part_hashes.begin();
+         part_hash_iter != sorted_part_hashes.end();
+         ++part_hash_iter)
+    {
+        if (wildcard_path_engines[part_hash_iter->second] == engine)
+        {
+            part_hashes.push_back(part_hash_iter->first);
+            wildcard_path_ids.push_back(part_hash_iter->second);
+        }
+    }
+}
+
+/**
+ * @brief
+ * How far the leading segments of a wildcard path, the ones before any double wildcard, matched an input
+ * Either they matched the first depth parts, or they matched the parts before depth and failed at part depth
+ */
+struct LeadingState
+{
+    // Serial of the input the state was saved for, 0 if never
+    uint64_t input_serial;
+    uint32_t depth;
+    bool failed;
+};
+
+/**
+ * @brief
+ * Per thread scratch memory for the lookups
+ * The vectors keep their capacity between lookups, so a steady workload does not allocate
+ */
+struct MatchScratch
+{
+    octo::wildcardmatching::PathView path_view;
+    std::vector<uint64_t> infix_states;
+    std::vector<uint32_t> literal_ids;
+    std::vector<uint32_t> candidate_ids;
+    // Most specific lookups, the ranked candidates keyed by their rank above their slot, and the unranked ones
+    std::vector<uint64_t> ranked_candidates;
+    std::vector<uint32_t> unranked_candidates;
+    // Batches, the current and previous inputs, the serial of the input since which every leading run of parts is
+    // unchanged, and the leading state of every wildcard path
+    // Serials only grow, so the states saved by an earlier batch or another matcher are never taken as current
+    octo::wildcardmatching::PathView batch_path_views[2];
+    std::vector<uint64_t> stable_part_serials;
+    std::vector<LeadingState> leading_states;
+    uint64_t input_serial = 0;
+    // Group lookups, the slots the groups end at when wildcard paths were removed
+    std::vector<size_t> group_end_slots;
+    // Distinct leading segments that match the input part at every depth, matched once the lookup needs them
+    std::vector<uint64_t> leading_segment_masks[MAX_LEADING_SEGMENT_DEPTH];
+};
+
+MatchScratch& get_thread_match_scratch()
+{
+    thread_local MatchScratch scratch;
+    return scratch;
+}
+
+uint64_t get_char_signature_bit(char c)
+{
+    return uint64_t(1) << ((unsigned char)c & 63);
+}
+
+/**
+ * @brief
+ * Get the hash of the literal first segment of a wildcard path, which is always compared to the first input part
+ *
+ * @param wildcard_path
+ * @param first_part_hash
+ * @return true if the first segment is literal
+ * @return false
+ */
+bool get_first_part_hash(const octo::wildcardmatching::CompiledWildcardPath& wildcard_path, uint64_t& first_part_hash)
+{
+    if (wildcard_path.segments_count == 0 || wildcard_path.segments[0].is_double_wildcard ||
+        wildcard_path.segments[0].card_count != 1)
+    {
+        return false;
+    }
+    first_part_hash =
+        octo::wildcardmatching::PathView::hash_part(wildcard_path.get_segment_string(wildcard_path.segments[0]));
+    return true;
+}
+
+/**
+ * @brief
+ * Packs the specificity of a wildcard path so that a higher value is more specific
+ * Ranked by the amount of literal segments, then the amount of literal characters, then the fewer double wildcards
+ */
+uint64_t compute_wildcard_path_specificity(const octo::wildcardmatching::CompiledWildcardPath& wildcard_path)
+{
+    uint64_t literal_segments = 0;
+    uint64_t literal_chars = 0;
+    uint64_t double_wildcards = 0;
+    for (size_t i = 0; i < wildcard_path.segments_count; i++)
+    {
+        const octo::wildcardmatching::CompiledWildcardPath::Segment& segment = wildcard_path.segments[i];
+        if (segment.is_double_wildcard)
+        {
+            double_wildcards++;
+            continue;
+        }
+        if (segment.card_count == 1)
+        {
+            literal_segments++;
+        }
+        for (uint32_t card = segment.first_card; card < segment.first_card + segment.card_count; card++)
+        {
+            literal_chars += wildcard_path.cards[card].size;
+        }
+    }
+
+    literal_segments = std::min<uint64_t>(literal_segments, 0xFFFF);
+    literal_chars = std::min<uint64_t>(literal_chars, 0xFFFFFFFF);
+    double_wildcards = std::min<uint64_t>(double_wildcards, 0xFFFF);
+    return (literal_segments << 48) | (literal_chars << 16) | (0xFFFF - double_wildcards);
+}
+
+/**
+ * @brief
+ * Runs the task for every chunk index on its own thread, the first chunk on the calling thread
+ * An exception thrown by any of the chunks is rethrown once all of them are done
+ */
+void run_chunks_in_parallel(size_t chunks_count, const std::function<void(size_t)>& task)
+{
+    std::vector<std::exception_ptr> errors(chunks_count);
+    std::vector<std::thread> threads;
+    threads.reserve(chunks_count - 1);
+    for (size_t chunk = 1; chunk < chunks_count; chunk++)
+    {
+        threads.emplace_back([&task, &errors, chunk]() {
+            try
+            {
+                task(chunk);
+            }
+            catch (...)
+            {
+                errors[chunk] = std::current_exception();
+            }
+        });
+    }
+    try
+    {
+        task(0);
+    }
+    catch (...)
+    {
+        errors[0] = std::current_exception();
+    }
+    for (std::vector<std::thread>::iterator thread_iter = threads.begin(); thread_iter != threads.end(); ++thread_iter)
+    {
+        thread_iter->join();
+    }
+    for (std::vector<std::exception_ptr>::const_iterator error_iter = errors.begin(); error_iter != errors.end();
+         ++error_iter)
+    {
+        if (*error_iter)
+        {
+            std::rethrow_exception(*error_iter);
+        }
+    }
+}
+
+int count_trailing_zeros(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (int)index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+int count_set_bits(uint32_t value)
+{
+#ifdef _MSC_VER
+    return (int)__popcnt(value);
+#else
+    return __builtin_popcount(value);
+#endif
+}
+
+octo::wildcardmatching::WildcardPathMatcher::WildcardCapture get_parts_capture(
+    std::string_view input, const std::vector<std::string_view>& input_path_parts, int parts_begin, int parts_end)
 {
+    // Span from the start of the first part to the end of the last one, or empty where the next part would start
+    octo::wildcardmatching::WildcardPathMatcher::WildcardCapture parts_capture;
+    if (parts_begin < (int)input_path_parts.size())
+    {
+        parts_capture.offset = input_path_parts[parts_begin].data() - input.data();
+    }
+    else
+    {
+        parts_capture.offset =
+            input_path_parts.empty() ? 0 : input_path_parts.back().data() + input_path_parts.back().size() - input.data();
+    }
+    parts_capture.size = 0;
+    if (parts_begin < parts_end)
+    {
+        const std::string_view& last_part = input_path_parts[parts_end - 1];
+        parts_capture.size = last_part.data() + last_part.size() - input.data() - parts_capture.offset;
+    }
+    return parts_capture;
+}
 
-WildcardPathMatcher::Wildcard::Wildcard(size_t begin, size_t end)
+size_t get_compiled_wildcard_path_bytes(const octo::wildcardmatching::CompiledWildcardPath& compiled_path)
 {
-    offset = begin;
-    size = end - begin;
+    // The cards of all the segments follow each other, the last segment ends them
+    size_t cards_count = 0;
+    if (compiled_path.segments_count > 0)
+    {
+        const octo::wildcardmatching::CompiledWildcardPath::Segment& last_segment =
+            compiled_path.segments[compiled_path.segments_count - 1];
+        cards_count = last_segment.first_card + last_segment.card_count;
+    }
+    return compiled_path.path.size() +
+           compiled_path.segments_count * sizeof(octo::wildcardmatching::CompiledWildcardPath::Segment) +
+           cards_count * sizeof(octo::wildcardmatching::CompiledWildcardPath::Wildcard);
 }
+} // namespace
+
+namespace octo::wildcardmatching
+{
 
-WildcardPathMatcher::WildcardPathMatcher(bool allow_last_wildcard_as_many_paths)
+WildcardPathMatcher::WildcardPathMatcher(bool allow_last_wildcard_as_many_paths,
+                                         std::shared_ptr<WildcardPathPool> pool)
+    : pool_(std::move(pool))
 {
+    indexed_wildcard_paths_count_ = 0;
+    match_plan_ = MatchPlan{0, 0, 0, 0, 0, 0};
+    stale_wildcard_paths_count_ = 0;
+    normalize_input_paths_ = false;
     allow_last_wildcard_as_many_paths_ = allow_last_wildcard_as_many_paths;
+    match_step_budget_ = 0;
+    match_on_budget_exceeded_ = false;
+    max_wildcard_path_cost_ = 0;
     evaluate_os_folder_seperator();
+    update_input_folder_seperators_table();
 }
 
 WildcardPathMatcher::~WildcardPathMatcher()
@@ -49,473 +444,2597 @@ void WildcardPathMatcher::evaluate_os_folder_seperator()
 #endif
 }
 
-std::vector<std::string> WildcardPathMatcher::split_string_by_delimiter(const std::string& input,
-                                                                          char delimiter) const
+void WildcardPathMatcher::update_input_folder_seperators_table()
 {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::istringstream token_stream(input);
-    while (std::getline(token_stream, token, delimiter))
+    input_folder_seperators_table_.reset();
+    input_folder_seperators_table_.set((unsigned char)folder_seperator_);
+    for (std::string::const_iterator seperator_iter = input_folder_seperators_.begin();
+         seperator_iter != input_folder_seperators_.end();
+         ++seperator_iter)
     {
-        // If this is an empty string, move on, case of lots of /// in the same path part
-        if (token == "")
-        {
-            continue;
-        }
+        input_folder_seperators_table_.set((unsigned char)*seperator_iter);
+    }
+}
 
-        tokens.push_back(token);
+const PathView& WildcardPathMatcher::get_matching_path_view(const PathView& path_view) const
+{
+    if (path_view.is_split_like(folder_seperator_, input_folder_seperators_table_, normalize_input_paths_))
+    {
+        return path_view;
     }
 
-    return tokens;
+    // Split like this matcher on the scratch path view, which is always split like the matcher it was last used by
+    PathView& scratch_path_view = get_thread_match_scratch().path_view;
+    scratch_path_view.assign(
+        path_view.get_input(), folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return scratch_path_view;
 }
 
-std::vector<WildcardPathMatcher::Wildcard> WildcardPathMatcher::split_by_wildcards(
-    const std::string& wildcard_str) const
+void WildcardPathMatcher::compile_wildcard_path(std::string_view wildcard_path)
 {
-    // Split the wildcard string by * and keep offset and size
-    size_t pos = wildcard_str.find('*');
-    std::vector<Wildcard> wildcards;
-    if (pos == std::string::npos)
+    if (pool_)
     {
-        // If no * is found, its a normal string and this means we only have one wildcard part
-        wildcards.push_back(Wildcard(0, wildcard_str.size()));
+        pooled_wildcard_paths_.push_back(pool_->intern(wildcard_path, folder_seperator_));
     }
     else
     {
-        // Add the prefix wildcard part
-        wildcards.push_back(Wildcard(0, pos));
-        ++pos;
-        // Start collecting all the infix wildcard parts
-        for (;;)
+        storage_.add_wildcard_path(wildcard_path, folder_seperator_);
+    }
+    wildcard_path_filters_.push_back(
+        compute_wildcard_path_filter(get_compiled_wildcard_path(get_wildcard_path_slots_count() - 1)));
+    insert_wildcard_path_slot_by_hash(get_wildcard_path_slots_count() - 1);
+}
+
+void WildcardPathMatcher::recompile_wildcard_paths()
+{
+    std::vector<std::string> wildcard_paths = get_wildcard_paths();
+    clean_wildcard_paths();
+    for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end(); ++iter)
+    {
+        compile_wildcard_path(*iter);
+    }
+    rebuild_match_plan();
+}
+
+WildcardPathMatcher::WildcardPathFilter
+WildcardPathMatcher::compute_wildcard_path_filter(const CompiledWildcardPath& wildcard_path) const
+{
+    WildcardPathFilter filter;
+    filter.min_parts = 0;
+    filter.max_parts = 0;
+    filter.min_chars = 0;
+    filter.last_part_size = UINT32_MAX;
+    filter.last_part_hash = 0;
+    filter.required_chars = 0;
+    filter.specificity = compute_wildcard_path_specificity(wildcard_path);
+    filter.specificity_rank = UINT32_MAX;
+    const WildcardPathCost cost = compute_wildcard_path_cost(wildcard_path);
+    filter.fixed_steps = (uint32_t)std::min<size_t>(cost.fixed_steps, UINT32_MAX);
+    filter.steps_per_part = (uint32_t)std::min<size_t>(cost.steps_per_part, UINT32_MAX);
+
+    for (size_t i = 0; i < wildcard_path.segments_count; i++)
+    {
+        const CompiledWildcardPath::Segment& segment = wildcard_path.segments[i];
+        const bool is_last_segment = (i + 1) == wildcard_path.segments_count;
+        // Double wildcards can take any amount of input parts
+        if (segment.is_double_wildcard)
         {
-            size_t pos2 = wildcard_str.find('*', pos);
-            if (pos2 == std::string::npos)
-            {
-                break;
-            }
-            if (pos2 != pos)
+            filter.max_parts = UINT32_MAX;
+            continue;
+        }
+        // A last segment ending with a wildcard can take many input parts when allowed
+        if (should_allow_last_wildcard_as_many_paths(wildcard_path, i))
+        {
+            filter.max_parts = UINT32_MAX;
+        }
+        else if (filter.max_parts != UINT32_MAX)
+        {
+            filter.max_parts++;
+        }
+        if (!is_required_wildcard_segment(wildcard_path, i))
+        {
+            continue;
+        }
+
+        filter.min_parts++;
+        for (uint32_t card = segment.first_card; card < segment.first_card + segment.card_count; card++)
+        {
+            std::string_view card_str = wildcard_path.path.substr(wildcard_path.cards[card].offset,
+                                                                  wildcard_path.cards[card].size);
+            filter.min_chars += card_str.size();
+            for (std::string_view::const_iterator char_iter = card_str.begin(); char_iter != card_str.end();
+                 ++char_iter)
             {
-                wildcards.push_back(Wildcard(pos, pos2));
+                filter.required_chars |= get_char_signature_bit(*char_iter);
             }
-            pos = pos2 + 1;
         }
-        // Add the postfix wildcard part
-        wildcards.push_back(Wildcard(pos, wildcard_str.size()));
+        // A literal last segment is always compared to the whole last input part
+        if (is_last_segment && segment.card_count == 1)
+        {
+            filter.last_part_size = segment.size;
+            filter.last_part_hash = PathView::hash_part(wildcard_path.get_segment_string(segment));
+        }
     }
 
-    return wildcards;
+    return filter;
 }
 
-bool WildcardPathMatcher::compare_validated_wildcard_strings(const std::string& wildcard_str,
-                                                               const std::string& input_str) const
+WildcardPathMatcher::WildcardPathCost
+WildcardPathMatcher::compute_wildcard_path_cost(const CompiledWildcardPath& wildcard_path) const
 {
-    // Need to look for each wildcard segment only once within the string part
-    // Start by creating the wildcard parts and keep their size and index
-    std::vector<Wildcard> wildcards = split_by_wildcards(wildcard_str);
+    // Every segment is compared at least once, the ones after a ** are searched for along the input, block by block,
+    // as is a last segment that takes many paths
+    WildcardPathCost cost = {0, 0};
+    size_t block_begin = 0;
+    size_t block_steps = 0;
+    bool is_searched_block = false;
+    for (size_t i = 0; i <= wildcard_path.segments_count; i++)
+    {
+        if (i == wildcard_path.segments_count || wildcard_path.segments[i].is_double_wildcard)
+        {
+            if (is_searched_block && block_steps > 0)
+            {
+                cost.steps_per_part +=
+                    wildcard_path.segments[block_begin].in_literal_block ? LITERAL_BLOCK_STEPS_PER_PART : block_steps;
+            }
+            block_begin = i + 1;
+            block_steps = 0;
+            is_searched_block = true;
+            continue;
+        }
+        const size_t segment_steps = wildcard_path.segments[i].card_count;
+        cost.fixed_steps += segment_steps;
+        block_steps += segment_steps;
+        if (!is_searched_block && should_allow_last_wildcard_as_many_paths(wildcard_path, i))
+        {
+            cost.steps_per_part += segment_steps;
+        }
+    }
 
-    // Start iterating over the string
-    const char* begin = input_str.c_str();
-    const char* end = begin + input_str.size();
+    return cost;
+}
 
-    // Check prefix card
-    const Wildcard& prefix_card = wildcards.front();
-    // Assert size
-    if (size_t(end - begin) < prefix_card.size)
+bool WildcardPathMatcher::is_required_wildcard_segment(const CompiledWildcardPath& wildcard_path,
+                                                       size_t wildcard_path_part_index) const
+{
+    const CompiledWildcardPath::Segment& segment = wildcard_path.segments[wildcard_path_part_index];
+    if (segment.is_double_wildcard)
     {
         return false;
     }
-    std::string::const_iterator card_begin = wildcard_str.begin() + prefix_card.offset;
-    // Assert that the prefix card is equal
-    if (!std::equal(begin, begin + prefix_card.size, card_begin))
+    // A last segment starting with a wildcard can be left without an input part when allowed
+    if ((wildcard_path_part_index + 1) == wildcard_path.segments_count && segment.starts_with_wildcard &&
+        allow_last_wildcard_as_many_paths_)
     {
         return false;
     }
-    // Move the pointer
-    begin += prefix_card.size;
+    return true;
+}
 
-    // Check if we only have one wildcard (probably means no *)
-    if (wildcards.size() == 1)
+void WildcardPathMatcher::rebuild_match_plan()
+{
+    release_stale_wildcard_paths();
+    // Any wildcard paths added since are not in the slots by hash
+    wildcard_path_slots_by_hash_.clear();
+    const size_t wildcard_paths_count = get_wildcard_path_slots_count();
+
+    // Give every distinct required literal a dense id, and count in how many wildcard paths it appears
+    // The cards of the required segments must all appear in any matching input
+    std::unordered_map<std::string_view, uint32_t> literal_ids;
+    std::vector<std::string_view> literals;
+    std::vector<uint32_t> literal_frequencies;
+    std::vector<uint32_t> card_literal_ids;
+    std::vector<uint32_t> wildcard_path_first_cards(wildcard_paths_count + 1);
+    literal_ids.reserve(wildcard_paths_count);
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
     {
-        return begin == end;
+        wildcard_path_first_cards[wildcard_path_id] = card_literal_ids.size();
+        CompiledWildcardPath wildcard_path = get_compiled_wildcard_path(wildcard_path_id);
+        for (size_t i = 0; i < wildcard_path.segments_count; i++)
+        {
+            if (!is_required_wildcard_segment(wildcard_path, i))
+            {
+                continue;
+            }
+            const CompiledWildcardPath::Segment& segment = wildcard_path.segments[i];
+            for (uint32_t card = segment.first_card; card < segment.first_card + segment.card_count; card++)
+            {
+                if (wildcard_path.cards[card].size == 0)
+                {
+                    continue;
+                }
+                std::pair<std::unordered_map<std::string_view, uint32_t>::iterator, bool> literal_iter =
+                    literal_ids.emplace(
+                        wildcard_path.path.substr(wildcard_path.cards[card].offset, wildcard_path.cards[card].size),
+                        literals.size());
+                if (literal_iter.second)
+                {
+                    literals.push_back(literal_iter.first->first);
+                    literal_frequencies.push_back(0);
+                }
+                literal_frequencies[literal_iter.first->second]++;
+                card_literal_ids.push_back(literal_iter.first->second);
+            }
+        }
     }
+    wildcard_path_first_cards[wildcard_paths_count] = card_literal_ids.size();
 
-    // Check suffix card
-    const Wildcard& suffix_card = wildcards.back();
-    // Assert size
-    if (size_t(end - begin) < suffix_card.size)
+    // Pick the rarest selective literal of every wildcard path, preferring the longer one on a tie
+    EngineKeys engine_keys[ENGINES_COUNT];
+    EngineKeys& literal_keys = engine_keys[LITERAL_ENGINE];
+    literal_keys.wildcard_path_key_ids.assign(wildcard_paths_count, NO_KEY);
+    literal_keys.key_frequencies = literal_frequencies;
+    literal_keys.is_common_key.resize(literals.size());
+    for (uint32_t literal_id = 0; literal_id < literals.size(); literal_id++)
     {
-        return false;
+        literal_keys.is_common_key[literal_id] = literals[literal_id].size() < MIN_SELECTIVE_LITERAL_SIZE;
     }
-    card_begin = wildcard_str.begin() + suffix_card.offset;
-    // Assert that the prefix card is equal
-    if (!std::equal(end - suffix_card.size, end, card_begin))
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
     {
-        return false;
+        uint32_t best_literal_id = NO_KEY;
+        for (uint32_t card = wildcard_path_first_cards[wildcard_path_id];
+             card < wildcard_path_first_cards[wildcard_path_id + 1];
+             card++)
+        {
+            const uint32_t literal_id = card_literal_ids[card];
+            if (best_literal_id == NO_KEY)
+            {
+                best_literal_id = literal_id;
+                continue;
+            }
+            const std::string_view literal = literals[literal_id];
+            const std::string_view best_literal = literals[best_literal_id];
+            const bool is_selective = literal.size() >= MIN_SELECTIVE_LITERAL_SIZE;
+            const bool is_best_selective = best_literal.size() >= MIN_SELECTIVE_LITERAL_SIZE;
+            if ((is_selective && !is_best_selective) ||
+                (is_selective == is_best_selective &&
+                 (literal_frequencies[literal_id] < literal_frequencies[best_literal_id] ||
+                  (literal_frequencies[literal_id] == literal_frequencies[best_literal_id] &&
+                   literal.size() > best_literal.size()))))
+            {
+                best_literal_id = literal_id;
+            }
+        }
+        literal_keys.wildcard_path_key_ids[wildcard_path_id] = best_literal_id;
     }
-    // Move the pointer
-    end -= suffix_card.size;
 
-    // Check infix cards
-    for (size_t i = 1; i != wildcards.size() - 1; ++i)
+    // The literal first and last segments, which are always compared to the first and last input parts
+    std::vector<std::pair<uint64_t, uint32_t>> first_part_hashes;
+    std::vector<std::pair<uint64_t, uint32_t>> last_part_hashes;
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
     {
-        const Wildcard& infix_card = wildcards[i];
-        std::string::const_iterator card_begin = wildcard_str.begin() + infix_card.offset;
-        std::string::const_iterator card_end = card_begin + infix_card.size;
-        // Assert that we can find one within the card infix
-        begin = std::search(begin, end, card_begin, card_end);
-        if (begin == end)
+        uint64_t first_part_hash;
+        if (get_first_part_hash(get_compiled_wildcard_path(wildcard_path_id), first_part_hash))
         {
-            return false;
+            first_part_hashes.emplace_back(first_part_hash, wildcard_path_id);
+        }
+        if (wildcard_path_filters_[wildcard_path_id].last_part_size != UINT32_MAX)
+        {
+            last_part_hashes.emplace_back(wildcard_path_filters_[wildcard_path_id].last_part_hash, wildcard_path_id);
         }
-        // Move the pointer
-        begin += infix_card.size;
     }
+    make_part_engine_keys(first_part_hashes, wildcard_paths_count, engine_keys[FIRST_PART_ENGINE]);
+    make_part_engine_keys(last_part_hashes, wildcard_paths_count, engine_keys[LAST_PART_ENGINE]);
 
-    return true;
+    // Estimate every combination of the engines and keep the cheapest, the one with fewer engines on a tie
+    std::vector<uint8_t> wildcard_path_engines;
+    unsigned best_engines = 0;
+    double best_cost = plan_engines(engine_keys, 0, wildcard_paths_count, wildcard_path_engines);
+    for (unsigned engines = 1; engines < (1u << ENGINES_COUNT); engines++)
+    {
+        const double cost = plan_engines(engine_keys, engines, wildcard_paths_count, wildcard_path_engines);
+        if (cost < best_cost || (cost == best_cost && count_set_bits(engines) < count_set_bits(best_engines)))
+        {
+            best_engines = engines;
+            best_cost = cost;
+        }
+    }
+    plan_engines(engine_keys, best_engines, wildcard_paths_count, wildcard_path_engines);
+    match_plan_ = MatchPlan{0, 0, 0, 0, 0, best_cost};
+
+    // Keep only the picked literals of the wildcard paths planned to the automaton, and lay their posting lists out
+    // in one counting sort pass
+    // Every list comes out sorted by wildcard path id, since the wildcard paths are visited in order
+    std::vector<uint32_t> literal_postings_counts(literals.size(), 0);
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
+    {
+        if (wildcard_path_engines[wildcard_path_id] == LITERAL_ENGINE)
+        {
+            literal_postings_counts[literal_keys.wildcard_path_key_ids[wildcard_path_id]]++;
+        }
+    }
+    std::vector<std::string_view> indexed_literals;
+    std::vector<uint32_t> indexed_literal_ids(literals.size(), NO_KEY);
+    required_literal_postings_offsets_.clear();
+    required_literal_postings_offsets_.push_back(0);
+    for (uint32_t literal_id = 0; literal_id < literals.size(); literal_id++)
+    {
+        if (literal_postings_counts[literal_id] > 0)
+        {
+            indexed_literal_ids[literal_id] = indexed_literals.size();
+            indexed_literals.push_back(literals[literal_id]);
+            required_literal_postings_offsets_.push_back(required_literal_postings_offsets_.back() +
+                                                         literal_postings_counts[literal_id]);
+        }
+    }
+    required_literal_postings_.resize(required_literal_postings_offsets_.back());
+    std::vector<uint32_t> postings_ends(required_literal_postings_offsets_.begin(),
+                                        required_literal_postings_offsets_.end() - 1);
+    scanned_wildcard_path_ids_.clear();
+    for (size_t wildcard_path_id = 0; wildcard_path_id < wildcard_paths_count; wildcard_path_id++)
+    {
+        switch (wildcard_path_engines[wildcard_path_id])
+        {
+        case LITERAL_ENGINE:
+            required_literal_postings_[postings_ends[indexed_literal_ids[literal_keys.wildcard_path_key_ids
+                                                                             [wildcard_path_id]]]++] =
+                wildcard_path_id;
+            match_plan_.literal_indexed_wildcard_paths++;
+            break;
+        case FIRST_PART_ENGINE:
+            match_plan_.first_part_indexed_wildcard_paths++;
+            break;
+        case LAST_PART_ENGINE:
+            match_plan_.last_part_indexed_wildcard_paths++;
+            break;
+        default:
+            scanned_wildcard_path_ids_.push_back(wildcard_path_id);
+            match_plan_.scanned_wildcard_paths++;
+            break;
+        }
+    }
+    required_literals_.build(indexed_literals);
+
+    // The part indexes keep the hashes sorted, with the ids ascending within the same hash
+    build_part_index(first_part_hashes,
+                     wildcard_path_engines,
+                     FIRST_PART_ENGINE,
+                     first_part_index_.part_hashes,
+                     first_part_index_.wildcard_path_ids);
+    build_part_index(last_part_hashes,
+                     wildcard_path_engines,
+                     LAST_PART_ENGINE,
+                     last_part_index_.part_hashes,
+                     last_part_index_.wildcard_path_ids);
+    indexed_wildcard_paths_count_ = wildcard_paths_count;
+    build_leading_segment_matchers();
+    rank_wildcard_paths_by_specificity();
+    OCTO_WILDCARD_TRACE(plan,
+                        best_engines,
+                        match_plan_.scanned_wildcard_paths,
+                        match_plan_.first_part_indexed_wildcard_paths,
+                        match_plan_.last_part_indexed_wildcard_paths,
+                        match_plan_.literal_indexed_wildcard_paths);
+}
+
+void WildcardPathMatcher::build_leading_segment_matchers()
+{
+    leading_segment_matchers_.clear();
+    if (scanned_wildcard_path_ids_.size() < MIN_SEGMENT_FILTERED_WILDCARD_PATHS)
+    {
+        return;
+    }
+
+    std::vector<size_t> leading_segments_counts(scanned_wildcard_path_ids_.size(), 0);
+    for (size_t scanned_index = 0; scanned_index < scanned_wildcard_path_ids_.size(); scanned_index++)
+    {
+        leading_segments_counts[scanned_index] =
+            get_leading_segments_count(get_compiled_wildcard_path(scanned_wildcard_path_ids_[scanned_index]));
+    }
+
+    // Wildcard paths without a leading segment at some depth get an empty one, which matches any part
+    std::vector<std::string_view> leading_segments(scanned_wildcard_path_ids_.size());
+    for (size_t depth = 0; depth < MAX_LEADING_SEGMENT_DEPTH; depth++)
+    {
+        bool has_leading_segments = false;
+        for (size_t scanned_index = 0; scanned_index < scanned_wildcard_path_ids_.size(); scanned_index++)
+        {
+            leading_segments[scanned_index] = std::string_view();
+            if (depth < leading_segments_counts[scanned_index])
+            {
+                CompiledWildcardPath wildcard_path =
+                    get_compiled_wildcard_path(scanned_wildcard_path_ids_[scanned_index]);
+                leading_segments[scanned_index] = wildcard_path.get_segment_string(wildcard_path.segments[depth]);
+                has_leading_segments = true;
+            }
+        }
+        if (!has_leading_segments)
+        {
+            break;
+        }
+        leading_segment_matchers_.emplace_back();
+        leading_segment_matchers_.back().build(leading_segments);
+    }
+}
+
+size_t WildcardPathMatcher::get_leading_segments_count(const CompiledWildcardPath& wildcard_path) const
+{
+    size_t leading_segments_count = 0;
+    while (leading_segments_count < wildcard_path.segments_count &&
+           !wildcard_path.segments[leading_segments_count].is_double_wildcard &&
+           !should_allow_last_wildcard_as_many_paths(wildcard_path, leading_segments_count))
+    {
+        leading_segments_count++;
+    }
+    return leading_segments_count;
+}
+
+void WildcardPathMatcher::recompute_wildcard_path_filters()
+{
+    wildcard_path_filters_.clear();
+    for (size_t wildcard_path_id = 0; wildcard_path_id < get_wildcard_path_slots_count(); wildcard_path_id++)
+    {
+        wildcard_path_filters_.push_back(compute_wildcard_path_filter(get_compiled_wildcard_path(wildcard_path_id)));
+    }
+    for (std::vector<uint32_t>::const_iterator removed_iter = removed_wildcard_path_slots_.begin();
+         removed_iter != removed_wildcard_path_slots_.end();
+         ++removed_iter)
+    {
+        disable_wildcard_path_filter(*removed_iter);
+    }
+}
+
+CompiledWildcardPath WildcardPathMatcher::get_compiled_wildcard_path(size_t wildcard_path_id) const
+{
+    if (pool_)
+    {
+        return *pooled_wildcard_paths_[wildcard_path_id];
+    }
+
+    return storage_.get_wildcard_path(wildcard_path_id);
+}
+
+bool WildcardPathMatcher::compare_validated_wildcard_strings(const CompiledWildcardPath& wildcard_path,
+                                                               const CompiledWildcardPath::Segment& wildcard_segment,
+                                                               std::string_view input_str) const
+{
+    // Need to look for each wildcard segment only once within the string part
+    // The wildcard parts were created when the wildcard path was compiled, with their size and index
+    const CompiledWildcardPath::Wildcard* wildcards = wildcard_path.cards + wildcard_segment.first_card;
+    const size_t wildcards_count = wildcard_segment.card_count;
+    const char* wildcard_str = wildcard_path.path.data();
+
+    // Start iterating over the string
+    const char* begin = input_str.data();
+    const char* end = begin + input_str.size();
+
+    // Check prefix card
+    const CompiledWildcardPath::Wildcard& prefix_card = wildcards[0];
+    // Assert size
+    if (size_t(end - begin) < prefix_card.size)
+    {
+        return false;
+    }
+    const char* card_begin = wildcard_str + prefix_card.offset;
+    // Assert that the prefix card is equal
+    if (!std::equal(begin, begin + prefix_card.size, card_begin))
+    {
+        return false;
+    }
+    // Move the pointer
+    begin += prefix_card.size;
+
+    // Check if we only have one wildcard (probably means no *)
+    if (wildcards_count == 1)
+    {
+        return begin == end;
+    }
+
+    // Check suffix card
+    const CompiledWildcardPath::Wildcard& suffix_card = wildcards[wildcards_count - 1];
+    // Assert size
+    if (size_t(end - begin) < suffix_card.size)
+    {
+        return false;
+    }
+    card_begin = wildcard_str + suffix_card.offset;
+    // Assert that the prefix card is equal
+    if (!std::equal(end - suffix_card.size, end, card_begin))
+    {
+        return false;
+    }
+    // Move the pointer
+    end -= suffix_card.size;
+
+    // Check infix cards
+    for (size_t i = 1; i != wildcards_count - 1; ++i)
+    {
+        const CompiledWildcardPath::Wildcard& infix_card = wildcards[i];
+        const char* card_begin = wildcard_str + infix_card.offset;
+        const char* card_end = card_begin + infix_card.size;
+        // Assert that we can find one within the card infix
+        begin = std::search(begin, end, card_begin, card_end);
+        if (begin == end)
+        {
+            return false;
+        }
+        // Move the pointer
+        begin += infix_card.size;
+    }
+
+    return true;
+}
+
+bool WildcardPathMatcher::compare_validated_wildcard_paths(const std::vector<std::string_view>& input_path_parts,
+                                                             const CompiledWildcardPath& wildcard_path,
+                                                             int wildcard_path_part_index,
+                                                             int input_path_part_index) const
+{
+    // The wildcard path was already split when it was compiled
+    const CompiledWildcardPath::Segment* wildcard_path_parts = wildcard_path.segments;
+    const int wildcard_path_parts_count = (int)wildcard_path.segments_count;
+
+    // Start going over the wildcard path parts and validate them against the input path
+
+    while (input_path_part_index < (int)input_path_parts.size() &&
+           wildcard_path_part_index < wildcard_path_parts_count)
+    {
+        // This only happens either we have a double wildcard for many paths
+        // Or we have a single wildcard on the last path part as a standalone and it is allowed
+        if (wildcard_path_parts[wildcard_path_part_index].is_double_wildcard ||
+            should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_path_part_index))
+        {
+            // Check double wildcard comparison
+            // If return true, this means we need to finish the loop
+            if (handle_double_wildcard_part_comparison(
+                    wildcard_path, input_path_parts, wildcard_path_part_index, input_path_part_index))
+            {
+                break;
+            }
+        }
+        else
+        {
+            // Check normal wildcard comparison
+            // If return true, this means we need to finish the loop
+            if (handle_normal_part_comparison(
+                    wildcard_path, input_path_parts, wildcard_path_part_index, input_path_part_index))
+            {
+                break;
+            }
+        }
+    }
+
+    // Make the final decision whether we found a match or not
+    return decide_if_match_is_found(wildcard_path, input_path_parts, wildcard_path_part_index, input_path_part_index);
+}
+
+int WildcardPathMatcher::find_validated_wildcard_infix(const CompiledWildcardPath& wildcard_path,
+                                                       int wildcard_infix_begin,
+                                                       int wildcard_infix_size,
+                                                       const std::vector<std::string_view>& input_path_parts,
+                                                       int input_path_part_index) const
+{
+    const CompiledWildcardPath::Segment* infix_parts = wildcard_path.segments + wildcard_infix_begin;
+
+    if (infix_parts[0].in_literal_block)
+    {
+        // KMP over the segments, every input part is compared an amortized constant amount of times
+        int matched = 0;
+        for (int current_path_part_index = input_path_part_index;
+             current_path_part_index < (int)input_path_parts.size();
+             current_path_part_index++)
+        {
+            std::string_view input_part = input_path_parts[current_path_part_index];
+            while (matched > 0 && input_part != wildcard_path.get_segment_string(infix_parts[matched]))
+            {
+                matched = infix_parts[matched - 1].block_failure;
+            }
+            if (input_part == wildcard_path.get_segment_string(infix_parts[matched]))
+            {
+                matched++;
+            }
+            if (matched == wildcard_infix_size)
+            {
+                return current_path_part_index + 1;
+            }
+        }
+        return -1;
+    }
+
+    // Wildcard segments do not have a usable border table, so keep the bit set of infix prefixes that
+    // end at the current input part instead, each input part is visited once and only the live
+    // prefixes are extended with a comparison
+    std::vector<uint64_t>& states = get_thread_match_scratch().infix_states;
+    const size_t states_words = (wildcard_infix_size + 63) / 64;
+    const size_t last_word = (wildcard_infix_size - 1) / 64;
+    const uint64_t last_bit = uint64_t(1) << ((wildcard_infix_size - 1) % 64);
+    states.assign(states_words * 2, 0);
+    uint64_t* current_states = states.data();
+    uint64_t* next_states = states.data() + states_words;
+
+    for (int current_path_part_index = input_path_part_index; current_path_part_index < (int)input_path_parts.size();
+         current_path_part_index++)
+    {
+        // The candidates are the live prefixes extended by one, plus a new occurrence starting here
+        uint64_t carry = 1;
+        for (size_t word = 0; word < states_words; word++)
+        {
+            uint64_t candidates = (current_states[word] << 1) | carry;
+            carry = current_states[word] >> 63;
+            next_states[word] = 0;
+            while (candidates)
+            {
+                int bit = count_trailing_zeros(candidates);
+                candidates &= candidates - 1;
+                int infix_index = (int)(word * 64) + bit;
+                if (infix_index < wildcard_infix_size &&
+                    compare_validated_wildcard_strings(
+                        wildcard_path, infix_parts[infix_index], input_path_parts[current_path_part_index]))
+                {
+                    next_states[word] |= uint64_t(1) << bit;
+                }
+            }
+        }
+        if (next_states[last_word] & last_bit)
+        {
+            return current_path_part_index + 1;
+        }
+        std::swap(current_states, next_states);
+    }
+
+    return -1;
+}
+
+bool WildcardPathMatcher::handle_double_wildcard_part_comparison(const CompiledWildcardPath& wildcard_path,
+                                                                   const std::vector<std::string_view>& input_path_parts,
+                                                                   int& wildcard_path_part_index,
+                                                                   int& input_path_part_index) const
+{
+    const CompiledWildcardPath::Segment* wildcard_path_parts = wildcard_path.segments;
+    const int wildcard_path_parts_count = (int)wildcard_path.segments_count;
+
+    // Loop until we find the last ** in a row, just to avoid double searching
+    while (wildcard_path_part_index < wildcard_path_parts_count &&
+           wildcard_path_parts[wildcard_path_part_index].is_double_wildcard)
+    {
+        wildcard_path_part_index++;
+    }
+
+    // If this is the last part, this means we found a match since it ends with only **
+    if (wildcard_path_part_index == wildcard_path_parts_count)
+    {
+        // Move the index to the end since it fits everything and finish here
+        input_path_part_index = input_path_parts.size();
+        return true;
+    }
+
+    // Start collecting all the wildcard parts until the next **
+    // This will be the infix parts we will check, kept as a range over the compiled segments
+    const int wildcard_infix_begin = wildcard_path_part_index;
+    while (wildcard_path_part_index < wildcard_path_parts_count &&
+           !wildcard_path_parts[wildcard_path_part_index].is_double_wildcard)
+    {
+        wildcard_path_part_index++;
+    }
+    const int wildcard_infix_size = wildcard_path_part_index - wildcard_infix_begin;
+
+    // Check if we can find all those parts within the input somewhere
+    // If we found it somewhere, that means that the infix is good for us
+    // We can move to the found index on the input and continue from there
+    int current_path_part_index = find_validated_wildcard_infix(
+        wildcard_path, wildcard_infix_begin, wildcard_infix_size, input_path_parts, input_path_part_index);
+    // We found the infix
+    if (current_path_part_index != -1)
+    {
+        input_path_part_index = current_path_part_index;
+    }
+    // We did not find the infix, we can stop here
+    // We also move the wildcard index back since we did not find
+    else
+    {
+        wildcard_path_part_index -= wildcard_infix_size;
+        return true;
+    }
+    // If this is the last part, this means we might have found a match
+    // Check the last parts to validate it
+    // Either we have ** or * and allowed in the end
+    if (wildcard_path_part_index == wildcard_path_parts_count &&
+        (wildcard_path_parts[wildcard_path_part_index - 1].is_double_wildcard ||
+         should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_path_part_index - 1)))
+    {
+        // Move the index to the end since it fits everything and finish here
+        input_path_part_index = input_path_parts.size();
+        return true;
+    }
+    // Or the last part can be compared to all the suffix exactly
+    // In the infix part, we only search somewhere in the parts for a match
+    // Here we must assert that the last part, the suffix is equal completely
+    else if (wildcard_path_part_index == wildcard_path_parts_count)
+    {
+        // Collect last suffix, as a range over the compiled segments
+        int wildcard_postfix_begin = wildcard_path_parts_count;
+        while (wildcard_postfix_begin > 0 && !wildcard_path_parts[wildcard_postfix_begin - 1].is_double_wildcard)
+        {
+            wildcard_postfix_begin--;
+        }
+        const int wildcard_postfix_size = wildcard_path_parts_count - wildcard_postfix_begin;
+        int wildcard_path_postfix_index = 0;
+        int input_path_postfix_index = input_path_parts.size() - wildcard_postfix_size;
+        // Check if the last part fits the remainder of the input
+        while (input_path_postfix_index < (int)input_path_parts.size() &&
+               wildcard_path_postfix_index < wildcard_postfix_size)
+        {
+            const CompiledWildcardPath::Segment& postfix_part =
+                wildcard_path_parts[wildcard_postfix_begin + wildcard_path_postfix_index];
+            if (compare_validated_wildcard_strings(
+                    wildcard_path, postfix_part, input_path_parts[input_path_postfix_index]))
+            {
+                input_path_postfix_index++;
+                wildcard_path_postfix_index++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        // If we reached the end on both we are good
+        if (input_path_postfix_index == (int)input_path_parts.size() &&
+            wildcard_path_postfix_index == wildcard_postfix_size)
+        {
+            input_path_part_index = input_path_parts.size();
+        }
+    }
+
+    return false;
+}
+
+bool WildcardPathMatcher::handle_normal_part_comparison(const CompiledWildcardPath& wildcard_path,
+                                                          const std::vector<std::string_view>& input_path_parts,
+                                                          int& wildcard_path_part_index,
+                                                          int& input_path_part_index) const
+{
+    if (!compare_validated_wildcard_strings(wildcard_path,
+                                            wildcard_path.segments[wildcard_path_part_index],
+                                            input_path_parts[input_path_part_index]))
+    {
+        // We did not find a match, this means we can stop here and continue to the next wildcard path
+        return true;
+    }
+    else
+    {
+        // Promote both the indices since we found a match within the single wildcard
+        input_path_part_index++;
+        wildcard_path_part_index++;
+    }
+
+    return false;
+}
+
+bool WildcardPathMatcher::decide_if_match_is_found(const CompiledWildcardPath& wildcard_path,
+                                                     const std::vector<std::string_view>& input_path_parts,
+                                                     int& wildcard_path_part_index,
+                                                     int& input_path_part_index) const
+{
+    const CompiledWildcardPath::Segment* wildcard_path_parts = wildcard_path.segments;
+    const int wildcard_path_parts_count = (int)wildcard_path.segments_count;
+
+    // Make sure to handle finishing ** if we reached the end of the input
+    while (wildcard_path_part_index < wildcard_path_parts_count &&
+           wildcard_path_parts[wildcard_path_part_index].is_double_wildcard)
+    {
+        wildcard_path_part_index++;
+    }
+
+    // If we reached the end of the input and wildcard, this means we properly found a match
+    if ((wildcard_path_part_index == wildcard_path_parts_count &&
+         input_path_part_index == (int)input_path_parts.size()) ||
+        (input_path_part_index == (int)input_path_parts.size() &&
+         wildcard_path_part_index == wildcard_path_parts_count - 1 &&
+         wildcard_path_parts[wildcard_path_part_index].starts_with_wildcard && allow_last_wildcard_as_many_paths_))
+    {
+        return true;
+    }
+    return false;
+}
+
+bool WildcardPathMatcher::should_allow_last_wildcard_as_many_paths(const CompiledWildcardPath& wildcard_path,
+                                                                     size_t wildcard_path_part_index) const
+{
+    return allow_last_wildcard_as_many_paths_ && wildcard_path.segments[wildcard_path_part_index].ends_with_wildcard &&
+           (wildcard_path_part_index + 1) == wildcard_path.segments_count;
+}
+
+void WildcardPathMatcher::add_capture(CaptureBuffer& capture_buffer, size_t offset, size_t size)
+{
+    if (capture_buffer.count < capture_buffer.capacity)
+    {
+        capture_buffer.captures[capture_buffer.count].offset = offset;
+        capture_buffer.captures[capture_buffer.count].size = size;
+    }
+    capture_buffer.count++;
+}
+
+void WildcardPathMatcher::capture_segment_wildcards(const CompiledWildcardPath& wildcard_path,
+                                                    const CompiledWildcardPath::Segment& wildcard_segment,
+                                                    std::string_view input,
+                                                    std::string_view input_part,
+                                                    size_t capture_end,
+                                                    CaptureBuffer& capture_buffer) const
+{
+    const CompiledWildcardPath::Wildcard* wildcards = wildcard_path.cards + wildcard_segment.first_card;
+    const size_t wildcards_count = wildcard_segment.card_count;
+    const char* wildcard_str = wildcard_path.path.data();
+
+    // A single card means there is no * in the segment
+    if (wildcards_count < 2)
+    {
+        return;
+    }
+
+    // The part is known to match, so every card is found where compare_validated_wildcard_strings found it
+    const char* begin = input_part.data() + wildcards[0].size;
+    const char* end = input_part.data() + input_part.size() - wildcards[wildcards_count - 1].size;
+    for (size_t i = 1; i != wildcards_count - 1; ++i)
+    {
+        const CompiledWildcardPath::Wildcard& infix_card = wildcards[i];
+        const char* card_begin = wildcard_str + infix_card.offset;
+        const char* infix_begin = std::search(begin, end, card_begin, card_begin + infix_card.size);
+        add_capture(capture_buffer, begin - input.data(), infix_begin - begin);
+        begin = infix_begin + infix_card.size;
+    }
+
+    // The last * runs until the suffix card, or until the capture end if it took more parts
+    const size_t last_capture_begin = begin - input.data();
+    const size_t last_capture_end = capture_end > size_t(end - input.data()) ? capture_end : end - input.data();
+    add_capture(capture_buffer, last_capture_begin, last_capture_end - last_capture_begin);
+}
+
+void WildcardPathMatcher::capture_wildcard_path(std::string_view input,
+                                                const std::vector<std::string_view>& input_path_parts,
+                                                const CompiledWildcardPath& wildcard_path,
+                                                CaptureBuffer& capture_buffer) const
+{
+    const CompiledWildcardPath::Segment* wildcard_path_parts = wildcard_path.segments;
+    const int wildcard_path_parts_count = (int)wildcard_path.segments_count;
+    const int input_path_parts_count = (int)input_path_parts.size();
+    int wildcard_path_part_index = 0;
+    int input_path_part_index = 0;
+    // Empty capture at the end of the last input part
+    const WildcardCapture end_capture =
+        get_parts_capture(input, input_path_parts, input_path_parts_count, input_path_parts_count);
+
+    while (input_path_part_index < input_path_parts_count && wildcard_path_part_index < wildcard_path_parts_count)
+    {
+        const CompiledWildcardPath::Segment& wildcard_path_part = wildcard_path_parts[wildcard_path_part_index];
+        if (!wildcard_path_part.is_double_wildcard &&
+            !should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_path_part_index))
+        {
+            capture_segment_wildcards(
+                wildcard_path, wildcard_path_part, input, input_path_parts[input_path_part_index], 0, capture_buffer);
+            wildcard_path_part_index++;
+            input_path_part_index++;
+            continue;
+        }
+
+        // Same steps as handle_double_wildcard_part_comparison, ** in a row are searched as one
+        const int double_wildcards_begin = wildcard_path_part_index;
+        while (wildcard_path_part_index < wildcard_path_parts_count &&
+               wildcard_path_parts[wildcard_path_part_index].is_double_wildcard)
+        {
+            wildcard_path_part_index++;
+        }
+        int double_wildcards_end = input_path_parts_count;
+        const int wildcard_infix_begin = wildcard_path_part_index;
+        int wildcard_infix_size = 0;
+        int wildcard_infix_end = input_path_parts_count;
+        if (wildcard_path_part_index < wildcard_path_parts_count)
+        {
+            while (wildcard_path_part_index < wildcard_path_parts_count &&
+                   !wildcard_path_parts[wildcard_path_part_index].is_double_wildcard)
+            {
+                wildcard_path_part_index++;
+            }
+            wildcard_infix_size = wildcard_path_part_index - wildcard_infix_begin;
+            // The last infix is compared to the last parts of the input, unless its last * takes many paths
+            if (wildcard_path_part_index < wildcard_path_parts_count ||
+                should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_path_part_index - 1))
+            {
+                wildcard_infix_end = find_validated_wildcard_infix(
+                    wildcard_path, wildcard_infix_begin, wildcard_infix_size, input_path_parts, input_path_part_index);
+            }
+            double_wildcards_end = wildcard_infix_end - wildcard_infix_size;
+        }
+
+        // The first ** takes all the parts before the infix, the ones after it in the same row take nothing
+        WildcardCapture parts_capture =
+            get_parts_capture(input, input_path_parts, input_path_part_index, double_wildcards_end);
+        for (int double_wildcard_index = double_wildcards_begin; double_wildcard_index < wildcard_infix_begin;
+             double_wildcard_index++)
+        {
+            add_capture(capture_buffer, parts_capture.offset, parts_capture.size);
+            parts_capture.offset += parts_capture.size;
+            parts_capture.size = 0;
+        }
+        for (int infix_index = 0; infix_index < wildcard_infix_size; infix_index++)
+        {
+            const int input_part_index = double_wildcards_end + infix_index;
+            // A last * that takes many paths also takes all the parts after its own
+            const size_t capture_end =
+                should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_infix_begin + infix_index)
+                    ? end_capture.offset
+                    : 0;
+            capture_segment_wildcards(wildcard_path,
+                                      wildcard_path_parts[wildcard_infix_begin + infix_index],
+                                      input,
+                                      input_path_parts[input_part_index],
+                                      capture_end,
+                                      capture_buffer);
+        }
+        input_path_part_index = wildcard_path_part_index == wildcard_path_parts_count ? input_path_parts_count
+                                                                                      : wildcard_infix_end;
+    }
+
+    // The wildcards left once the input ran out take nothing, ** or a last segment that takes many paths
+    for (; wildcard_path_part_index < wildcard_path_parts_count; wildcard_path_part_index++)
+    {
+        const CompiledWildcardPath::Segment& wildcard_path_part = wildcard_path_parts[wildcard_path_part_index];
+        const size_t wildcards_count = wildcard_path_part.is_double_wildcard ? 1 : wildcard_path_part.card_count - 1;
+        for (size_t i = 0; i < wildcards_count; i++)
+        {
+            add_capture(capture_buffer, end_capture.offset, 0);
+        }
+    }
+}
+
+bool WildcardPathMatcher::get_allow_last_wildcard_as_many_paths() const
+{
+    return allow_last_wildcard_as_many_paths_;
+}
+
+void WildcardPathMatcher::set_allow_last_wildcard_as_many_paths(bool allow_last_wildcard_as_many_paths)
+{
+    allow_last_wildcard_as_many_paths_ = allow_last_wildcard_as_many_paths;
+    recompute_wildcard_path_filters();
+    rebuild_match_plan();
+}
+
+char WildcardPathMatcher::get_folder_seperator() const
+{
+    return folder_seperator_;
+}
+
+void WildcardPathMatcher::set_folder_seperator(char folder_seperator)
+{
+    folder_seperator_ = folder_seperator;
+    update_input_folder_seperators_table();
+    recompile_wildcard_paths();
+}
+
+const std::string& WildcardPathMatcher::get_input_folder_seperators() const
+{
+    return input_folder_seperators_;
+}
+
+void WildcardPathMatcher::set_input_folder_seperators(std::string_view input_folder_seperators)
+{
+    input_folder_seperators_ = input_folder_seperators;
+    update_input_folder_seperators_table();
+}
+
+bool WildcardPathMatcher::get_normalize_input_paths() const
+{
+    return normalize_input_paths_;
+}
+
+void WildcardPathMatcher::set_normalize_input_paths(bool normalize_input_paths)
+{
+    normalize_input_paths_ = normalize_input_paths;
+}
+
+std::shared_ptr<WildcardPathPool> WildcardPathMatcher::get_pool() const
+{
+    return pool_;
+}
+
+WildcardPathMatcher::MemoryUsage WildcardPathMatcher::get_memory_usage() const
+{
+    MemoryUsage memory_usage;
+    memory_usage.wildcard_paths = get_wildcard_paths_count();
+    memory_usage.storage = storage_.get_memory_usage();
+    memory_usage.required_literals_bytes = required_literals_.get_memory_usage() +
+                                           required_literal_postings_offsets_.capacity() * sizeof(uint32_t) +
+                                           required_literal_postings_.capacity() * sizeof(uint32_t) +
+                                           scanned_wildcard_path_ids_.capacity() * sizeof(uint32_t);
+    memory_usage.part_indexes_bytes =
+        (first_part_index_.part_hashes.capacity() + last_part_index_.part_hashes.capacity()) * sizeof(uint64_t) +
+        (first_part_index_.wildcard_path_ids.capacity() + last_part_index_.wildcard_path_ids.capacity()) *
+            sizeof(uint32_t);
+    memory_usage.leading_segments_bytes = leading_segment_matchers_.capacity() * sizeof(MultiSegmentMatcher);
+    for (std::vector<MultiSegmentMatcher>::const_iterator matcher_iter = leading_segment_matchers_.begin();
+         matcher_iter != leading_segment_matchers_.end();
+         ++matcher_iter)
+    {
+        memory_usage.leading_segments_bytes += matcher_iter->get_memory_usage();
+    }
+    memory_usage.owned_bytes = sizeof(WildcardPathMatcher) - sizeof(WildcardPathStorage) +
+                               memory_usage.storage.total_bytes +
+                               pooled_wildcard_paths_.capacity() * sizeof(std::shared_ptr<const CompiledWildcardPath>) +
+                               wildcard_path_filters_.capacity() * sizeof(WildcardPathFilter) +
+                               memory_usage.required_literals_bytes + memory_usage.part_indexes_bytes +
+                               memory_usage.leading_segments_bytes;
+    memory_usage.shared_bytes = 0;
+
+    // The same pooled path may be referenced more than once by this matcher, it is shared only if referenced outside
+    std::unordered_map<const CompiledWildcardPath*, size_t> matcher_references;
+    for (std::vector<std::shared_ptr<const CompiledWildcardPath>>::const_iterator pooled_iter =
+             pooled_wildcard_paths_.begin();
+         pooled_iter != pooled_wildcard_paths_.end();
+         ++pooled_iter)
+    {
+        matcher_references[pooled_iter->get()]++;
+    }
+    for (std::vector<std::shared_ptr<const CompiledWildcardPath>>::const_iterator pooled_iter =
+             pooled_wildcard_paths_.begin();
+         pooled_iter != pooled_wildcard_paths_.end();
+         ++pooled_iter)
+    {
+        std::unordered_map<const CompiledWildcardPath*, size_t>::iterator references_iter =
+            matcher_references.find(pooled_iter->get());
+        if (references_iter == matcher_references.end())
+        {
+            // Already counted with an earlier reference
+            continue;
+        }
+        const size_t compiled_path_bytes = get_compiled_wildcard_path_bytes(**pooled_iter);
+        if ((size_t)pooled_iter->use_count() > references_iter->second)
+        {
+            memory_usage.shared_bytes += compiled_path_bytes;
+        }
+        else
+        {
+            memory_usage.owned_bytes += compiled_path_bytes;
+        }
+        matcher_references.erase(references_iter);
+    }
+    return memory_usage;
+}
+
+WildcardPathMatcher::MatchPlan WildcardPathMatcher::get_match_plan() const
+{
+    MatchPlan match_plan = match_plan_;
+    match_plan.unplanned_wildcard_paths = get_wildcard_path_slots_count() - indexed_wildcard_paths_count_;
+    return match_plan;
+}
+
+size_t WildcardPathMatcher::get_match_step_budget() const
+{
+    return match_step_budget_;
+}
+
+void WildcardPathMatcher::set_match_step_budget(size_t match_step_budget)
+{
+    match_step_budget_ = match_step_budget;
+}
+
+bool WildcardPathMatcher::get_match_on_budget_exceeded() const
+{
+    return match_on_budget_exceeded_;
+}
+
+void WildcardPathMatcher::set_match_on_budget_exceeded(bool match_on_budget_exceeded)
+{
+    match_on_budget_exceeded_ = match_on_budget_exceeded;
+}
+
+size_t WildcardPathMatcher::get_max_wildcard_path_cost() const
+{
+    return max_wildcard_path_cost_;
+}
+
+void WildcardPathMatcher::set_max_wildcard_path_cost(size_t max_wildcard_path_cost)
+{
+    max_wildcard_path_cost_ = max_wildcard_path_cost;
+}
+
+WildcardPathMatcher::WildcardPathCost WildcardPathMatcher::estimate_wildcard_path_cost(std::string_view wildcard_path) const
+{
+    WildcardPathStorage estimated_storage;
+    estimated_storage.add_wildcard_path(wildcard_path, folder_seperator_);
+    return compute_wildcard_path_cost(estimated_storage.get_wildcard_path(0));
+}
+
+void WildcardPathMatcher::reserve(size_t wildcard_paths_count, size_t wildcard_paths_bytes)
+{
+    if (pool_)
+    {
+        pooled_wildcard_paths_.reserve(pooled_wildcard_paths_.size() + wildcard_paths_count);
+    }
+    else
+    {
+        storage_.reserve(wildcard_paths_count, wildcard_paths_bytes);
+    }
+    wildcard_path_filters_.reserve(wildcard_path_filters_.size() + wildcard_paths_count);
+}
+
+void WildcardPathMatcher::shrink_to_fit()
+{
+    storage_.shrink_to_fit();
+    pooled_wildcard_paths_.shrink_to_fit();
+    wildcard_path_filters_.shrink_to_fit();
+    required_literal_postings_offsets_.shrink_to_fit();
+    required_literal_postings_.shrink_to_fit();
+    scanned_wildcard_path_ids_.shrink_to_fit();
+    first_part_index_.part_hashes.shrink_to_fit();
+    first_part_index_.wildcard_path_ids.shrink_to_fit();
+    last_part_index_.part_hashes.shrink_to_fit();
+    last_part_index_.wildcard_path_ids.shrink_to_fit();
+}
+
+bool WildcardPathMatcher::validate_wildcard_path(std::string_view wildcard_path) const
+{
+    std::vector<std::string_view> path_parts;
+    CompiledWildcardPath::split_string_by_delimiter(wildcard_path, folder_seperator_, path_parts);
+    // Check the parts of the wildcard path to see if they are logical or not
+    for (std::vector<std::string_view>::iterator part_iter = path_parts.begin(); part_iter != path_parts.end();
+         ++part_iter)
+    {
+        for (size_t i = 0; i < part_iter->size(); i++)
+        {
+            char c = (*part_iter)[i];
+            if (c == SINGLE_WILDCARD_CHAR)
+            {
+                if ((i + 1) < part_iter->size() && (*part_iter)[i + 1] == SINGLE_WILDCARD_CHAR)
+                {
+                    // Found **, check that they are the only one
+                    if (part_iter->size() == strlen(DOUBLE_WILDCARD_STRING))
+                    {
+                        // We good
+                        break;
+                    }
+                    else
+                    {
+                        // We bad
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    // Wildcard paths too costly to compare are rejected as well, when a max cost is set
+    if (max_wildcard_path_cost_ != 0 &&
+        estimate_wildcard_path_cost(wildcard_path).steps_per_part > max_wildcard_path_cost_)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+void WildcardPathMatcher::add_wildcard_path(const std::string& wildcard_path)
+{
+    if (!validate_wildcard_path(wildcard_path))
+    {
+        throw std::runtime_error(std::string("The path is invalid: [") + wildcard_path + "]");
+    }
+
+    compile_wildcard_path(wildcard_path);
+    // Index the single adds in batches, until then they are compared without the index
+    if (get_wildcard_path_slots_count() - indexed_wildcard_paths_count_ >=
+        std::max(MIN_UNINDEXED_WILDCARD_PATHS, indexed_wildcard_paths_count_ / 4))
+    {
+        rebuild_match_plan();
+    }
+}
+
+void WildcardPathMatcher::add_wildcard_paths(const std::vector<std::string>& wildcard_paths)
+{
+    // Validate all paths before adding them
+    for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end(); ++iter)
+    {
+        if (!validate_wildcard_path(*iter))
+        {
+            throw std::runtime_error(std::string("A path is invalid: [") + *iter + "]");
+        }
+    }
+
+    // Add them only if they were all valid in the previous loop
+    size_t wildcard_paths_bytes = 0;
+    for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end(); ++iter)
+    {
+        wildcard_paths_bytes += iter->size();
+    }
+    reserve(wildcard_paths.size(), wildcard_paths_bytes);
+    for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end(); ++iter)
+    {
+        compile_wildcard_path(*iter);
+    }
+    rebuild_match_plan();
+}
+
+void WildcardPathMatcher::add_wildcard_paths_parallel(const std::vector<std::string>& wildcard_paths,
+                                                      size_t threads_count)
+{
+    if (threads_count == 0)
+    {
+        threads_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    const size_t chunks_count =
+        std::max<size_t>(std::min(threads_count, wildcard_paths.size() / MIN_PARALLEL_CHUNK_SIZE), 1);
+    std::vector<size_t> chunk_begins(chunks_count + 1);
+    for (size_t chunk = 0; chunk <= chunks_count; chunk++)
+    {
+        chunk_begins[chunk] = wildcard_paths.size() * chunk / chunks_count;
+    }
+
+    // Validate all the wildcard paths before adding any of them, and collect every invalid one
+    std::vector<std::vector<size_t>> invalid_wildcard_path_ids(chunks_count);
+    run_chunks_in_parallel(chunks_count, [&](size_t chunk) {
+        for (size_t i = chunk_begins[chunk]; i < chunk_begins[chunk + 1]; i++)
+        {
+            if (!validate_wildcard_path(wildcard_paths[i]))
+            {
+                invalid_wildcard_path_ids[chunk].push_back(i);
+            }
+        }
+    });
+    std::string invalid_wildcard_paths;
+    for (size_t chunk = 0; chunk < chunks_count; chunk++)
+    {
+        for (std::vector<size_t>::const_iterator id_iter = invalid_wildcard_path_ids[chunk].begin();
+             id_iter != invalid_wildcard_path_ids[chunk].end();
+             ++id_iter)
+        {
+            invalid_wildcard_paths += std::string(invalid_wildcard_paths.empty() ? "" : ", ") + "line " +
+                                      std::to_string(*id_iter + 1) + " [" + wildcard_paths[*id_iter] + "]";
+        }
+    }
+    if (!invalid_wildcard_paths.empty())
+    {
+        throw std::runtime_error(std::string("Some paths are invalid: ") + invalid_wildcard_paths);
+    }
+
+    // Compile every chunk on its own, the pool is thread safe and chunk storages are spliced together after
+    const size_t first_wildcard_path_id = get_wildcard_path_slots_count();
+    if (pool_)
+    {
+        pooled_wildcard_paths_.resize(first_wildcard_path_id + wildcard_paths.size());
+        run_chunks_in_parallel(chunks_count, [&](size_t chunk) {
+            for (size_t i = chunk_begins[chunk]; i < chunk_begins[chunk + 1]; i++)
+            {
+                pooled_wildcard_paths_[first_wildcard_path_id + i] =
+                    pool_->intern(wildcard_paths[i], folder_seperator_);
+            }
+        });
+    }
+    else
+    {
+        std::vector<WildcardPathStorage> chunk_storages(chunks_count);
+        run_chunks_in_parallel(chunks_count, [&](size_t chunk) {
+            for (size_t i = chunk_begins[chunk]; i < chunk_begins[chunk + 1]; i++)
+            {
+                chunk_storages[chunk].add_wildcard_path(wildcard_paths[i], folder_seperator_);
+            }
+        });
+        size_t wildcard_paths_bytes = 0;
+        for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end();
+             ++iter)
+        {
+            wildcard_paths_bytes += iter->size();
+        }
+        storage_.reserve(wildcard_paths.size(), wildcard_paths_bytes);
+        for (std::vector<WildcardPathStorage>::iterator storage_iter = chunk_storages.begin();
+             storage_iter != chunk_storages.end();
+             ++storage_iter)
+        {
+            storage_.append(*storage_iter);
+            storage_iter->clear();
+            storage_iter->shrink_to_fit();
+        }
+    }
+
+    // The pre filters only read the compiled wildcard paths, and the index is built once over everything
+    wildcard_path_filters_.resize(first_wildcard_path_id + wildcard_paths.size());
+    run_chunks_in_parallel(chunks_count, [&](size_t chunk) {
+        for (size_t i = chunk_begins[chunk]; i < chunk_begins[chunk + 1]; i++)
+        {
+            wildcard_path_filters_[first_wildcard_path_id + i] =
+                compute_wildcard_path_filter(get_compiled_wildcard_path(first_wildcard_path_id + i));
+        }
+    });
+    rebuild_match_plan();
+}
+
+void WildcardPathMatcher::add_wildcard_paths(std::vector<std::string>&& wildcard_paths)
+{
+    // The strings are copied into the contiguous storage either way, so this only releases them early
+    add_wildcard_paths(static_cast<const std::vector<std::string>&>(wildcard_paths));
+    wildcard_paths.clear();
+    wildcard_paths.shrink_to_fit();
+}
+
+void WildcardPathMatcher::clean_wildcard_paths()
+{
+    storage_.clear();
+    pooled_wildcard_paths_.clear();
+    wildcard_path_filters_.clear();
+    required_literals_.clear();
+    required_literal_postings_offsets_.clear();
+    required_literal_postings_.clear();
+    scanned_wildcard_path_ids_.clear();
+    leading_segment_matchers_.clear();
+    first_part_index_ = PartIndex();
+    last_part_index_ = PartIndex();
+    indexed_wildcard_paths_count_ = 0;
+    match_plan_ = MatchPlan{0, 0, 0, 0, 0, 0};
+    removed_wildcard_path_slots_.clear();
+    stale_wildcard_paths_count_ = 0;
+    wildcard_path_slots_by_hash_.clear();
+}
+
+std::vector<std::string> WildcardPathMatcher::get_wildcard_paths() const
+{
+    std::vector<std::string> wildcard_paths;
+    wildcard_paths.reserve(get_wildcard_paths_count());
+    for (size_t wildcard_path_slot = 0; wildcard_path_slot < get_wildcard_path_slots_count(); wildcard_path_slot++)
+    {
+        if (!is_removed_wildcard_path_slot(wildcard_path_slot))
+        {
+            wildcard_paths.push_back(std::string(get_compiled_wildcard_path(wildcard_path_slot).path));
+        }
+    }
+    return wildcard_paths;
+}
+
+size_t WildcardPathMatcher::get_wildcard_paths_count() const
+{
+    return get_wildcard_path_slots_count() - removed_wildcard_path_slots_.size();
+}
+
+size_t WildcardPathMatcher::get_wildcard_path_slots_count() const
+{
+    if (pool_)
+    {
+        return pooled_wildcard_paths_.size();
+    }
+
+    return storage_.get_wildcard_paths_count();
+}
+
+bool WildcardPathMatcher::is_removed_wildcard_path_slot(size_t wildcard_path_slot) const
+{
+    return !removed_wildcard_path_slots_.empty() &&
+           std::binary_search(
+               removed_wildcard_path_slots_.begin(), removed_wildcard_path_slots_.end(), (uint32_t)wildcard_path_slot);
+}
+
+size_t WildcardPathMatcher::to_wildcard_path_id(size_t wildcard_path_slot) const
+{
+    return wildcard_path_slot - (std::lower_bound(removed_wildcard_path_slots_.begin(),
+                                                  removed_wildcard_path_slots_.end(),
+                                                  (uint32_t)wildcard_path_slot) -
+                                 removed_wildcard_path_slots_.begin());
+}
+
+size_t WildcardPathMatcher::to_wildcard_path_slot(size_t wildcard_path_id) const
+{
+    // The removed slot at index i has slot - i wildcard paths before it, which only grows along the slots,
+    // so the removed slots before the id are found by a binary search on it
+    size_t removed_begin = 0;
+    size_t removed_end = removed_wildcard_path_slots_.size();
+    while (removed_begin < removed_end)
+    {
+        const size_t removed_middle = (removed_begin + removed_end) / 2;
+        if (removed_wildcard_path_slots_[removed_middle] - removed_middle <= wildcard_path_id)
+        {
+            removed_begin = removed_middle + 1;
+        }
+        else
+        {
+            removed_end = removed_middle;
+        }
+    }
+    return wildcard_path_id + removed_begin;
+}
+
+std::string_view WildcardPathMatcher::get_wildcard_path(size_t wildcard_path_id) const
+{
+    if (wildcard_path_id >= get_wildcard_paths_count())
+    {
+        throw std::runtime_error(std::string("The wildcard path id is invalid: [") + std::to_string(wildcard_path_id) +
+                                 "]");
+    }
+
+    return get_compiled_wildcard_path(to_wildcard_path_slot(wildcard_path_id)).path;
+}
+
+void WildcardPathMatcher::disable_wildcard_path_filter(size_t wildcard_path_slot)
+{
+    WildcardPathFilter& filter = wildcard_path_filters_[wildcard_path_slot];
+    filter.min_parts = UINT32_MAX;
+    filter.max_parts = 0;
+}
+
+void WildcardPathMatcher::release_stale_wildcard_paths()
+{
+    if (stale_wildcard_paths_count_ == 0)
+    {
+        return;
+    }
+
+    if (pool_)
+    {
+        std::vector<uint32_t>::const_iterator removed_iter = removed_wildcard_path_slots_.begin();
+        size_t kept_slot = 0;
+        for (size_t wildcard_path_slot = 0; wildcard_path_slot < pooled_wildcard_paths_.size(); wildcard_path_slot++)
+        {
+            if (removed_iter != removed_wildcard_path_slots_.end() && *removed_iter == wildcard_path_slot)
+            {
+                ++removed_iter;
+                continue;
+            }
+            pooled_wildcard_paths_[kept_slot++] = std::move(pooled_wildcard_paths_[wildcard_path_slot]);
+        }
+        pooled_wildcard_paths_.resize(kept_slot);
+    }
+    else
+    {
+        storage_.remove_wildcard_paths(removed_wildcard_path_slots_);
+    }
+
+    std::vector<uint32_t>::const_iterator removed_iter = removed_wildcard_path_slots_.begin();
+    size_t kept_slot = 0;
+    for (size_t wildcard_path_slot = 0; wildcard_path_slot < wildcard_path_filters_.size(); wildcard_path_slot++)
+    {
+        if (removed_iter != removed_wildcard_path_slots_.end() && *removed_iter == wildcard_path_slot)
+        {
+            ++removed_iter;
+            continue;
+        }
+        wildcard_path_filters_[kept_slot++] = wildcard_path_filters_[wildcard_path_slot];
+    }
+    wildcard_path_filters_.resize(kept_slot);
+    removed_wildcard_path_slots_.clear();
+    stale_wildcard_paths_count_ = 0;
+    wildcard_path_slots_by_hash_.clear();
+}
+
+void WildcardPathMatcher::count_stale_wildcard_path()
+{
+    // Same batching as the single adds, the stale entries only take memory until then
+    if (++stale_wildcard_paths_count_ < std::max(MIN_UNINDEXED_WILDCARD_PATHS, indexed_wildcard_paths_count_ / 4))
+    {
+        return;
+    }
+
+    // The removed slots are no longer in the indexes, so the kept ones only move down by the removed ones before them
+    std::vector<uint32_t>* indexed_ids[] = {&required_literal_postings_,
+                                            &first_part_index_.wildcard_path_ids,
+                                            &last_part_index_.wildcard_path_ids,
+                                            &scanned_wildcard_path_ids_};
+    for (size_t i = 0; i < sizeof(indexed_ids) / sizeof(indexed_ids[0]); i++)
+    {
+        for (std::vector<uint32_t>::iterator id_iter = indexed_ids[i]->begin(); id_iter != indexed_ids[i]->end();
+             ++id_iter)
+        {
+            *id_iter = (uint32_t)to_wildcard_path_id(*id_iter);
+        }
+    }
+    indexed_wildcard_paths_count_ = to_wildcard_path_id(indexed_wildcard_paths_count_);
+    release_stale_wildcard_paths();
+    // Drops the bits of the segments that were erased or set since they were built
+    build_leading_segment_matchers();
+}
+
+void WildcardPathMatcher::rank_wildcard_paths_by_specificity()
+{
+    std::vector<uint32_t> ranked_slots(wildcard_path_filters_.size());
+    for (size_t wildcard_path_slot = 0; wildcard_path_slot < ranked_slots.size(); wildcard_path_slot++)
+    {
+        ranked_slots[wildcard_path_slot] = wildcard_path_slot;
+    }
+    std::sort(ranked_slots.begin(), ranked_slots.end(), [&](uint32_t first_slot, uint32_t second_slot) {
+        return is_more_specific_wildcard_path(first_slot, second_slot);
+    });
+    for (size_t rank = 0; rank < ranked_slots.size(); rank++)
+    {
+        wildcard_path_filters_[ranked_slots[rank]].specificity_rank = rank;
+    }
+}
+
+bool WildcardPathMatcher::is_more_specific_wildcard_path(size_t first_slot, size_t second_slot) const
+{
+    // The first added wins within the same specificity, like it does for the regular lookups
+    const uint64_t first_specificity = wildcard_path_filters_[first_slot].specificity;
+    const uint64_t second_specificity = wildcard_path_filters_[second_slot].specificity;
+    return first_specificity > second_specificity ||
+           (first_specificity == second_specificity && first_slot < second_slot);
+}
+
+void WildcardPathMatcher::unindex_wildcard_path(size_t wildcard_path_slot)
+{
+    // The wildcard paths added since the last plan are in no index
+    if (wildcard_path_slot >= indexed_wildcard_paths_count_)
+    {
+        return;
+    }
+
+    std::vector<uint32_t>::iterator scanned_iter = std::lower_bound(
+        scanned_wildcard_path_ids_.begin(), scanned_wildcard_path_ids_.end(), (uint32_t)wildcard_path_slot);
+    if (scanned_iter != scanned_wildcard_path_ids_.end() && *scanned_iter == wildcard_path_slot)
+    {
+        const size_t scanned_index = scanned_iter - scanned_wildcard_path_ids_.begin();
+        scanned_wildcard_path_ids_.erase(scanned_iter);
+        for (std::vector<MultiSegmentMatcher>::iterator matcher_iter = leading_segment_matchers_.begin();
+             matcher_iter != leading_segment_matchers_.end();
+             ++matcher_iter)
+        {
+            matcher_iter->erase_segment(scanned_index);
+        }
+        match_plan_.scanned_wildcard_paths--;
+        return;
+    }
+
+    CompiledWildcardPath wildcard_path = get_compiled_wildcard_path(wildcard_path_slot);
+    uint64_t first_part_hash;
+    if (get_first_part_hash(wildcard_path, first_part_hash) &&
+        erase_part_index_entry(first_part_index_, first_part_hash, (uint32_t)wildcard_path_slot))
+    {
+        match_plan_.first_part_indexed_wildcard_paths--;
+        return;
+    }
+    const WildcardPathFilter& filter = wildcard_path_filters_[wildcard_path_slot];
+    if (filter.last_part_size != UINT32_MAX &&
+        erase_part_index_entry(last_part_index_, filter.last_part_hash, (uint32_t)wildcard_path_slot))
+    {
+        match_plan_.last_part_indexed_wildcard_paths--;
+        return;
+    }
+
+    // Otherwise it is in the posting list of one of its required literals, which all occur in its own string
+    std::vector<uint32_t> literal_ids;
+    required_literals_.find_literals(wildcard_path.path, literal_ids);
+    for (std::vector<uint32_t>::const_iterator literal_iter = literal_ids.begin(); literal_iter != literal_ids.end();
+         ++literal_iter)
+    {
+        std::vector<uint32_t>::iterator postings_end =
+            required_literal_postings_.begin() + required_literal_postings_offsets_[*literal_iter + 1];
+        std::vector<uint32_t>::iterator posting_iter =
+            std::lower_bound(required_literal_postings_.begin() + required_literal_postings_offsets_[*literal_iter],
+                             postings_end,
+                             (uint32_t)wildcard_path_slot);
+        if (posting_iter == postings_end || *posting_iter != wildcard_path_slot)
+        {
+            continue;
+        }
+        required_literal_postings_.erase(posting_iter);
+        for (std::vector<uint32_t>::iterator offset_iter =
+                 required_literal_postings_offsets_.begin() + *literal_iter + 1;
+             offset_iter != required_literal_postings_offsets_.end();
+             ++offset_iter)
+        {
+            (*offset_iter)--;
+        }
+        match_plan_.literal_indexed_wildcard_paths--;
+        return;
+    }
+}
+
+void WildcardPathMatcher::index_wildcard_path(size_t wildcard_path_slot)
+{
+    // The wildcard paths added since the last plan are compared on every lookup
+    if (wildcard_path_slot >= indexed_wildcard_paths_count_)
+    {
+        return;
+    }
+
+    // The literal segments are picked first, since they find the wildcard path without scanning the input
+    CompiledWildcardPath wildcard_path = get_compiled_wildcard_path(wildcard_path_slot);
+    uint64_t first_part_hash;
+    if (get_first_part_hash(wildcard_path, first_part_hash))
+    {
+        insert_part_index_entry(first_part_index_, first_part_hash, (uint32_t)wildcard_path_slot);
+        match_plan_.first_part_indexed_wildcard_paths++;
+        return;
+    }
+    const WildcardPathFilter& filter = wildcard_path_filters_[wildcard_path_slot];
+    if (filter.last_part_size != UINT32_MAX)
+    {
+        insert_part_index_entry(last_part_index_, filter.last_part_hash, (uint32_t)wildcard_path_slot);
+        match_plan_.last_part_indexed_wildcard_paths++;
+        return;
+    }
+
+    std::vector<uint32_t>::iterator scanned_iter = std::lower_bound(
+        scanned_wildcard_path_ids_.begin(), scanned_wildcard_path_ids_.end(), (uint32_t)wildcard_path_slot);
+    const size_t scanned_index = scanned_iter - scanned_wildcard_path_ids_.begin();
+    scanned_wildcard_path_ids_.insert(scanned_iter, (uint32_t)wildcard_path_slot);
+    const size_t leading_segments_count = get_leading_segments_count(wildcard_path);
+    for (size_t depth = 0; depth < leading_segment_matchers_.size(); depth++)
+    {
+        leading_segment_matchers_[depth].insert_segment(
+            scanned_index,
+            depth < leading_segments_count ? wildcard_path.get_segment_string(wildcard_path.segments[depth])
+                                           : std::string_view());
+    }
+    match_plan_.scanned_wildcard_paths++;
+}
+
+void WildcardPathMatcher::insert_wildcard_path_slot_by_hash(size_t wildcard_path_slot)
+{
+    if (!wildcard_path_slots_by_hash_.empty())
+    {
+        wildcard_path_slots_by_hash_.emplace(
+            std::hash<std::string_view>()(get_compiled_wildcard_path(wildcard_path_slot).path),
+            (uint32_t)wildcard_path_slot);
+    }
+}
+
+void WildcardPathMatcher::erase_wildcard_path_slot_by_hash(size_t wildcard_path_slot)
+{
+    typedef std::unordered_multimap<size_t, uint32_t>::iterator SlotIterator;
+    std::pair<SlotIterator, SlotIterator> slots_range = wildcard_path_slots_by_hash_.equal_range(
+        std::hash<std::string_view>()(get_compiled_wildcard_path(wildcard_path_slot).path));
+    for (SlotIterator slot_iter = slots_range.first; slot_iter != slots_range.second; ++slot_iter)
+    {
+        if (slot_iter->second == wildcard_path_slot)
+        {
+            wildcard_path_slots_by_hash_.erase(slot_iter);
+            return;
+        }
+    }
+}
+
+void WildcardPathMatcher::remove_wildcard_path(size_t wildcard_path_id)
+{
+    if (wildcard_path_id >= get_wildcard_paths_count())
+    {
+        throw std::runtime_error(std::string("The wildcard path id is invalid: [") + std::to_string(wildcard_path_id) +
+                                 "]");
+    }
+
+    const size_t wildcard_path_slot = to_wildcard_path_slot(wildcard_path_id);
+    unindex_wildcard_path(wildcard_path_slot);
+    erase_wildcard_path_slot_by_hash(wildcard_path_slot);
+    removed_wildcard_path_slots_.insert(
+        std::upper_bound(
+            removed_wildcard_path_slots_.begin(), removed_wildcard_path_slots_.end(), (uint32_t)wildcard_path_slot),
+        (uint32_t)wildcard_path_slot);
+    // The wildcard paths added since the last plan are compared without an index, so the pre filter keeps it out
+    disable_wildcard_path_filter(wildcard_path_slot);
+    count_stale_wildcard_path();
+}
+
+bool WildcardPathMatcher::remove_wildcard_path(std::string_view wildcard_path)
+{
+    if (wildcard_path_slots_by_hash_.empty())
+    {
+        wildcard_path_slots_by_hash_.reserve(get_wildcard_paths_count());
+        for (size_t wildcard_path_slot = 0; wildcard_path_slot < get_wildcard_path_slots_count(); wildcard_path_slot++)
+        {
+            if (!is_removed_wildcard_path_slot(wildcard_path_slot))
+            {
+                wildcard_path_slots_by_hash_.emplace(
+                    std::hash<std::string_view>()(get_compiled_wildcard_path(wildcard_path_slot).path),
+                    (uint32_t)wildcard_path_slot);
+            }
+        }
+    }
+
+    // Equal wildcard paths share the hash, the first added is removed
+    typedef std::unordered_multimap<size_t, uint32_t>::const_iterator SlotIterator;
+    std::pair<SlotIterator, SlotIterator> slots_range =
+        wildcard_path_slots_by_hash_.equal_range(std::hash<std::string_view>()(wildcard_path));
+    size_t found_slot = SIZE_MAX;
+    for (SlotIterator slot_iter = slots_range.first; slot_iter != slots_range.second; ++slot_iter)
+    {
+        if (slot_iter->second < found_slot && get_compiled_wildcard_path(slot_iter->second).path == wildcard_path)
+        {
+            found_slot = slot_iter->second;
+        }
+    }
+    if (found_slot == SIZE_MAX)
+    {
+        return false;
+    }
+
+    remove_wildcard_path(to_wildcard_path_id(found_slot));
+    return true;
+}
+
+void WildcardPathMatcher::replace_wildcard_path(size_t wildcard_path_id, const std::string& wildcard_path)
+{
+    if (wildcard_path_id >= get_wildcard_paths_count())
+    {
+        throw std::runtime_error(std::string("The wildcard path id is invalid: [") + std::to_string(wildcard_path_id) +
+                                 "]");
+    }
+    if (!validate_wildcard_path(wildcard_path))
+    {
+        throw std::runtime_error(std::string("The path is invalid: [") + wildcard_path + "]");
+    }
+
+    // The old wildcard path is taken out while its compiled form and pre filter still give its index keys
+    const size_t wildcard_path_slot = to_wildcard_path_slot(wildcard_path_id);
+    unindex_wildcard_path(wildcard_path_slot);
+    erase_wildcard_path_slot_by_hash(wildcard_path_slot);
+    if (pool_)
+    {
+        pooled_wildcard_paths_[wildcard_path_slot] = pool_->intern(wildcard_path, folder_seperator_);
+    }
+    else
+    {
+        storage_.replace_wildcard_path(wildcard_path_slot, wildcard_path, folder_seperator_);
+    }
+    wildcard_path_filters_[wildcard_path_slot] =
+        compute_wildcard_path_filter(get_compiled_wildcard_path(wildcard_path_slot));
+    index_wildcard_path(wildcard_path_slot);
+    insert_wildcard_path_slot_by_hash(wildcard_path_slot);
+    count_stale_wildcard_path();
+}
+
+void WildcardPathMatcher::insert_wildcard_path(size_t wildcard_path_id, const std::string& wildcard_path)
+{
+    if (wildcard_path_id > get_wildcard_paths_count())
+    {
+        throw std::runtime_error(std::string("The wildcard path id is invalid: [") + std::to_string(wildcard_path_id) +
+                                 "]");
+    }
+    if (wildcard_path_id == get_wildcard_paths_count())
+    {
+        add_wildcard_path(wildcard_path);
+        return;
+    }
+    if (!validate_wildcard_path(wildcard_path))
+    {
+        throw std::runtime_error(std::string("The path is invalid: [") + wildcard_path + "]");
+    }
+
+    // The slots from the new one on move up by one, in the indexes and the removed slots as well
+    const size_t wildcard_path_slot = to_wildcard_path_slot(wildcard_path_id);
+    std::vector<uint32_t>* slots[] = {&required_literal_postings_,
+                                      &first_part_index_.wildcard_path_ids,
+                                      &last_part_index_.wildcard_path_ids,
+                                      &scanned_wildcard_path_ids_,
+                                      &removed_wildcard_path_slots_};
+    for (size_t i = 0; i < sizeof(slots) / sizeof(slots[0]); i++)
+    {
+        for (std::vector<uint32_t>::iterator slot_iter = slots[i]->begin(); slot_iter != slots[i]->end(); ++slot_iter)
+        {
+            if (*slot_iter >= wildcard_path_slot)
+            {
+                (*slot_iter)++;
+            }
+        }
+    }
+    if (wildcard_path_slot < indexed_wildcard_paths_count_)
+    {
+        indexed_wildcard_paths_count_++;
+    }
+    wildcard_path_slots_by_hash_.clear();
+
+    if (pool_)
+    {
+        pooled_wildcard_paths_.insert(pooled_wildcard_paths_.begin() + wildcard_path_slot,
+                                      pool_->intern(wildcard_path, folder_seperator_));
+    }
+    else
+    {
+        storage_.insert_wildcard_path(wildcard_path_slot, wildcard_path, folder_seperator_);
+    }
+    wildcard_path_filters_.insert(wildcard_path_filters_.begin() + wildcard_path_slot,
+                                  compute_wildcard_path_filter(get_compiled_wildcard_path(wildcard_path_slot)));
+    index_wildcard_path(wildcard_path_slot);
+}
+
+bool WildcardPathMatcher::fits_wildcard_path_filter(size_t wildcard_path_id, const PathView& path_view) const
+{
+    // The checks are combined without short circuiting, so they cost a single branch
+    const WildcardPathFilter& filter = wildcard_path_filters_[wildcard_path_id];
+    const PathView::Facts& facts = path_view.get_facts();
+    return !((facts.parts < filter.min_parts) | (facts.parts > filter.max_parts) | (facts.chars < filter.min_chars) |
+             ((filter.last_part_size != UINT32_MAX) &
+              ((facts.last_part_size != filter.last_part_size) | (facts.last_part_hash != filter.last_part_hash))) |
+             ((filter.required_chars & ~facts.chars_signature) != 0));
+}
+
+void WildcardPathMatcher::insert_part_index_entry(PartIndex& part_index, uint64_t part_hash, uint32_t wildcard_path_id)
+{
+    std::pair<std::vector<uint64_t>::iterator, std::vector<uint64_t>::iterator> hash_range =
+        std::equal_range(part_index.part_hashes.begin(), part_index.part_hashes.end(), part_hash);
+    const size_t hash_begin = hash_range.first - part_index.part_hashes.begin();
+    const size_t hash_end = hash_range.second - part_index.part_hashes.begin();
+    const size_t entry_index = std::lower_bound(part_index.wildcard_path_ids.begin() + hash_begin,
+                                                part_index.wildcard_path_ids.begin() + hash_end,
+                                                wildcard_path_id) -
+                               part_index.wildcard_path_ids.begin();
+    part_index.part_hashes.insert(part_index.part_hashes.begin() + entry_index, part_hash);
+    part_index.wildcard_path_ids.insert(part_index.wildcard_path_ids.begin() + entry_index, wildcard_path_id);
+}
+
+bool WildcardPathMatcher::erase_part_index_entry(PartIndex& part_index, uint64_t part_hash, uint32_t wildcard_path_id)
+{
+    std::pair<std::vector<uint64_t>::iterator, std::vector<uint64_t>::iterator> hash_range =
+        std::equal_range(part_index.part_hashes.begin(), part_index.part_hashes.end(), part_hash);
+    std::vector<uint32_t>::iterator ids_end =
+        part_index.wildcard_path_ids.begin() + (hash_range.second - part_index.part_hashes.begin());
+    std::vector<uint32_t>::iterator id_iter = std::lower_bound(
+        part_index.wildcard_path_ids.begin() + (hash_range.first - part_index.part_hashes.begin()),
+        ids_end,
+        wildcard_path_id);
+    if (id_iter == ids_end || *id_iter != wildcard_path_id)
+    {
+        return false;
+    }
+    part_index.part_hashes.erase(part_index.part_hashes.begin() + (id_iter - part_index.wildcard_path_ids.begin()));
+    part_index.wildcard_path_ids.erase(id_iter);
+    return true;
+}
+
+void WildcardPathMatcher::find_part_index_candidates(const PartIndex& part_index,
+                                                     uint64_t part_hash,
+                                                     std::vector<uint32_t>& candidate_ids)
+{
+    std::pair<std::vector<uint64_t>::const_iterator, std::vector<uint64_t>::const_iterator> hash_range =
+        std::equal_range(part_index.part_hashes.begin(), part_index.part_hashes.end(), part_hash);
+    candidate_ids.insert(candidate_ids.end(),
+                         part_index.wildcard_path_ids.begin() + (hash_range.first - part_index.part_hashes.begin()),
+                         part_index.wildcard_path_ids.begin() + (hash_range.second - part_index.part_hashes.begin()));
+}
+
+template <typename CandidateVisitor>
+void WildcardPathMatcher::for_each_candidate_wildcard_path(const PathView& path_view,
+                                                           CandidateVisitor&& candidate_visitor) const
+{
+    // The path view carries the input facts, to be checked against the pre filter of every wildcard path
+    // The scratch memory is only used for the candidates, the path view may be the scratch one itself
+    MatchScratch& scratch = get_thread_match_scratch();
+
+    // Collect the indexed wildcard paths whose required literal occurs in the input
+    // Every wildcard path is planned to a single engine with a single key, so the candidates do not overlap
+    scratch.literal_ids.clear();
+    scratch.candidate_ids.clear();
+    if (!required_literal_postings_.empty())
+    {
+        required_literals_.find_literals(path_view.get_input(), scratch.literal_ids);
+        std::sort(scratch.literal_ids.begin(), scratch.literal_ids.end());
+        scratch.literal_ids.erase(std::unique(scratch.literal_ids.begin(), scratch.literal_ids.end()),
+                                  scratch.literal_ids.end());
+    }
+    for (std::vector<uint32_t>::const_iterator literal_iter = scratch.literal_ids.begin();
+         literal_iter != scratch.literal_ids.end();
+         ++literal_iter)
+    {
+        const uint32_t* postings = required_literal_postings_.data();
+        scratch.candidate_ids.insert(scratch.candidate_ids.end(),
+                                     postings + required_literal_postings_offsets_[*literal_iter],
+                                     postings + required_literal_postings_offsets_[*literal_iter + 1]);
+    }
+    // And the ones whose literal first or last segment is the first or last input part
+    if (!first_part_index_.part_hashes.empty() && !path_view.get_parts().empty())
+    {
+        find_part_index_candidates(
+            first_part_index_, PathView::hash_part(path_view.get_parts().front()), scratch.candidate_ids);
+    }
+    if (!last_part_index_.part_hashes.empty())
+    {
+        find_part_index_candidates(last_part_index_, path_view.get_facts().last_part_hash, scratch.candidate_ids);
+    }
+    std::sort(scratch.candidate_ids.begin(), scratch.candidate_ids.end());
+
+    // The scanned wildcard paths are narrowed by their leading segments, all the distinct segments of a depth are
+    // matched in a single pass over its part, once the first scanned wildcard path reaches it
+    const size_t filtered_depth = std::min(leading_segment_matchers_.size(), path_view.get_parts().size());
+    size_t matched_depth = 0;
+
+    // Go over the candidates together with the scanned wildcard paths, in the order they were added
+    std::vector<uint32_t>::const_iterator candidate_iter = scratch.candidate_ids.begin();
+    std::vector<uint32_t>::const_iterator scanned_iter = scanned_wildcard_path_ids_.begin();
+    while (candidate_iter != scratch.candidate_ids.end() || scanned_iter != scanned_wildcard_path_ids_.end())
+    {
+        size_t wildcard_path_id;
+        if (scanned_iter == scanned_wildcard_path_ids_.end() ||
+            (candidate_iter != scratch.candidate_ids.end() && *candidate_iter < *scanned_iter))
+        {
+            wildcard_path_id = *candidate_iter++;
+        }
+        else
+        {
+            const size_t scanned_index = scanned_iter - scanned_wildcard_path_ids_.begin();
+            wildcard_path_id = *scanned_iter++;
+            size_t depth = 0;
+            for (; depth < filtered_depth; depth++)
+            {
+                if (depth == matched_depth)
+                {
+                    leading_segment_matchers_[depth].match(path_view.get_parts()[depth],
+                                                           scratch.leading_segment_masks[depth]);
+                    matched_depth++;
+                }
+                if (!leading_segment_matchers_[depth].is_matched(scanned_index, scratch.leading_segment_masks[depth]))
+                {
+                    break;
+                }
+            }
+            if (depth < filtered_depth)
+            {
+                continue;
+            }
+        }
+        if (candidate_visitor(wildcard_path_id))
+        {
+            return;
+        }
+    }
+
+    // The wildcard paths added after the index was built are all compared
+    const size_t wildcard_paths_count = get_wildcard_path_slots_count();
+    for (size_t wildcard_path_id = indexed_wildcard_paths_count_; wildcard_path_id < wildcard_paths_count;
+         wildcard_path_id++)
+    {
+        if (candidate_visitor(wildcard_path_id))
+        {
+            return;
+        }
+    }
+}
+
+template <typename CandidateVisitor>
+WildcardPathMatcher::MatchStatus WildcardPathMatcher::visit_candidate_wildcard_paths(
+    const PathView& path_view, size_t& match_slot, size_t& steps, CandidateVisitor&& candidate_visitor) const
+{
+    OCTO_WILDCARD_TRACE(match_start, path_view.get_input().data(), path_view.get_input().size());
+    const size_t step_budget = match_step_budget_ != 0 ? match_step_budget_ : SIZE_MAX;
+    const size_t input_parts_count = path_view.get_parts().size();
+    size_t compared_wildcard_paths = 0;
+    MatchStatus match_status = MatchStatus::NOT_FOUND;
+    steps = 0;
+    for_each_candidate_wildcard_path(path_view, [&](size_t wildcard_path_id) {
+        // A step for the pre filter, and the worst case of the comparison if it has to be made
+        const bool should_compare = fits_wildcard_path_filter(wildcard_path_id, path_view);
+        size_t candidate_steps = 1;
+        if (should_compare)
+        {
+            const WildcardPathFilter& filter = wildcard_path_filters_[wildcard_path_id];
+            candidate_steps += filter.fixed_steps + size_t(filter.steps_per_part) * input_parts_count;
+        }
+        if (candidate_steps > step_budget - steps)
+        {
+            match_status = MatchStatus::BUDGET_EXCEEDED;
+            return true;
+        }
+        steps += candidate_steps;
+        if (!should_compare)
+        {
+            return false;
+        }
+        compared_wildcard_paths++;
+        MatchStatus candidate_match_status = MatchStatus::NOT_FOUND;
+        const bool should_stop = candidate_visitor(wildcard_path_id, candidate_match_status);
+        if (candidate_match_status == MatchStatus::FOUND)
+        {
+            match_slot = wildcard_path_id;
+            match_status = MatchStatus::FOUND;
+        }
+        return should_stop;
+    });
+    if (match_status == MatchStatus::BUDGET_EXCEEDED)
+    {
+        OCTO_WILDCARD_TRACE(budget_exceeded, path_view.get_input().data(), path_view.get_input().size(), steps);
+    }
+    OCTO_WILDCARD_TRACE(match_done,
+                        int(match_status),
+                        match_status == MatchStatus::FOUND ? (long)to_wildcard_path_id(match_slot) : -1L,
+                        steps,
+                        compared_wildcard_paths);
+    return match_status;
+}
+
+WildcardPathMatcher::MatchStatus
+WildcardPathMatcher::find_wildcard_match(const PathView& path_view, size_t& match_slot, size_t& steps) const
+{
+    return visit_candidate_wildcard_paths(
+        path_view, match_slot, steps, [&](size_t wildcard_path_id, MatchStatus& match_status) {
+            if (!compare_validated_wildcard_paths(path_view.get_parts(), get_compiled_wildcard_path(wildcard_path_id)))
+            {
+                return false;
+            }
+            match_status = MatchStatus::FOUND;
+            return true;
+        });
 }
 
-bool WildcardPathMatcher::compare_validated_wildcard_paths(const std::vector<std::string>& input_path_parts,
-                                                             const std::string& wildcard_path) const
+WildcardPathMatcher::MatchStatus WildcardPathMatcher::find_most_specific_wildcard_match(const PathView& path_view,
+                                                                                        size_t& match_slot,
+                                                                                        size_t& steps) const
 {
-    // Split the wildcard path
-    std::vector<std::string> wildcard_path_parts = split_string_by_delimiter(wildcard_path, folder_seperator_);
+    OCTO_WILDCARD_TRACE(match_start, path_view.get_input().data(), path_view.get_input().size());
+    const size_t step_budget = match_step_budget_ != 0 ? match_step_budget_ : SIZE_MAX;
+    const size_t input_parts_count = path_view.get_parts().size();
+    size_t compared_wildcard_paths = 0;
+    MatchStatus match_status = MatchStatus::NOT_FOUND;
+    steps = 0;
 
-    // Start going over the wildcard path parts and validate them against the input path
-    int wildcard_path_part_index = 0;
-    int input_path_part_index = 0;
+    // Collect the candidates, each one charged the pre filter step
+    // The rank is kept above the slot, so the smallest key of the ranked candidates is the next one to compare, and
+    // only the few wildcard paths added or replaced since the plan are unranked
+    MatchScratch& scratch = get_thread_match_scratch();
+    scratch.ranked_candidates.clear();
+    scratch.unranked_candidates.clear();
+    size_t most_specific_candidate_index = 0;
+    for_each_candidate_wildcard_path(path_view, [&](size_t wildcard_path_id) {
+        if (steps == step_budget)
+        {
+            match_status = MatchStatus::BUDGET_EXCEEDED;
+            return true;
+        }
+        steps++;
+        const uint32_t specificity_rank = wildcard_path_filters_[wildcard_path_id].specificity_rank;
+        if (specificity_rank != UINT32_MAX)
+        {
+            const uint64_t ranked_candidate = (uint64_t(specificity_rank) << 32) | wildcard_path_id;
+            if (!scratch.ranked_candidates.empty() &&
+                ranked_candidate < scratch.ranked_candidates[most_specific_candidate_index])
+            {
+                most_specific_candidate_index = scratch.ranked_candidates.size();
+            }
+            scratch.ranked_candidates.push_back(ranked_candidate);
+        }
+        else if (fits_wildcard_path_filter(wildcard_path_id, path_view))
+        {
+            scratch.unranked_candidates.push_back(wildcard_path_id);
+        }
+        return false;
+    });
+    std::sort(scratch.unranked_candidates.begin(),
+              scratch.unranked_candidates.end(),
+              [&](uint32_t first_slot, uint32_t second_slot) {
+                  return is_more_specific_wildcard_path(first_slot, second_slot);
+              });
+    // The most specific ranked candidate usually matches, so it waits at the back and the rest are only pre filtered
+    // and heaped once it did not, never sorted since the lookup stops at the first match
+    if (!scratch.ranked_candidates.empty())
+    {
+        std::swap(scratch.ranked_candidates[most_specific_candidate_index], scratch.ranked_candidates.back());
+    }
+    bool is_most_specific_taken = false;
+    bool is_ranked_heaped = false;
 
-    while (input_path_part_index < (int)input_path_parts.size() &&
-           wildcard_path_part_index < (int)wildcard_path_parts.size())
+    // Compare the most specific first, the first one that matches is the result
+    std::vector<uint32_t>::const_iterator unranked_iter = scratch.unranked_candidates.begin();
+    while (match_status == MatchStatus::NOT_FOUND &&
+           (!scratch.ranked_candidates.empty() || unranked_iter != scratch.unranked_candidates.end()))
     {
-        // This only happens either we have a double wildcard for many paths
-        // Or we have a single wildcard on the last path part as a standalone and it is allowed
-        if (strncmp(wildcard_path_parts[wildcard_path_part_index].c_str(),
-                    DOUBLE_WILDCARD_STRING,
-                    strlen(DOUBLE_WILDCARD_STRING)) == 0 ||
-            should_allow_last_wildcard_as_many_paths(
-                wildcard_path_parts[wildcard_path_part_index], wildcard_path_parts, wildcard_path_part_index))
+        if (is_most_specific_taken && !is_ranked_heaped)
         {
-            // Check double wildcard comparison
-            // If return true, this means we need to finish the loop
-            if (handle_double_wildcard_part_comparison(
-                    wildcard_path_parts, input_path_parts, wildcard_path_part_index, input_path_part_index))
+            scratch.ranked_candidates.erase(std::remove_if(scratch.ranked_candidates.begin(),
+                                                           scratch.ranked_candidates.end(),
+                                                           [&](uint64_t ranked_candidate) {
+                                                               return !fits_wildcard_path_filter(
+                                                                   uint32_t(ranked_candidate), path_view);
+                                                           }),
+                                            scratch.ranked_candidates.end());
+            std::make_heap(
+                scratch.ranked_candidates.begin(), scratch.ranked_candidates.end(), std::greater<uint64_t>());
+            is_ranked_heaped = true;
+            continue;
+        }
+        size_t wildcard_path_id;
+        bool is_pre_filtered = true;
+        if (unranked_iter == scratch.unranked_candidates.end() ||
+            (!scratch.ranked_candidates.empty() &&
+             is_more_specific_wildcard_path(
+                 uint32_t(is_ranked_heaped ? scratch.ranked_candidates.front() : scratch.ranked_candidates.back()),
+                 *unranked_iter)))
+        {
+            if (is_ranked_heaped)
             {
-                break;
+                std::pop_heap(
+                    scratch.ranked_candidates.begin(), scratch.ranked_candidates.end(), std::greater<uint64_t>());
+            }
+            else
+            {
+                is_most_specific_taken = true;
+                is_pre_filtered = false;
             }
+            wildcard_path_id = uint32_t(scratch.ranked_candidates.back());
+            scratch.ranked_candidates.pop_back();
         }
         else
         {
-            // Check normal wildcard comparison
-            // If return true, this means we need to finish the loop
-            if (handle_normal_part_comparison(
-                    wildcard_path_parts, input_path_parts, wildcard_path_part_index, input_path_part_index))
-            {
-                break;
-            }
+            wildcard_path_id = *unranked_iter++;
+        }
+        if (!is_pre_filtered && !fits_wildcard_path_filter(wildcard_path_id, path_view))
+        {
+            continue;
+        }
+        const WildcardPathFilter& filter = wildcard_path_filters_[wildcard_path_id];
+        const size_t candidate_steps = filter.fixed_steps + size_t(filter.steps_per_part) * input_parts_count;
+        if (candidate_steps > step_budget - steps)
+        {
+            match_status = MatchStatus::BUDGET_EXCEEDED;
+            break;
+        }
+        steps += candidate_steps;
+        compared_wildcard_paths++;
+        if (compare_validated_wildcard_paths(path_view.get_parts(), get_compiled_wildcard_path(wildcard_path_id)))
+        {
+            match_slot = wildcard_path_id;
+            match_status = MatchStatus::FOUND;
         }
     }
 
-    // Make the final decision whether we found a match or not
-    return decide_if_match_is_found(
-        wildcard_path_parts, input_path_parts, wildcard_path_part_index, input_path_part_index);
+    if (match_status == MatchStatus::BUDGET_EXCEEDED)
+    {
+        OCTO_WILDCARD_TRACE(budget_exceeded, path_view.get_input().data(), path_view.get_input().size(), steps);
+    }
+    OCTO_WILDCARD_TRACE(match_done,
+                        int(match_status),
+                        match_status == MatchStatus::FOUND ? (long)to_wildcard_path_id(match_slot) : -1L,
+                        steps,
+                        compared_wildcard_paths);
+    return match_status;
 }
 
-bool WildcardPathMatcher::handle_double_wildcard_part_comparison(const std::vector<std::string>& wildcard_path_parts,
-                                                                   const std::vector<std::string>& input_path_parts,
-                                                                   int& wildcard_path_part_index,
-                                                                   int& input_path_part_index) const
+bool WildcardPathMatcher::is_match_status_matched(MatchStatus match_status) const
 {
-    // Loop until we find the last ** in a row, just to avoid double searching
-    while (wildcard_path_part_index < (int)wildcard_path_parts.size() &&
-           strncmp(wildcard_path_parts[wildcard_path_part_index].c_str(),
-                   DOUBLE_WILDCARD_STRING,
-                   strlen(DOUBLE_WILDCARD_STRING)) == 0)
+    return match_status == MatchStatus::FOUND ||
+           (match_status == MatchStatus::BUDGET_EXCEEDED && match_on_budget_exceeded_);
+}
+
+std::optional<size_t> WildcardPathMatcher::get_most_specific_wildcard_match_id(std::string_view input) const
+{
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_most_specific_wildcard_match_id(path_view);
+}
+
+std::optional<size_t> WildcardPathMatcher::get_most_specific_wildcard_match_id(const PathView& path_view) const
+{
+    size_t match_slot;
+    size_t steps;
+    if (find_most_specific_wildcard_match(get_matching_path_view(path_view), match_slot, steps) == MatchStatus::FOUND)
     {
-        wildcard_path_part_index++;
+        return to_wildcard_path_id(match_slot);
     }
 
-    // If this is the last part, this means we found a match since it ends with only **
-    if (wildcard_path_part_index == (int)wildcard_path_parts.size())
+    return std::nullopt;
+}
+
+std::optional<std::string_view> WildcardPathMatcher::get_most_specific_wildcard_match_view(std::string_view input) const
+{
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_most_specific_wildcard_match_view(path_view);
+}
+
+std::optional<std::string_view>
+WildcardPathMatcher::get_most_specific_wildcard_match_view(const PathView& path_view) const
+{
+    size_t match_slot;
+    size_t steps;
+    if (find_most_specific_wildcard_match(get_matching_path_view(path_view), match_slot, steps) == MatchStatus::FOUND)
     {
-        // Move the index to the end since it fits everything and finish here
-        input_path_part_index = input_path_parts.size();
-        return true;
+        return get_compiled_wildcard_path(match_slot).path;
     }
 
-    // Start collecting all the wildcard parts until the next **
-    // This will be the infix parts we will check
-    std::vector<std::string> wildcard_infix_parts;
-    while (wildcard_path_part_index < (int)wildcard_path_parts.size() &&
-           strncmp(wildcard_path_parts[wildcard_path_part_index].c_str(),
-                   DOUBLE_WILDCARD_STRING,
-                   strlen(DOUBLE_WILDCARD_STRING)) != 0)
-    {
-        wildcard_infix_parts.push_back(wildcard_path_parts[wildcard_path_part_index]);
-        wildcard_path_part_index++;
+    return std::nullopt;
+}
+
+WildcardPathMatcher::MatchResult
+WildcardPathMatcher::get_most_specific_wildcard_match_result(std::string_view input) const
+{
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_most_specific_wildcard_match_result(path_view);
+}
+
+WildcardPathMatcher::MatchResult
+WildcardPathMatcher::get_most_specific_wildcard_match_result(const PathView& path_view) const
+{
+    MatchResult match_result;
+    size_t match_slot = 0;
+    match_result.status =
+        find_most_specific_wildcard_match(get_matching_path_view(path_view), match_slot, match_result.steps);
+    match_result.wildcard_path_id = match_result.status == MatchStatus::FOUND ? to_wildcard_path_id(match_slot) : 0;
+    return match_result;
+}
+
+template <typename MatchVisitor>
+void WildcardPathMatcher::visit_batch_wildcard_matches(const std::vector<std::string>& inputs,
+                                                       MatchVisitor&& match_visitor) const
+{
+    MatchScratch& scratch = get_thread_match_scratch();
+    if (scratch.leading_states.size() < get_wildcard_path_slots_count())
+    {
+        scratch.leading_states.resize(get_wildcard_path_slots_count(), LeadingState{0, 0, false});
     }
 
-    // Check if we can find all those parts within the input somewhere
-    // If we found it somewhere, that means that the infix is good for us
-    // We can move to the found index on the input and continue from there
-    int current_infix_index = 0;
-    int current_path_part_index = input_path_part_index;
-    while (current_path_part_index != (int)input_path_parts.size() &&
-           current_infix_index != (int)wildcard_infix_parts.size())
+    for (size_t input_index = 0; input_index < inputs.size(); input_index++)
     {
-        if (compare_validated_wildcard_strings(wildcard_infix_parts[current_infix_index],
-                                               input_path_parts[current_path_part_index]))
+        // Split into the other path view, so the previous input is still at hand
+        PathView& path_view = scratch.batch_path_views[input_index % 2];
+        path_view.assign(
+            inputs[input_index], folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+        const std::vector<std::string_view>& input_path_parts = path_view.get_parts();
+        const uint64_t input_serial = ++scratch.input_serial;
+
+        // The leading parts shared with the previous input keep their serial, the rest change with this input
+        size_t shared_parts = 0;
+        if (input_index > 0)
         {
-            current_infix_index++;
+            const std::vector<std::string_view>& previous_parts =
+                scratch.batch_path_views[(input_index + 1) % 2].get_parts();
+            while (shared_parts < input_path_parts.size() && shared_parts < previous_parts.size() &&
+                   input_path_parts[shared_parts] == previous_parts[shared_parts])
+            {
+                shared_parts++;
+            }
         }
-        else
+        if (scratch.stable_part_serials.size() < input_path_parts.size())
         {
-            current_path_part_index -= current_infix_index;
-            current_infix_index = 0;
+            scratch.stable_part_serials.resize(input_path_parts.size());
         }
-        current_path_part_index++;
-    }
-    // We found the infix
-    if (current_infix_index == (int)wildcard_infix_parts.size())
-    {
-        input_path_part_index = current_path_part_index;
-    }
-    // We did not find the infix, we can stop here
-    // We also move the wildcard index back since we did not find
-    else
-    {
-        wildcard_path_part_index -= wildcard_infix_parts.size();
-        return true;
-    }
-    // If this is the last part, this means we might have found a match
-    // Check the last parts to validate it
-    // Either we have ** or * and allowed in the end
-    if (wildcard_path_part_index == (int)wildcard_path_parts.size() &&
-        (strncmp(wildcard_path_parts[wildcard_path_part_index - 1].c_str(),
-                 DOUBLE_WILDCARD_STRING,
-                 strlen(DOUBLE_WILDCARD_STRING)) == 0 ||
-         should_allow_last_wildcard_as_many_paths(
-             wildcard_path_parts[wildcard_path_part_index - 1], wildcard_path_parts, wildcard_path_part_index - 1)))
-    {
-        // Move the index to the end since it fits everything and finish here
-        input_path_part_index = input_path_parts.size();
-        return true;
+        std::fill(scratch.stable_part_serials.begin() + shared_parts,
+                  scratch.stable_part_serials.begin() + input_path_parts.size(),
+                  input_serial);
+
+        size_t match_slot = 0;
+        size_t steps;
+        const MatchStatus input_match_status = visit_candidate_wildcard_paths(
+            path_view, match_slot, steps, [&](size_t wildcard_path_id, MatchStatus& match_status) {
+                // Count the leading parts that did not change since the state was saved, up to the part it failed at
+                LeadingState& leading_state = scratch.leading_states[wildcard_path_id];
+                size_t stable_parts = 0;
+                while (stable_parts <= leading_state.depth && stable_parts < input_path_parts.size() &&
+                       scratch.stable_part_serials[stable_parts] <= leading_state.input_serial)
+                {
+                    stable_parts++;
+                }
+                if (leading_state.failed && stable_parts > leading_state.depth)
+                {
+                    return false;
+                }
+
+                // Compare the leading segments one to one from where they are no longer known to match
+                const CompiledWildcardPath wildcard_path = get_compiled_wildcard_path(wildcard_path_id);
+                size_t part_index = std::min<size_t>(stable_parts, leading_state.depth);
+                while (part_index < input_path_parts.size() && part_index < wildcard_path.segments_count &&
+                       !wildcard_path.segments[part_index].is_double_wildcard &&
+                       !should_allow_last_wildcard_as_many_paths(wildcard_path, part_index))
+                {
+                    if (!compare_validated_wildcard_strings(
+                            wildcard_path, wildcard_path.segments[part_index], input_path_parts[part_index]))
+                    {
+                        // A leading segment that does not match its part fails the whole wildcard path
+                        leading_state = LeadingState{input_serial, (uint32_t)part_index, true};
+                        return false;
+                    }
+                    part_index++;
+                }
+                leading_state = LeadingState{input_serial, (uint32_t)part_index, false};
+
+                if (!compare_validated_wildcard_paths(
+                        input_path_parts, wildcard_path, (int)part_index, (int)part_index))
+                {
+                    return false;
+                }
+                match_status = MatchStatus::FOUND;
+                return true;
+            });
+        match_visitor(input_index, input_match_status, match_slot, steps);
     }
-    // Or the last part can be compared to all the suffix exactly
-    // In the infix part, we only search somewhere in the parts for a match
-    // Here we must assert that the last part, the suffix is equal completely
-    else if (wildcard_path_part_index == (int)wildcard_path_parts.size())
-    {
-        // Collect last suffix
-        std::vector<std::string> wildcard_postfix_parts;
-        int wildcard_path_postfix_index = wildcard_path_parts.size() - 1;
-        while (wildcard_path_postfix_index >= 0 && strncmp(wildcard_path_parts[wildcard_path_postfix_index].c_str(),
-                                                           DOUBLE_WILDCARD_STRING,
-                                                           strlen(DOUBLE_WILDCARD_STRING)) != 0)
-        {
-            wildcard_postfix_parts.insert(wildcard_postfix_parts.begin(),
-                                          wildcard_path_parts[wildcard_path_postfix_index]);
-            wildcard_path_postfix_index--;
-        }
-        wildcard_path_postfix_index = 0;
-        int input_path_postfix_index = input_path_parts.size() - wildcard_postfix_parts.size();
-        // Check if the last part fits the remainder of the input
-        while (input_path_postfix_index < (int)input_path_parts.size() &&
-               wildcard_path_postfix_index < (int)wildcard_postfix_parts.size())
-        {
-            if (compare_validated_wildcard_strings(wildcard_postfix_parts[wildcard_path_postfix_index],
-                                                   input_path_parts[input_path_postfix_index]))
+}
+
+void WildcardPathMatcher::get_batch_wildcard_match_ids(const std::vector<std::string>& inputs,
+                                                       std::vector<std::optional<size_t>>& match_ids) const
+{
+    match_ids.assign(inputs.size(), std::nullopt);
+    visit_batch_wildcard_matches(
+        inputs, [&](size_t input_index, MatchStatus match_status, size_t match_slot, size_t) {
+            if (match_status == MatchStatus::FOUND)
             {
-                input_path_postfix_index++;
-                wildcard_path_postfix_index++;
+                match_ids[input_index] = match_slot;
             }
-            else
+        });
+
+    if (!removed_wildcard_path_slots_.empty())
+    {
+        for (std::vector<std::optional<size_t>>::iterator match_iter = match_ids.begin(); match_iter != match_ids.end();
+             ++match_iter)
+        {
+            if (*match_iter)
             {
-                break;
+                *match_iter = to_wildcard_path_id(**match_iter);
             }
         }
-        // If we reached the end on both we are good
-        if (input_path_postfix_index == (int)input_path_parts.size() &&
-            wildcard_path_postfix_index == (int)wildcard_postfix_parts.size())
-        {
-            input_path_part_index = input_path_parts.size();
-        }
     }
+}
 
-    return false;
+void WildcardPathMatcher::get_batch_wildcard_match_results(const std::vector<std::string>& inputs,
+                                                           std::vector<MatchResult>& match_results) const
+{
+    match_results.resize(inputs.size());
+    visit_batch_wildcard_matches(
+        inputs, [&](size_t input_index, MatchStatus match_status, size_t match_slot, size_t steps) {
+            MatchResult& match_result = match_results[input_index];
+            match_result.status = match_status;
+            match_result.wildcard_path_id = match_status == MatchStatus::FOUND ? to_wildcard_path_id(match_slot) : 0;
+            match_result.steps = steps;
+        });
 }
 
-bool WildcardPathMatcher::handle_normal_part_comparison(const std::vector<std::string>& wildcard_path_parts,
-                                                          const std::vector<std::string>& input_path_parts,
-                                                          int& wildcard_path_part_index,
-                                                          int& input_path_part_index) const
+WildcardPathMatcher::MatchStatus
+WildcardPathMatcher::get_wildcard_match_ids_by_group(std::string_view input,
+                                                     const std::vector<size_t>& group_ends,
+                                                     std::vector<std::optional<size_t>>& match_ids) const
 {
-    if (!compare_validated_wildcard_strings(wildcard_path_parts[wildcard_path_part_index],
-                                            input_path_parts[input_path_part_index]))
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_wildcard_match_ids_by_group(path_view, group_ends, match_ids);
+}
+
+WildcardPathMatcher::MatchStatus
+WildcardPathMatcher::get_wildcard_match_ids_by_group(const PathView& path_view,
+                                                     const std::vector<size_t>& group_ends,
+                                                     std::vector<std::optional<size_t>>& match_ids) const
+{
+    const PathView& matching_path_view = get_matching_path_view(path_view);
+    match_ids.assign(group_ends.size(), std::nullopt);
+    size_t unmatched_groups = group_ends.size();
+    if (unmatched_groups == 0)
     {
-        // We did not find a match, this means we can stop here and continue to the next wildcard path
-        return true;
+        return MatchStatus::NOT_FOUND;
     }
-    else
+
+    // The groups end at ids, which are turned to slots when wildcard paths were removed
+    const std::vector<size_t>* group_end_slots = &group_ends;
+    if (!removed_wildcard_path_slots_.empty())
     {
-        // Promote both the indices since we found a match within the single wildcard
-        input_path_part_index++;
-        wildcard_path_part_index++;
+        std::vector<size_t>& removed_group_end_slots = get_thread_match_scratch().group_end_slots;
+        removed_group_end_slots.clear();
+        for (std::vector<size_t>::const_iterator group_end_iter = group_ends.begin();
+             group_end_iter != group_ends.end();
+             ++group_end_iter)
+        {
+            removed_group_end_slots.push_back(*group_end_iter < get_wildcard_paths_count()
+                                                  ? to_wildcard_path_slot(*group_end_iter)
+                                                  : get_wildcard_path_slots_count());
+        }
+        group_end_slots = &removed_group_end_slots;
     }
 
-    return false;
-}
+    // The candidates come in ascending slots, so the group of the current candidate only moves forward
+    // A group is done at its first match, and the walk stops once every group is done
+    size_t group_index = 0;
+    size_t match_slot = 0;
+    size_t steps;
+    const MatchStatus groups_match_status = visit_candidate_wildcard_paths(
+        matching_path_view, match_slot, steps, [&](size_t wildcard_path_id, MatchStatus& match_status) {
+            while (wildcard_path_id >= (*group_end_slots)[group_index])
+            {
+                if (++group_index == group_end_slots->size())
+                {
+                    return true;
+                }
+            }
+            if (match_ids[group_index] ||
+                !compare_validated_wildcard_paths(matching_path_view.get_parts(),
+                                                  get_compiled_wildcard_path(wildcard_path_id)))
+            {
+                return false;
+            }
+            match_ids[group_index] = wildcard_path_id;
+            match_status = MatchStatus::FOUND;
+            return --unmatched_groups == 0;
+        });
 
-bool WildcardPathMatcher::decide_if_match_is_found(const std::vector<std::string>& wildcard_path_parts,
-                                                     const std::vector<std::string>& input_path_parts,
-                                                     int& wildcard_path_part_index,
-                                                     int& input_path_part_index) const
-{
-    // Make sure to handle finishing ** if we reached the end of the input
-    while (wildcard_path_part_index < (int)wildcard_path_parts.size() &&
-           strncmp(wildcard_path_parts[wildcard_path_part_index].c_str(),
-                   DOUBLE_WILDCARD_STRING,
-                   strlen(DOUBLE_WILDCARD_STRING)) == 0)
+    if (!removed_wildcard_path_slots_.empty())
     {
-        wildcard_path_part_index++;
+        for (std::vector<std::optional<size_t>>::iterator match_iter = match_ids.begin(); match_iter != match_ids.end();
+             ++match_iter)
+        {
+            if (*match_iter)
+            {
+                *match_iter = to_wildcard_path_id(**match_iter);
+            }
+        }
     }
 
-    // If we reached the end of the input and wildcard, this means we properly found a match
-    if ((wildcard_path_part_index == (int)wildcard_path_parts.size() &&
-         input_path_part_index == (int)input_path_parts.size()) ||
-        (input_path_part_index == (int)input_path_parts.size() &&
-         wildcard_path_part_index == (int)wildcard_path_parts.size() - 1 &&
-         strncmp(wildcard_path_parts[wildcard_path_part_index].c_str(),
-                 SINGLE_WILDCARD_STRING,
-                 strlen(SINGLE_WILDCARD_STRING)) == 0 &&
-         allow_last_wildcard_as_many_paths_))
-    {
-        return true;
-    }
-    return false;
+    return groups_match_status;
 }
 
-bool WildcardPathMatcher::should_allow_last_wildcard_as_many_paths(
-    const std::string& wildcard_path_part,
-    const std::vector<std::string>& wildcard_path_parts,
-    size_t wildcard_path_part_index) const
+PathView WildcardPathMatcher::create_path_view(std::string_view input) const
 {
-    return allow_last_wildcard_as_many_paths_ &&
-           (wildcard_path_part[wildcard_path_part.size() - 1] == SINGLE_WILDCARD_CHAR) &&
-           (wildcard_path_part_index + 1) == wildcard_path_parts.size();
+    PathView path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return path_view;
 }
 
-bool WildcardPathMatcher::get_allow_last_wildcard_as_many_paths() const
+bool WildcardPathMatcher::has_match(std::string_view input) const
 {
-    return allow_last_wildcard_as_many_paths_;
+    // Split the input on the thread scratch path view to avoid allocating per lookup
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    size_t match_slot;
+    size_t steps;
+    return is_match_status_matched(find_wildcard_match(path_view, match_slot, steps));
 }
 
-void WildcardPathMatcher::set_allow_last_wildcard_as_many_paths(bool allow_last_wildcard_as_many_paths)
+bool WildcardPathMatcher::has_match(const PathView& path_view) const
 {
-    allow_last_wildcard_as_many_paths_ = allow_last_wildcard_as_many_paths;
+    size_t match_slot;
+    size_t steps;
+    return is_match_status_matched(find_wildcard_match(get_matching_path_view(path_view), match_slot, steps));
 }
 
-char WildcardPathMatcher::get_folder_seperator() const
+bool WildcardPathMatcher::can_match_under_directory(std::string_view directory) const
 {
-    return folder_seperator_;
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(directory, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return can_match_under_directory(path_view);
 }
 
-void WildcardPathMatcher::set_folder_seperator(char folder_seperator)
+bool WildcardPathMatcher::can_match_under_directory(const PathView& directory) const
 {
-    folder_seperator_ = folder_seperator;
-}
+    const PathView& matching_directory = get_matching_path_view(directory);
+    const std::vector<std::string_view>& directory_parts = matching_directory.get_parts();
+    OCTO_WILDCARD_TRACE(match_start, matching_directory.get_input().data(), matching_directory.get_input().size());
 
-bool WildcardPathMatcher::validate_wildcard_path(const std::string& wildcard_path) const
-{
-    std::vector<std::string> path_parts = split_string_by_delimiter(wildcard_path, folder_seperator_);
-    // Check the parts of the wildcard path to see if they are logical or not
-    for (std::vector<std::string>::iterator part_iter = path_parts.begin(); part_iter != path_parts.end(); ++part_iter)
+    // Every wildcard path is charged the worst case of its segments, past the budget the directory can not be ruled out
+    const size_t step_budget = match_step_budget_ != 0 ? match_step_budget_ : SIZE_MAX;
+    size_t steps = 0;
+    size_t compared_wildcard_paths = 0;
+    for (size_t wildcard_path_id = 0; wildcard_path_id < get_wildcard_path_slots_count(); wildcard_path_id++)
     {
-        for (size_t i = 0; i < part_iter->size(); i++)
+        if (is_removed_wildcard_path_slot(wildcard_path_id))
         {
-            char c = (*part_iter)[i];
-            if (c == SINGLE_WILDCARD_CHAR)
+            continue;
+        }
+        const size_t candidate_steps = 1 + size_t(wildcard_path_filters_[wildcard_path_id].fixed_steps);
+        if (candidate_steps > step_budget - steps)
+        {
+            OCTO_WILDCARD_TRACE(
+                budget_exceeded, matching_directory.get_input().data(), matching_directory.get_input().size(), steps);
+            OCTO_WILDCARD_TRACE(match_done, int(MatchStatus::BUDGET_EXCEEDED), -1L, steps, compared_wildcard_paths);
+            return true;
+        }
+        steps += candidate_steps;
+        compared_wildcard_paths++;
+        CompiledWildcardPath wildcard_path = get_compiled_wildcard_path(wildcard_path_id);
+        // The segments before the first double wildcard are compared one to one from the start,
+        // so the directory has to fit them for as long as it goes
+        size_t wildcard_path_part_index = 0;
+        size_t directory_part_index = 0;
+        for (;;)
+        {
+            if (wildcard_path_part_index == wildcard_path.segments_count)
             {
-                if ((i + 1) < part_iter->size() && (*part_iter)[i + 1] == SINGLE_WILDCARD_CHAR)
-                {
-                    // Found **, check that they are the only one
-                    if (part_iter->size() == strlen(DOUBLE_WILDCARD_STRING))
-                    {
-                        // We good
-                        break;
-                    }
-                    else
-                    {
-                        // We bad
-                        return false;
-                    }
-                }
+                // Nothing is left for the paths under the directory
+                break;
+            }
+            if (directory_part_index == directory_parts.size() ||
+                wildcard_path.segments[wildcard_path_part_index].is_double_wildcard ||
+                should_allow_last_wildcard_as_many_paths(wildcard_path, wildcard_path_part_index))
+            {
+                // Whatever is left can still be matched by the paths under the directory
+                OCTO_WILDCARD_TRACE(match_done,
+                                    int(MatchStatus::FOUND),
+                                    (long)to_wildcard_path_id(wildcard_path_id),
+                                    steps,
+                                    compared_wildcard_paths);
+                return true;
+            }
+            if (!compare_validated_wildcard_strings(wildcard_path,
+                                                    wildcard_path.segments[wildcard_path_part_index],
+                                                    directory_parts[directory_part_index]))
+            {
+                break;
             }
+            wildcard_path_part_index++;
+            directory_part_index++;
         }
     }
 
-    return true;
+    OCTO_WILDCARD_TRACE(match_done, int(MatchStatus::NOT_FOUND), -1L, steps, compared_wildcard_paths);
+    return false;
 }
 
-void WildcardPathMatcher::add_wildcard_path(const std::string& wildcard_path)
+std::string WildcardPathMatcher::get_wildcard_match(std::string_view input) const
 {
-    if (!validate_wildcard_path(wildcard_path))
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_wildcard_match(path_view);
+}
+
+std::string WildcardPathMatcher::get_wildcard_match(const PathView& path_view) const
+{
+    size_t match_slot;
+    size_t steps;
+    if (find_wildcard_match(get_matching_path_view(path_view), match_slot, steps) == MatchStatus::FOUND)
     {
-        throw std::runtime_error(std::string("The path is invalid: [") + wildcard_path + "]");
+        return std::string(get_compiled_wildcard_path(match_slot).path);
     }
 
-    wildcard_paths_.push_back(wildcard_path);
+    return "";
 }
 
-void WildcardPathMatcher::add_wildcard_paths(const std::vector<std::string>& wildcard_paths)
+std::optional<size_t> WildcardPathMatcher::get_wildcard_match_id(std::string_view input) const
 {
-    // Validate all paths before adding them
-    for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end(); ++iter)
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_wildcard_match_id(path_view);
+}
+
+std::optional<size_t> WildcardPathMatcher::get_wildcard_match_id(const PathView& path_view) const
+{
+    size_t match_slot;
+    size_t steps;
+    if (find_wildcard_match(get_matching_path_view(path_view), match_slot, steps) == MatchStatus::FOUND)
     {
-        if (!validate_wildcard_path(*iter))
-        {
-            throw std::runtime_error(std::string("A path is invalid: [") + *iter + "]");
-        }
+        return to_wildcard_path_id(match_slot);
     }
 
-    // Add them only if they were all valid in the previous loop
-    for (std::vector<std::string>::const_iterator iter = wildcard_paths.begin(); iter != wildcard_paths.end(); ++iter)
+    return std::nullopt;
+}
+
+std::optional<size_t> WildcardPathMatcher::get_wildcard_match_captures(std::string_view input,
+                                                                       WildcardCapture* captures,
+                                                                       size_t captures_capacity,
+                                                                       size_t& captures_count) const
+{
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_wildcard_match_captures(path_view, captures, captures_capacity, captures_count);
+}
+
+std::optional<size_t> WildcardPathMatcher::get_wildcard_match_captures(const PathView& path_view,
+                                                                       WildcardCapture* captures,
+                                                                       size_t captures_capacity,
+                                                                       size_t& captures_count) const
+{
+    captures_count = 0;
+    const PathView& matching_path_view = get_matching_path_view(path_view);
+    size_t match_slot;
+    size_t steps;
+    if (find_wildcard_match(matching_path_view, match_slot, steps) != MatchStatus::FOUND)
     {
-        wildcard_paths_.push_back(*iter);
+        return std::nullopt;
     }
+
+    // Only the matching wildcard path is walked again, the lookup itself does not capture
+    CaptureBuffer capture_buffer = {captures, captures_capacity, 0};
+    capture_wildcard_path(matching_path_view.get_input(),
+                          matching_path_view.get_parts(),
+                          get_compiled_wildcard_path(match_slot),
+                          capture_buffer);
+    captures_count = capture_buffer.count;
+    return to_wildcard_path_id(match_slot);
 }
 
-void WildcardPathMatcher::clean_wildcard_paths()
+WildcardPathMatcher::MatchResult WildcardPathMatcher::get_wildcard_match_result(std::string_view input) const
 {
-    wildcard_paths_.clear();
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_wildcard_match_result(path_view);
 }
 
-std::vector<std::string> WildcardPathMatcher::get_wildcard_paths() const
+WildcardPathMatcher::MatchResult WildcardPathMatcher::get_wildcard_match_result(const PathView& path_view) const
 {
-    return wildcard_paths_;
+    MatchResult match_result;
+    size_t match_slot = 0;
+    match_result.status = find_wildcard_match(get_matching_path_view(path_view), match_slot, match_result.steps);
+    match_result.wildcard_path_id =
+        match_result.status == MatchStatus::FOUND ? to_wildcard_path_id(match_slot) : 0;
+    return match_result;
 }
 
-bool WildcardPathMatcher::has_match(const std::string& input) const
+std::optional<std::string_view> WildcardPathMatcher::get_wildcard_match_view(std::string_view input) const
 {
-    return get_wildcard_match(input) != "";
+    PathView& path_view = get_thread_match_scratch().path_view;
+    path_view.assign(input, folder_seperator_, input_folder_seperators_table_, normalize_input_paths_);
+    return get_wildcard_match_view(path_view);
 }
 
-std::string WildcardPathMatcher::get_wildcard_match(const std::string& input) const
+std::optional<std::string_view> WildcardPathMatcher::get_wildcard_match_view(const PathView& path_view) const
 {
-    // Split the input path to the base paths list
-    std::vector<std::string> input_path_parts = split_string_by_delimiter(input, folder_seperator_);
-
-    // Go over every writable path and see if we can find a fit
-    for (std::vector<std::string>::const_iterator wildcard_path_iter = wildcard_paths_.begin();
-         wildcard_path_iter != wildcard_paths_.end();
-         ++wildcard_path_iter)
+    size_t match_slot;
+    size_t steps;
+    if (find_wildcard_match(get_matching_path_view(path_view), match_slot, steps) == MatchStatus::FOUND)
     {
-        // Compare the parts with the current wildcard path
-        if (compare_validated_wildcard_paths(input_path_parts, *wildcard_path_iter))
-        {
-            return *wildcard_path_iter;
-        }
+        return get_compiled_wildcard_path(match_slot).path;
     }
 
-    return "";
+    return std::nullopt;
 }
-} // namespace octo::wildcardmatching
\ No newline at end of file
+} // namespace octo::wildcardmatching
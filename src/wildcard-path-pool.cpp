@@ -0,0 +1,221 @@
+/**
+ * @file wildcard-path-pool.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-pool.hpp"
+#include "tracepoints.hpp"
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
+#include <functional>
+
+namespace
+{
+/**
+ * @brief
+ * Key of a pool entry, the path view points into the compiled path string of the entry itself
+ */
+struct EntryKey
+{
+    std::string_view path;
+    char folder_seperator;
+
+    bool operator==(const EntryKey& other) const
+    {
+        return folder_seperator == other.folder_seperator && path == other.path;
+    }
+};
+
+struct EntryKeyHash
+{
+    size_t operator()(const EntryKey& key) const
+    {
+        return std::hash<std::string_view>()(key.path) ^ (size_t)(unsigned char)key.folder_seperator;
+    }
+};
+
+/**
+ * @brief
+ * Lookup table value of a pool entry, the raw pointer tells the entry apart from a newer entry of the same path
+ */
+struct EntryRef
+{
+    const octo::wildcardmatching::CompiledWildcardPath* compiled_path;
+    std::weak_ptr<const octo::wildcardmatching::CompiledWildcardPath> weak_compiled_path;
+};
+
+// Chunks start small so that small pools stay small, and double up to the largest chunk
+static constexpr size_t MIN_CHUNK_WILDCARD_PATHS = 16;
+static constexpr size_t MAX_CHUNK_WILDCARD_PATHS = 1024;
+static constexpr size_t CHUNK_BYTES_PER_WILDCARD_PATH = 64;
+static constexpr size_t CHUNK_SEGMENTS_PER_WILDCARD_PATH = 8;
+static constexpr size_t CHUNK_CARDS_PER_WILDCARD_PATH = 16;
+} // namespace
+
+namespace octo::wildcardmatching
+{
+struct WildcardPathPool::State
+{
+    std::mutex mutex;
+    std::unordered_map<EntryKey, EntryRef, EntryKeyHash> entries;
+    // The chunk new paths are packed into, it is kept alive only by the entries in it
+    std::weak_ptr<Chunk> current_chunk;
+    size_t next_chunk_wildcard_paths = MIN_CHUNK_WILDCARD_PATHS;
+    // Chunks are released without taking the mutex, the last reference to one may be dropped while it is held
+    std::atomic<size_t> chunks_count{0};
+    std::atomic<size_t> compiled_paths_bytes{0};
+};
+
+/**
+ * @brief
+ * Storage of many compiled paths, reserved ahead and only ever added to within the reserved memory
+ * Lookups read the paths without the mutex, adding a path within the reserved memory never moves the paths before it
+ */
+struct WildcardPathPool::Chunk
+{
+    std::weak_ptr<State> state;
+    WildcardPathStorage storage;
+    size_t bytes = 0;
+
+    ~Chunk()
+    {
+        std::shared_ptr<State> locked_state = state.lock();
+        if (locked_state)
+        {
+            locked_state->chunks_count--;
+            locked_state->compiled_paths_bytes -= bytes;
+        }
+    }
+};
+
+/**
+ * @brief
+ * A single compiled path, allocated together with its reference count and keeping its chunk alive
+ */
+struct WildcardPathPool::Entry
+{
+    std::weak_ptr<State> state;
+    std::shared_ptr<Chunk> chunk;
+    CompiledWildcardPath compiled_path;
+    char folder_seperator;
+
+    ~Entry()
+    {
+        std::shared_ptr<State> locked_state = state.lock();
+        if (locked_state)
+        {
+            std::lock_guard<std::mutex> lock(locked_state->mutex);
+            std::unordered_map<EntryKey, EntryRef, EntryKeyHash>::iterator released_iter =
+                locked_state->entries.find(EntryKey{compiled_path.path, folder_seperator});
+            if (released_iter != locked_state->entries.end() && released_iter->second.compiled_path == &compiled_path)
+            {
+                locked_state->entries.erase(released_iter);
+            }
+        }
+    }
+};
+
+WildcardPathPool::WildcardPathPool() : state_(std::make_shared<State>())
+{
+}
+
+WildcardPathPool::~WildcardPathPool()
+{
+}
+
+std::shared_ptr<const CompiledWildcardPath> WildcardPathPool::intern(std::string_view wildcard_path,
+                                                                    char folder_seperator)
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+
+    EntryKey key = {wildcard_path, folder_seperator};
+    std::unordered_map<EntryKey, EntryRef, EntryKeyHash>::iterator entry_iter = state_->entries.find(key);
+    if (entry_iter != state_->entries.end())
+    {
+        std::shared_ptr<const CompiledWildcardPath> compiled_path = entry_iter->second.weak_compiled_path.lock();
+        if (compiled_path)
+        {
+            OCTO_WILDCARD_TRACE(pool_hit, wildcard_path.data(), wildcard_path.size());
+            return compiled_path;
+        }
+        // The last reference is being released right now, its entry will not find itself in the table anymore
+        state_->entries.erase(entry_iter);
+    }
+
+    OCTO_WILDCARD_TRACE(pool_miss, wildcard_path.data(), wildcard_path.size());
+
+    std::shared_ptr<Chunk> chunk = state_->current_chunk.lock();
+    if (!chunk || chunk->storage.get_wildcard_paths_count() >= state_->next_chunk_wildcard_paths ||
+        !chunk->storage.fits_in_reserved(wildcard_path, folder_seperator))
+    {
+        if (chunk)
+        {
+            state_->next_chunk_wildcard_paths =
+                std::min(state_->next_chunk_wildcard_paths * 2, MAX_CHUNK_WILDCARD_PATHS);
+        }
+        const size_t chunk_wildcard_paths = state_->next_chunk_wildcard_paths;
+        // A path larger than a whole chunk gets a chunk of its own size
+        const size_t segments_count = std::count(wildcard_path.begin(), wildcard_path.end(), folder_seperator) + 1;
+        const size_t cards_count = segments_count + std::count(wildcard_path.begin(), wildcard_path.end(), '*');
+        chunk = std::make_shared<Chunk>();
+        chunk->state = state_;
+        chunk->storage.reserve(chunk_wildcard_paths,
+                               std::max(chunk_wildcard_paths * CHUNK_BYTES_PER_WILDCARD_PATH, wildcard_path.size()),
+                               std::max(chunk_wildcard_paths * CHUNK_SEGMENTS_PER_WILDCARD_PATH, segments_count),
+                               std::max(chunk_wildcard_paths * CHUNK_CARDS_PER_WILDCARD_PATH, cards_count));
+        chunk->bytes = chunk->storage.get_memory_usage().total_bytes;
+        state_->chunks_count++;
+        state_->compiled_paths_bytes += chunk->bytes;
+        state_->current_chunk = chunk;
+    }
+
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+    entry->state = state_;
+    entry->chunk = chunk;
+    entry->compiled_path =
+        chunk->storage.get_wildcard_path(chunk->storage.add_wildcard_path(wildcard_path, folder_seperator));
+    entry->folder_seperator = folder_seperator;
+
+    // The returned view shares the reference count of its entry
+    std::shared_ptr<const CompiledWildcardPath> compiled_path(entry, &entry->compiled_path);
+    state_->entries.emplace(EntryKey{entry->compiled_path.path, folder_seperator},
+                            EntryRef{compiled_path.get(), compiled_path});
+
+    return compiled_path;
+}
+
+size_t WildcardPathPool::get_entries_count() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->entries.size();
+}
+
+WildcardPathPool::MemoryUsage WildcardPathPool::get_memory_usage() const
+{
+    std::lock_guard<std::mutex> lock(state_->mutex);
+
+    MemoryUsage memory_usage;
+    memory_usage.entries = state_->entries.size();
+    memory_usage.references = 0;
+    for (std::unordered_map<EntryKey, EntryRef, EntryKeyHash>::const_iterator entry_iter = state_->entries.begin();
+         entry_iter != state_->entries.end();
+         ++entry_iter)
+    {
+        memory_usage.references += entry_iter->second.weak_compiled_path.use_count();
+    }
+    memory_usage.chunks = state_->chunks_count;
+    memory_usage.compiled_paths_bytes = state_->compiled_paths_bytes;
+    memory_usage.index_bytes =
+        sizeof(State) + state_->entries.bucket_count() * sizeof(void*) +
+        state_->entries.size() * (sizeof(EntryKey) + sizeof(EntryRef) + sizeof(Entry) + 4 * sizeof(void*));
+    return memory_usage;
+}
+} // namespace octo::wildcardmatching
@@ -0,0 +1,456 @@
+/**
+ * @file wildcard-path-server.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-server.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-protocol.hpp"
+#include "tracepoints.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+namespace
+{
+// Bytes read from a connection at a time
+static constexpr size_t READ_SIZE = 64 * 1024;
+// A connection is not read further in a poll once this much of it is waiting to be answered, so a single busy
+// connection does not hold the batch back
+static constexpr size_t MAX_PENDING_INPUT_SIZE = 1024 * 1024;
+// A connection that does not read its responses is not read either until they drain
+static constexpr size_t MAX_PENDING_OUTPUT_SIZE = 1024 * 1024;
+
+#ifdef MSG_NOSIGNAL
+static constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static constexpr int SEND_FLAGS = 0;
+#endif
+
+/**
+ * @brief
+ * Sets the descriptor to close on exec and to not block, a peer that is gone must not raise SIGPIPE either
+ */
+bool set_socket_flags(int fd)
+{
+#ifdef SO_NOSIGPIPE
+    int no_sigpipe = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+    return fcntl(fd, F_SETFD, FD_CLOEXEC) == 0 && fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) == 0;
+}
+
+void append_response(std::vector<char>& output_buffer,
+                     octo::wildcardmatching::protocol::ResponseStatus response_status,
+                     const void* payload,
+                     size_t payload_size)
+{
+    const uint32_t header_payload_size = (uint32_t)payload_size;
+    const uint8_t header_response_status = (uint8_t)response_status;
+    const size_t response_offset = output_buffer.size();
+    output_buffer.resize(response_offset + octo::wildcardmatching::protocol::RESPONSE_HEADER_SIZE + payload_size);
+    memcpy(output_buffer.data() + response_offset, &header_payload_size, sizeof(header_payload_size));
+    memcpy(output_buffer.data() + response_offset + sizeof(header_payload_size),
+           &header_response_status,
+           sizeof(header_response_status));
+    if (payload_size > 0)
+    {
+        memcpy(output_buffer.data() + response_offset + octo::wildcardmatching::protocol::RESPONSE_HEADER_SIZE,
+               payload,
+               payload_size);
+    }
+}
+} // namespace
+
+namespace octo::wildcardmatching
+{
+WildcardPathServer::WildcardPathServer(std::string socket_path, std::shared_ptr<const WildcardPathMatcher> matcher)
+    : socket_path_(std::move(socket_path)), matcher_(std::move(matcher))
+{
+    requests_count_ = 0;
+    batches_count_ = 0;
+    socket_device_ = 0;
+    socket_inode_ = 0;
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path_.empty() || socket_path_.size() >= sizeof(address.sun_path))
+    {
+        throw std::runtime_error(std::string("Invalid wildcard path server socket path: [") + socket_path_ + "]");
+    }
+    memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size());
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0)
+    {
+        throw std::runtime_error(std::string("Failed to create the server socket: [") + strerror(errno) + "]");
+    }
+    int bind_result = bind(listen_fd_, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address));
+    if (bind_result < 0 && errno == EADDRINUSE)
+    {
+        // The socket file may be left by a server that is gone, which nothing accepts on anymore, anything else at
+        // the path is never removed
+        struct stat path_stat;
+        bool is_stale_socket = lstat(socket_path_.c_str(), &path_stat) == 0 && S_ISSOCK(path_stat.st_mode);
+        if (is_stale_socket)
+        {
+            int probe_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (probe_fd >= 0)
+            {
+                is_stale_socket =
+                    connect(probe_fd, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address)) != 0;
+                close(probe_fd);
+            }
+        }
+        if (is_stale_socket)
+        {
+            unlink(socket_path_.c_str());
+            bind_result = bind(listen_fd_, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address));
+        }
+        else
+        {
+            errno = EADDRINUSE;
+        }
+    }
+    if (bind_result < 0 || listen(listen_fd_, SOMAXCONN) < 0 || !set_socket_flags(listen_fd_))
+    {
+        const int listen_errno = errno;
+        close(listen_fd_);
+        throw std::runtime_error(std::string("Failed to listen on the server socket: [") + socket_path_ + "] [" +
+                                 strerror(listen_errno) + "]");
+    }
+
+    // The socket file is removed on destruction only if it is still the one bound here
+    struct stat socket_stat;
+    if (lstat(socket_path_.c_str(), &socket_stat) == 0)
+    {
+        socket_device_ = (uint64_t)socket_stat.st_dev;
+        socket_inode_ = (uint64_t)socket_stat.st_ino;
+    }
+}
+
+WildcardPathServer::~WildcardPathServer()
+{
+    for (std::vector<Connection>::iterator connection_iter = connections_.begin();
+         connection_iter != connections_.end();
+         ++connection_iter)
+    {
+        close(connection_iter->fd);
+    }
+    close(listen_fd_);
+    struct stat socket_stat;
+    if (lstat(socket_path_.c_str(), &socket_stat) == 0 && S_ISSOCK(socket_stat.st_mode) &&
+        (uint64_t)socket_stat.st_dev == socket_device_ && (uint64_t)socket_stat.st_ino == socket_inode_)
+    {
+        unlink(socket_path_.c_str());
+    }
+}
+
+void WildcardPathServer::accept_connections()
+{
+    for (;;)
+    {
+        int connection_fd = accept(listen_fd_, nullptr, nullptr);
+        if (connection_fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            // Nothing more to accept, or out of descriptors until some connections close
+            return;
+        }
+        if (!set_socket_flags(connection_fd))
+        {
+            close(connection_fd);
+            continue;
+        }
+        connections_.push_back(
+            Connection{connection_fd, std::vector<char>(), 0, 0, std::vector<char>(), 0, false, false});
+    }
+}
+
+void WildcardPathServer::read_connection(Connection& connection)
+{
+    // Keep only the requests that were not answered yet
+    if (connection.input_begin > 0)
+    {
+        std::copy(connection.input_buffer.begin() + connection.input_begin,
+                  connection.input_buffer.begin() + connection.input_end,
+                  connection.input_buffer.begin());
+        connection.input_end -= connection.input_begin;
+        connection.input_begin = 0;
+    }
+
+    while (connection.input_end < MAX_PENDING_INPUT_SIZE)
+    {
+        if (connection.input_buffer.size() < connection.input_end + READ_SIZE)
+        {
+            connection.input_buffer.resize(connection.input_end + READ_SIZE);
+        }
+        ssize_t read_size = recv(connection.fd, connection.input_buffer.data() + connection.input_end, READ_SIZE, 0);
+        if (read_size > 0)
+        {
+            connection.input_end += read_size;
+            continue;
+        }
+        if (read_size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (read_size == 0)
+        {
+            connection.is_input_closed = true;
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            connection.is_closed = true;
+        }
+        return;
+    }
+}
+
+void WildcardPathServer::write_connection(Connection& connection)
+{
+    while (connection.output_offset < connection.output_buffer.size())
+    {
+        ssize_t write_size = send(connection.fd,
+                                  connection.output_buffer.data() + connection.output_offset,
+                                  connection.output_buffer.size() - connection.output_offset,
+                                  SEND_FLAGS);
+        if (write_size > 0)
+        {
+            connection.output_offset += write_size;
+            continue;
+        }
+        if (write_size < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (write_size < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            connection.is_closed = true;
+        }
+        return;
+    }
+    connection.output_buffer.clear();
+    connection.output_offset = 0;
+}
+
+size_t WildcardPathServer::serve_batch()
+{
+    // Take all the complete requests of all the connections, in the order of every connection
+    batch_requests_.clear();
+    for (size_t connection_index = 0; connection_index < connections_.size(); connection_index++)
+    {
+        Connection& connection = connections_[connection_index];
+        while (!connection.is_closed && connection.input_end - connection.input_begin >= protocol::REQUEST_HEADER_SIZE)
+        {
+            uint32_t input_size;
+            uint8_t request_type;
+            memcpy(&input_size, connection.input_buffer.data() + connection.input_begin, sizeof(input_size));
+            memcpy(&request_type,
+                   connection.input_buffer.data() + connection.input_begin + sizeof(input_size),
+                   sizeof(request_type));
+            if (input_size > protocol::MAX_INPUT_SIZE)
+            {
+                connection.is_closed = true;
+                break;
+            }
+            if (connection.input_end - connection.input_begin < protocol::REQUEST_HEADER_SIZE + input_size)
+            {
+                break;
+            }
+            batch_requests_.push_back(BatchRequest{
+                connection_index, request_type, connection.input_begin + protocol::REQUEST_HEADER_SIZE, input_size, 0});
+            connection.input_begin += protocol::REQUEST_HEADER_SIZE + input_size;
+        }
+    }
+    if (batch_requests_.empty())
+    {
+        return 0;
+    }
+
+    // Sorted inputs share their leading parts with the previous ones, which the batch lookup does not compare again
+    batch_order_.resize(batch_requests_.size());
+    for (size_t request_index = 0; request_index < batch_requests_.size(); request_index++)
+    {
+        batch_order_[request_index] = request_index;
+    }
+    auto get_request_input = [this](const BatchRequest& request) {
+        return std::string_view(connections_[request.connection_index].input_buffer.data() + request.input_offset,
+                                request.input_size);
+    };
+    std::sort(batch_order_.begin(), batch_order_.end(), [&](size_t first_index, size_t second_index) {
+        return get_request_input(batch_requests_[first_index]) < get_request_input(batch_requests_[second_index]);
+    });
+    sorted_batch_inputs_.resize(batch_requests_.size());
+    for (size_t sorted_index = 0; sorted_index < batch_order_.size(); sorted_index++)
+    {
+        BatchRequest& request = batch_requests_[batch_order_[sorted_index]];
+        std::string_view input = get_request_input(request);
+        sorted_batch_inputs_[sorted_index].assign(input.data(), input.size());
+        request.sorted_index = sorted_index;
+    }
+
+    // The whole batch is answered by the same matcher, even if another one is published meanwhile
+    std::shared_ptr<const WildcardPathMatcher> matcher = get_matcher();
+    matcher->get_batch_wildcard_match_results(sorted_batch_inputs_, batch_match_results_);
+    for (std::vector<BatchRequest>::const_iterator request_iter = batch_requests_.begin();
+         request_iter != batch_requests_.end();
+         ++request_iter)
+    {
+        std::vector<char>& output_buffer = connections_[request_iter->connection_index].output_buffer;
+        const WildcardPathMatcher::MatchResult& match_result = batch_match_results_[request_iter->sorted_index];
+        const bool is_found = match_result.status == WildcardPathMatcher::MatchStatus::FOUND;
+        protocol::ResponseStatus response_status = protocol::ResponseStatus::NOT_FOUND;
+        if (is_found)
+        {
+            response_status = protocol::ResponseStatus::FOUND;
+        }
+        else if (match_result.status == WildcardPathMatcher::MatchStatus::BUDGET_EXCEEDED)
+        {
+            response_status = protocol::ResponseStatus::BUDGET_EXCEEDED;
+        }
+        switch ((protocol::RequestType)request_iter->request_type)
+        {
+        case protocol::RequestType::HAS_MATCH:
+            // An exceeded budget is answered the way the matcher decided for has_match
+            if (response_status == protocol::ResponseStatus::BUDGET_EXCEEDED && matcher->get_match_on_budget_exceeded())
+            {
+                response_status = protocol::ResponseStatus::FOUND;
+            }
+            append_response(output_buffer, response_status, nullptr, 0);
+            break;
+        case protocol::RequestType::GET_WILDCARD_MATCH_ID:
+        {
+            const uint64_t wildcard_path_id = match_result.wildcard_path_id;
+            append_response(output_buffer, response_status, &wildcard_path_id, is_found ? sizeof(wildcard_path_id) : 0);
+            break;
+        }
+        case protocol::RequestType::GET_WILDCARD_MATCH:
+        {
+            std::string_view wildcard_path =
+                is_found ? matcher->get_wildcard_path(match_result.wildcard_path_id) : std::string_view();
+            append_response(output_buffer, response_status, wildcard_path.data(), wildcard_path.size());
+            break;
+        }
+        default:
+            append_response(output_buffer, protocol::ResponseStatus::INVALID_REQUEST, nullptr, 0);
+            break;
+        }
+    }
+
+    OCTO_WILDCARD_TRACE(serve_batch, batch_requests_.size(), connections_.size());
+    requests_count_ += batch_requests_.size();
+    batches_count_++;
+    return batch_requests_.size();
+}
+
+size_t WildcardPathServer::poll(int timeout_ms)
+{
+    std::vector<struct pollfd> poll_fds(connections_.size() + 1);
+    poll_fds[0].fd = listen_fd_;
+    poll_fds[0].events = POLLIN;
+    poll_fds[0].revents = 0;
+    for (size_t connection_index = 0; connection_index < connections_.size(); connection_index++)
+    {
+        const Connection& connection = connections_[connection_index];
+        const size_t pending_output_size = connection.output_buffer.size() - connection.output_offset;
+        struct pollfd& poll_fd = poll_fds[connection_index + 1];
+        poll_fd.fd = connection.fd;
+        poll_fd.events = (!connection.is_input_closed && pending_output_size < MAX_PENDING_OUTPUT_SIZE ? POLLIN : 0) |
+                         (pending_output_size > 0 ? POLLOUT : 0);
+        poll_fd.revents = 0;
+    }
+    int ready = ::poll(poll_fds.data(), poll_fds.size(), timeout_ms);
+    if (ready < 0 && errno != EINTR)
+    {
+        throw std::runtime_error(std::string("Failed to poll the server socket: [") + strerror(errno) + "]");
+    }
+    if (ready <= 0)
+    {
+        return 0;
+    }
+
+    // Read everything that arrived on all the connections first, so it is answered as one batch
+    for (size_t connection_index = 0; connection_index < connections_.size(); connection_index++)
+    {
+        if (poll_fds[connection_index + 1].revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            read_connection(connections_[connection_index]);
+        }
+    }
+    if (poll_fds[0].revents & POLLIN)
+    {
+        accept_connections();
+    }
+    size_t answered_requests = serve_batch();
+
+    // Responses are sent right away, a connection is only waited on once its socket is full
+    for (std::vector<Connection>::iterator connection_iter = connections_.begin();
+         connection_iter != connections_.end();)
+    {
+        if (!connection_iter->is_closed && connection_iter->output_offset < connection_iter->output_buffer.size())
+        {
+            write_connection(*connection_iter);
+        }
+        if (connection_iter->is_closed ||
+            (connection_iter->is_input_closed && connection_iter->output_buffer.empty()))
+        {
+            close(connection_iter->fd);
+            connection_iter = connections_.erase(connection_iter);
+        }
+        else
+        {
+            ++connection_iter;
+        }
+    }
+
+    return answered_requests;
+}
+
+void WildcardPathServer::set_matcher(std::shared_ptr<const WildcardPathMatcher> matcher)
+{
+    std::atomic_store(&matcher_, std::move(matcher));
+}
+
+std::shared_ptr<const WildcardPathMatcher> WildcardPathServer::get_matcher() const
+{
+    return std::atomic_load(&matcher_);
+}
+
+const std::string& WildcardPathServer::get_socket_path() const
+{
+    return socket_path_;
+}
+
+size_t WildcardPathServer::get_connections_count() const
+{
+    return connections_.size();
+}
+
+size_t WildcardPathServer::get_requests_count() const
+{
+    return requests_count_;
+}
+
+size_t WildcardPathServer::get_batches_count() const
+{
+    return batches_count_;
+}
+} // namespace octo::wildcardmatching
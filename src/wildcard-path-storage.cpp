@@ -0,0 +1,339 @@
+/**
+ * @file wildcard-path-storage.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-storage.hpp"
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+static constexpr char SINGLE_WILDCARD_CHAR = '*';
+static constexpr char DOUBLE_WILDCARD_STRING[] = "**";
+} // namespace
+
+namespace octo::wildcardmatching
+{
+WildcardPathStorage::WildcardPathStorage()
+{
+}
+
+WildcardPathStorage::~WildcardPathStorage()
+{
+}
+
+void WildcardPathStorage::append_segment_cards(std::string_view segment_str, size_t segment_offset)
+{
+    // Split the wildcard string by * and keep offset and size
+    size_t pos = segment_str.find(SINGLE_WILDCARD_CHAR);
+    if (pos == std::string_view::npos)
+    {
+        // If no * is found, its a normal string and this means we only have one wildcard part
+        cards_.push_back(CompiledWildcardPath::Wildcard(segment_offset, segment_offset + segment_str.size()));
+    }
+    else
+    {
+        // Add the prefix wildcard part
+        cards_.push_back(CompiledWildcardPath::Wildcard(segment_offset, segment_offset + pos));
+        ++pos;
+        // Start collecting all the infix wildcard parts
+        for (;;)
+        {
+            size_t pos2 = segment_str.find(SINGLE_WILDCARD_CHAR, pos);
+            if (pos2 == std::string_view::npos)
+            {
+                break;
+            }
+            if (pos2 != pos)
+            {
+                cards_.push_back(CompiledWildcardPath::Wildcard(segment_offset + pos, segment_offset + pos2));
+            }
+            pos = pos2 + 1;
+        }
+        // Add the postfix wildcard part
+        cards_.push_back(CompiledWildcardPath::Wildcard(segment_offset + pos, segment_offset + segment_str.size()));
+    }
+}
+
+void WildcardPathStorage::compile_wildcard_blocks(const PathRecord& record)
+{
+    CompiledWildcardPath::Segment* segments = segments_.data() + record.first_segment;
+    const char* path = chars_.data() + record.path_offset;
+    size_t block_begin = 0;
+    while (block_begin < record.segments_count)
+    {
+        if (segments[block_begin].is_double_wildcard)
+        {
+            block_begin++;
+            continue;
+        }
+
+        // Find the block end and whether it only has literal segments
+        size_t block_end = block_begin;
+        bool is_literal_block = true;
+        while (block_end < record.segments_count && !segments[block_end].is_double_wildcard)
+        {
+            is_literal_block = is_literal_block && segments[block_end].card_count == 1;
+            block_end++;
+        }
+
+        for (size_t i = block_begin; i < block_end; i++)
+        {
+            segments[i].in_literal_block = is_literal_block;
+        }
+
+        // Literal segments are equal only if their text is equal, so the classic KMP failure table is exact
+        if (is_literal_block)
+        {
+            int32_t border = 0;
+            for (size_t i = block_begin + 1; i < block_end; i++)
+            {
+                std::string_view segment_str(path + segments[i].offset, segments[i].size);
+                while (border > 0 && segment_str != std::string_view(path + segments[block_begin + border].offset,
+                                                                      segments[block_begin + border].size))
+                {
+                    border = segments[block_begin + border - 1].block_failure;
+                }
+                if (segment_str ==
+                    std::string_view(path + segments[block_begin + border].offset, segments[block_begin + border].size))
+                {
+                    border++;
+                }
+                segments[i].block_failure = border;
+            }
+        }
+
+        block_begin = block_end;
+    }
+}
+
+size_t WildcardPathStorage::add_wildcard_path(std::string_view wildcard_path, char folder_seperator)
+{
+    PathRecord record;
+    record.path_offset = chars_.size();
+    record.path_size = wildcard_path.size();
+    record.first_segment = segments_.size();
+    record.first_card = cards_.size();
+    chars_.insert(chars_.end(), wildcard_path.begin(), wildcard_path.end());
+
+    std::vector<std::string_view> path_parts;
+    CompiledWildcardPath::split_string_by_delimiter(wildcard_path, folder_seperator, path_parts);
+    for (std::vector<std::string_view>::const_iterator part_iter = path_parts.begin(); part_iter != path_parts.end();
+         ++part_iter)
+    {
+        CompiledWildcardPath::Segment segment;
+        segment.offset = part_iter->data() - wildcard_path.data();
+        segment.size = part_iter->size();
+        segment.is_double_wildcard = part_iter->compare(0, strlen(DOUBLE_WILDCARD_STRING), DOUBLE_WILDCARD_STRING) == 0;
+        segment.starts_with_wildcard = part_iter->front() == SINGLE_WILDCARD_CHAR;
+        segment.ends_with_wildcard = part_iter->back() == SINGLE_WILDCARD_CHAR;
+        segment.in_literal_block = false;
+        segment.block_failure = 0;
+
+        // Keep the cards with offsets relative to the whole wildcard path
+        segment.first_card = cards_.size() - record.first_card;
+        append_segment_cards(*part_iter, segment.offset);
+        segment.card_count = cards_.size() - record.first_card - segment.first_card;
+
+        segments_.push_back(segment);
+    }
+    record.segments_count = segments_.size() - record.first_segment;
+
+    compile_wildcard_blocks(record);
+    records_.push_back(record);
+
+    return records_.size() - 1;
+}
+
+void WildcardPathStorage::append(const WildcardPathStorage& other)
+{
+    // Segments and cards are relative to their own path, so only the records need to be moved
+    const uint32_t chars_offset = chars_.size();
+    const uint32_t segments_offset = segments_.size();
+    const uint32_t cards_offset = cards_.size();
+    chars_.insert(chars_.end(), other.chars_.begin(), other.chars_.end());
+    segments_.insert(segments_.end(), other.segments_.begin(), other.segments_.end());
+    cards_.insert(cards_.end(), other.cards_.begin(), other.cards_.end());
+    records_.reserve(records_.size() + other.records_.size());
+    for (std::vector<PathRecord>::const_iterator record_iter = other.records_.begin();
+         record_iter != other.records_.end();
+         ++record_iter)
+    {
+        PathRecord record = *record_iter;
+        record.path_offset += chars_offset;
+        record.first_segment += segments_offset;
+        record.first_card += cards_offset;
+        records_.push_back(record);
+    }
+}
+
+uint32_t WildcardPathStorage::get_cards_count(const PathRecord& record) const
+{
+    if (record.segments_count == 0)
+    {
+        return 0;
+    }
+    const CompiledWildcardPath::Segment& last_segment = segments_[record.first_segment + record.segments_count - 1];
+    return last_segment.first_card + last_segment.card_count;
+}
+
+void WildcardPathStorage::replace_wildcard_path(size_t index, std::string_view wildcard_path, char folder_seperator)
+{
+    // Compile on the side first, the sizes of the compiled path are only known after
+    WildcardPathStorage compiled;
+    compiled.add_wildcard_path(wildcard_path, folder_seperator);
+    const PathRecord& compiled_record = compiled.records_.front();
+    const uint32_t cards_count = compiled.get_cards_count(compiled_record);
+
+    PathRecord& record = records_[index];
+    if (compiled_record.path_size <= record.path_size && compiled_record.segments_count <= record.segments_count &&
+        cards_count <= get_cards_count(record))
+    {
+        // Segments and cards are relative to their own path, so they are copied over the old ones as they are
+        std::copy(compiled.chars_.begin(), compiled.chars_.end(), chars_.begin() + record.path_offset);
+        std::copy(compiled.segments_.begin(), compiled.segments_.end(), segments_.begin() + record.first_segment);
+        std::copy(compiled.cards_.begin(), compiled.cards_.end(), cards_.begin() + record.first_card);
+        record.path_size = compiled_record.path_size;
+        record.segments_count = compiled_record.segments_count;
+        return;
+    }
+
+    append(compiled);
+    records_[index] = records_.back();
+    records_.pop_back();
+}
+
+void WildcardPathStorage::insert_wildcard_path(size_t index, std::string_view wildcard_path, char folder_seperator)
+{
+    add_wildcard_path(wildcard_path, folder_seperator);
+    std::rotate(records_.begin() + index, records_.end() - 1, records_.end());
+}
+
+void WildcardPathStorage::remove_wildcard_paths(const std::vector<uint32_t>& indexes)
+{
+    std::vector<char> chars;
+    std::vector<CompiledWildcardPath::Segment> segments;
+    std::vector<CompiledWildcardPath::Wildcard> cards;
+    std::vector<PathRecord> records;
+    chars.reserve(chars_.size());
+    segments.reserve(segments_.size());
+    cards.reserve(cards_.size());
+    records.reserve(records_.size() - indexes.size());
+
+    std::vector<uint32_t>::const_iterator removed_iter = indexes.begin();
+    for (size_t index = 0; index < records_.size(); index++)
+    {
+        if (removed_iter != indexes.end() && *removed_iter == index)
+        {
+            ++removed_iter;
+            continue;
+        }
+        PathRecord record = records_[index];
+        const uint32_t cards_count = get_cards_count(record);
+        chars.insert(chars.end(),
+                     chars_.begin() + record.path_offset,
+                     chars_.begin() + record.path_offset + record.path_size);
+        segments.insert(segments.end(),
+                        segments_.begin() + record.first_segment,
+                        segments_.begin() + record.first_segment + record.segments_count);
+        cards.insert(cards.end(), cards_.begin() + record.first_card, cards_.begin() + record.first_card + cards_count);
+        record.path_offset = chars.size() - record.path_size;
+        record.first_segment = segments.size() - record.segments_count;
+        record.first_card = cards.size() - cards_count;
+        records.push_back(record);
+    }
+
+    chars_.swap(chars);
+    segments_.swap(segments);
+    cards_.swap(cards);
+    records_.swap(records);
+}
+
+bool WildcardPathStorage::fits_in_reserved(std::string_view wildcard_path, char folder_seperator) const
+{
+    // Every seperator starts at most one more segment, and every * splits at most one more card
+    const size_t segments_count = std::count(wildcard_path.begin(), wildcard_path.end(), folder_seperator) + 1;
+    const size_t cards_count =
+        segments_count + std::count(wildcard_path.begin(), wildcard_path.end(), SINGLE_WILDCARD_CHAR);
+    return chars_.capacity() - chars_.size() >= wildcard_path.size() &&
+           segments_.capacity() - segments_.size() >= segments_count &&
+           cards_.capacity() - cards_.size() >= cards_count;
+}
+
+CompiledWildcardPath WildcardPathStorage::get_wildcard_path(size_t index) const
+{
+    const PathRecord& record = records_[index];
+
+    CompiledWildcardPath compiled_path;
+    compiled_path.path = std::string_view(chars_.data() + record.path_offset, record.path_size);
+    compiled_path.segments = segments_.data() + record.first_segment;
+    compiled_path.segments_count = record.segments_count;
+    compiled_path.cards = cards_.data() + record.first_card;
+    return compiled_path;
+}
+
+size_t WildcardPathStorage::get_wildcard_paths_count() const
+{
+    return records_.size();
+}
+
+void WildcardPathStorage::reserve(size_t wildcard_paths_count, size_t wildcard_paths_bytes)
+{
+    records_.reserve(records_.size() + wildcard_paths_count);
+    chars_.reserve(chars_.size() + wildcard_paths_bytes);
+    if (!records_.empty())
+    {
+        size_t segments_per_path = (segments_.size() + records_.size() - 1) / records_.size();
+        size_t cards_per_path = (cards_.size() + records_.size() - 1) / records_.size();
+        segments_.reserve(segments_.size() + segments_per_path * wildcard_paths_count);
+        cards_.reserve(cards_.size() + cards_per_path * wildcard_paths_count);
+    }
+}
+
+void WildcardPathStorage::reserve(size_t wildcard_paths_count,
+                                  size_t wildcard_paths_bytes,
+                                  size_t segments_count,
+                                  size_t cards_count)
+{
+    records_.reserve(records_.size() + wildcard_paths_count);
+    chars_.reserve(chars_.size() + wildcard_paths_bytes);
+    segments_.reserve(segments_.size() + segments_count);
+    cards_.reserve(cards_.size() + cards_count);
+}
+
+void WildcardPathStorage::shrink_to_fit()
+{
+    chars_.shrink_to_fit();
+    segments_.shrink_to_fit();
+    cards_.shrink_to_fit();
+    records_.shrink_to_fit();
+}
+
+void WildcardPathStorage::clear()
+{
+    chars_.clear();
+    segments_.clear();
+    cards_.clear();
+    records_.clear();
+}
+
+WildcardPathStorage::MemoryUsage WildcardPathStorage::get_memory_usage() const
+{
+    MemoryUsage memory_usage;
+    memory_usage.wildcard_paths = records_.size();
+    memory_usage.chars_bytes = chars_.capacity();
+    memory_usage.segments_bytes = segments_.capacity() * sizeof(CompiledWildcardPath::Segment);
+    memory_usage.cards_bytes = cards_.capacity() * sizeof(CompiledWildcardPath::Wildcard);
+    memory_usage.records_bytes = records_.capacity() * sizeof(PathRecord);
+    memory_usage.total_bytes = sizeof(WildcardPathStorage) + memory_usage.chars_bytes + memory_usage.segments_bytes +
+                               memory_usage.cards_bytes + memory_usage.records_bytes;
+    return memory_usage;
+}
+} // namespace octo::wildcardmatching
@@ -0,0 +1,289 @@
+/**
+ * @file wildcard-path-watcher.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "octo-wildcardmatching-cpp/wildcard-path-watcher.hpp"
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+
+namespace
+{
+static constexpr uint32_t WATCH_EVENTS_MASK =
+    IN_CREATE | IN_MODIFY | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR | IN_DONT_FOLLOW;
+static constexpr size_t MIN_EVENTS_BUFFER_SIZE = sizeof(struct inotify_event) + NAME_MAX + 1;
+
+std::string join_path(const std::string& directory, const char* name)
+{
+    if (!directory.empty() && directory.back() == '/')
+    {
+        return directory + name;
+    }
+    return directory + "/" + name;
+}
+} // namespace
+
+namespace octo::wildcardmatching
+{
+WildcardPathWatcher::WildcardPathWatcher(std::shared_ptr<const WildcardPathMatcher> matcher,
+                                         EventsCallback callback,
+                                         size_t events_buffer_size,
+                                         size_t max_events_per_poll)
+    : matcher_(std::move(matcher)), callback_(std::move(callback))
+{
+    max_events_per_poll_ = std::max(max_events_per_poll, (size_t)1);
+    overflows_count_ = 0;
+    events_buffer_.resize(std::max(events_buffer_size, MIN_EVENTS_BUFFER_SIZE));
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0)
+    {
+        throw std::runtime_error(std::string("Failed to initialize inotify: [") + strerror(errno) + "]");
+    }
+}
+
+WildcardPathWatcher::~WildcardPathWatcher()
+{
+    // Closing the descriptor removes all the watches
+    close(inotify_fd_);
+}
+
+bool WildcardPathWatcher::watch_directory_tree(const std::string& directory, bool queue_existing_paths)
+{
+    bool is_watched = false;
+    std::vector<std::string> directories(1, directory);
+    while (!directories.empty())
+    {
+        std::string current_directory = std::move(directories.back());
+        directories.pop_back();
+
+        // Register the watch before listing, so nothing created in between is missed
+        int watch_descriptor = inotify_add_watch(inotify_fd_, current_directory.c_str(), WATCH_EVENTS_MASK);
+        if (watch_descriptor < 0)
+        {
+            // Directories under the tree can go away while it is walked
+            continue;
+        }
+        watched_directories_[watch_descriptor] = current_directory;
+        if (current_directory == directory)
+        {
+            is_watched = true;
+        }
+
+        DIR* dir = opendir(current_directory.c_str());
+        if (!dir)
+        {
+            continue;
+        }
+        while (struct dirent* entry = readdir(dir))
+        {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            {
+                continue;
+            }
+            std::string path = join_path(current_directory, entry->d_name);
+            bool is_directory = entry->d_type == DT_DIR;
+            if (entry->d_type == DT_UNKNOWN)
+            {
+                struct stat path_stat;
+                is_directory = lstat(path.c_str(), &path_stat) == 0 && S_ISDIR(path_stat.st_mode);
+            }
+            if (queue_existing_paths)
+            {
+                pending_events_.push_back(Event{EventType::CREATED, path, 0, is_directory});
+            }
+            if (is_directory && matcher_->can_match_under_directory(path))
+            {
+                directories.push_back(std::move(path));
+            }
+        }
+        closedir(dir);
+    }
+
+    return is_watched;
+}
+
+void WildcardPathWatcher::unwatch_directory_tree(const std::string& directory)
+{
+    std::string directory_prefix = directory + "/";
+    for (std::unordered_map<int, std::string>::iterator watch_iter = watched_directories_.begin();
+         watch_iter != watched_directories_.end();)
+    {
+        if (watch_iter->second == directory ||
+            watch_iter->second.compare(0, directory_prefix.size(), directory_prefix) == 0)
+        {
+            inotify_rm_watch(inotify_fd_, watch_iter->first);
+            watch_iter = watched_directories_.erase(watch_iter);
+        }
+        else
+        {
+            ++watch_iter;
+        }
+    }
+}
+
+bool WildcardPathWatcher::drain_events()
+{
+    ssize_t read_size;
+    do
+    {
+        read_size = read(inotify_fd_, events_buffer_.data(), events_buffer_.size());
+    } while (read_size < 0 && errno == EINTR);
+    if (read_size <= 0)
+    {
+        if (read_size < 0 && errno != EAGAIN)
+        {
+            throw std::runtime_error(std::string("Failed to read inotify events: [") + strerror(errno) + "]");
+        }
+        return false;
+    }
+
+    for (ssize_t offset = 0; offset < read_size;)
+    {
+        const struct inotify_event* event =
+            reinterpret_cast<const struct inotify_event*>(events_buffer_.data() + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW)
+        {
+            overflows_count_++;
+            continue;
+        }
+        if (event->mask & IN_IGNORED)
+        {
+            // The watch was removed, either by us or since the directory is gone
+            watched_directories_.erase(event->wd);
+            continue;
+        }
+        std::unordered_map<int, std::string>::const_iterator watch_iter = watched_directories_.find(event->wd);
+        if (watch_iter == watched_directories_.end() || event->len == 0)
+        {
+            continue;
+        }
+
+        std::string path = join_path(watch_iter->second, event->name);
+        const bool is_directory = (event->mask & IN_ISDIR) != 0;
+        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+        {
+            pending_events_.push_back(Event{EventType::CREATED, path, 0, is_directory});
+            // Follow new directories that can lead to a match, with whatever was already created in them
+            if (is_directory && matcher_->can_match_under_directory(path))
+            {
+                watch_directory_tree(path, true);
+            }
+        }
+        else if (event->mask & IN_MODIFY)
+        {
+            pending_events_.push_back(Event{EventType::MODIFIED, path, 0, is_directory});
+        }
+        else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+        {
+            if (is_directory && (event->mask & IN_MOVED_FROM))
+            {
+                // The watches of a moved directory would keep reporting the old paths
+                unwatch_directory_tree(path);
+            }
+            pending_events_.push_back(Event{EventType::DELETED, path, 0, is_directory});
+        }
+    }
+
+    return true;
+}
+
+void WildcardPathWatcher::match_pending_events()
+{
+    // The paths are moved out for the batch lookup and back into the events that matched
+    pending_paths_.resize(pending_events_.size());
+    for (size_t i = 0; i < pending_events_.size(); i++)
+    {
+        pending_paths_[i] = std::move(pending_events_[i].path);
+    }
+    matcher_->get_batch_wildcard_match_ids(pending_paths_, pending_match_ids_);
+
+    size_t matched_events = 0;
+    for (size_t i = 0; i < pending_events_.size(); i++)
+    {
+        if (pending_match_ids_[i])
+        {
+            if (matched_events != i)
+            {
+                pending_events_[matched_events] = std::move(pending_events_[i]);
+            }
+            pending_events_[matched_events].path = std::move(pending_paths_[i]);
+            pending_events_[matched_events].wildcard_path_id = *pending_match_ids_[i];
+            matched_events++;
+        }
+    }
+    pending_events_.resize(matched_events);
+}
+
+void WildcardPathWatcher::add_directory(const std::string& directory)
+{
+    if (!matcher_->can_match_under_directory(directory))
+    {
+        return;
+    }
+    if (!watch_directory_tree(directory, false))
+    {
+        throw std::runtime_error(std::string("Failed to watch the directory: [") + directory + "]");
+    }
+}
+
+size_t WildcardPathWatcher::poll(int timeout_ms)
+{
+    struct pollfd poll_fd;
+    poll_fd.fd = inotify_fd_;
+    poll_fd.events = POLLIN;
+    poll_fd.revents = 0;
+    int ready = ::poll(&poll_fd, 1, timeout_ms);
+    if (ready < 0 && errno != EINTR)
+    {
+        throw std::runtime_error(std::string("Failed to poll inotify events: [") + strerror(errno) + "]");
+    }
+
+    // Drain what is available, so the whole burst is matched and delivered together, but stop after the max events
+    // so a flood can not grow the batch without bound, the rest stay queued in the kernel for the next poll
+    if (ready > 0)
+    {
+        while (pending_events_.size() < max_events_per_poll_ && drain_events())
+        {
+        }
+    }
+
+    match_pending_events();
+    size_t delivered_events = pending_events_.size();
+    if (delivered_events > 0)
+    {
+        callback_(pending_events_);
+    }
+    pending_events_.clear();
+    return delivered_events;
+}
+
+int WildcardPathWatcher::get_fd() const
+{
+    return inotify_fd_;
+}
+
+size_t WildcardPathWatcher::get_watched_directories_count() const
+{
+    return watched_directories_.size();
+}
+
+size_t WildcardPathWatcher::get_overflows_count() const
+{
+    return overflows_count_;
+}
+} // namespace octo::wildcardmatching
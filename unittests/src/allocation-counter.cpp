@@ -0,0 +1,98 @@
+/**
+ * @file allocation-counter.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include "allocation-counter.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local octo::wildcardmatching::tests::ScopedAllocationCounter* active_counter = nullptr;
+
+void* counted_allocate(size_t size)
+{
+    octo::wildcardmatching::tests::ScopedAllocationCounter::record_allocation();
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+} // namespace
+
+namespace octo::wildcardmatching::tests
+{
+ScopedAllocationCounter::ScopedAllocationCounter() : allocations_(0), previous_(active_counter)
+{
+    active_counter = this;
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter()
+{
+    active_counter = previous_;
+}
+
+size_t ScopedAllocationCounter::get_allocations() const
+{
+    return allocations_;
+}
+
+void ScopedAllocationCounter::record_allocation()
+{
+    if (active_counter)
+    {
+        active_counter->allocations_++;
+    }
+}
+} // namespace octo::wildcardmatching::tests
+
+void* operator new(size_t size)
+{
+    return counted_allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return counted_allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    octo::wildcardmatching::tests::ScopedAllocationCounter::record_allocation();
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    octo::wildcardmatching::tests::ScopedAllocationCounter::record_allocation();
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file allocation-counter.hpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef ALLOCATION_COUNTER_HPP_
+#define ALLOCATION_COUNTER_HPP_
+
+#include <cstddef>
+
+namespace octo::wildcardmatching::tests
+{
+/**
+ * @brief
+ * Test hook that counts the heap allocations done by the current thread while it is alive
+ * The global operator new of the tests binary is replaced to report to the active counter
+ */
+class ScopedAllocationCounter
+{
+  private:
+    size_t allocations_;
+    ScopedAllocationCounter* previous_;
+
+  public:
+    /**
+     * @brief
+     * Construct a new Scoped Allocation Counter object and start counting on the current thread
+     */
+    ScopedAllocationCounter();
+    /**
+     * @brief
+     * Destroy the Scoped Allocation Counter object and stop counting on the current thread
+     */
+    ~ScopedAllocationCounter();
+    ScopedAllocationCounter(const ScopedAllocationCounter&) = delete;
+    ScopedAllocationCounter& operator=(const ScopedAllocationCounter&) = delete;
+    /**
+     * @brief
+     * Get the amount of allocations counted so far
+     *
+     * @return size_t
+     */
+    size_t get_allocations() const;
+    /**
+     * @brief
+     * Called by the replaced operator new for every allocation on the current thread
+     */
+    static void record_allocation();
+};
+} // namespace octo::wildcardmatching::tests
+#endif
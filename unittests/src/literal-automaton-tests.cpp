@@ -0,0 +1,54 @@
+/**
+ * @file literal-automaton-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/literal-automaton.hpp"
+#include <algorithm>
+
+TEST(LiteralAutomatonTest, TestFindsOverlappingLiterals)
+{
+    octo::wildcardmatching::LiteralAutomaton automaton;
+    automaton.build({"he", "she", "his", "hers"});
+    EXPECT_EQ(automaton.get_literals_count(), 4);
+
+    std::vector<uint32_t> literal_ids;
+    automaton.find_literals("ushers", literal_ids);
+    std::sort(literal_ids.begin(), literal_ids.end());
+    EXPECT_THAT(literal_ids, ::testing::ElementsAre(0, 1, 3));
+
+    literal_ids.clear();
+    automaton.find_literals("ahishe", literal_ids);
+    std::sort(literal_ids.begin(), literal_ids.end());
+    EXPECT_THAT(literal_ids, ::testing::ElementsAre(0, 1, 2));
+
+    literal_ids.clear();
+    automaton.find_literals("xyz", literal_ids);
+    EXPECT_TRUE(literal_ids.empty());
+}
+
+TEST(LiteralAutomatonTest, TestReportsEveryOccurrence)
+{
+    octo::wildcardmatching::LiteralAutomaton automaton;
+    automaton.build({".ssh", "ss", "s"});
+
+    std::vector<uint32_t> literal_ids;
+    automaton.find_literals("/home/.ssh/.ssh", literal_ids);
+    EXPECT_EQ(std::count(literal_ids.begin(), literal_ids.end(), 0), 2);
+    EXPECT_EQ(std::count(literal_ids.begin(), literal_ids.end(), 1), 2);
+    EXPECT_EQ(std::count(literal_ids.begin(), literal_ids.end(), 2), 4);
+
+    automaton.clear();
+    literal_ids.clear();
+    automaton.find_literals("/home/.ssh", literal_ids);
+    EXPECT_TRUE(literal_ids.empty());
+    EXPECT_EQ(automaton.get_literals_count(), 0);
+}
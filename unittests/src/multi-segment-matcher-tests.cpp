@@ -0,0 +1,66 @@
+/**
+ * @file multi-segment-matcher-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/multi-segment-matcher.hpp"
+#include <string>
+
+TEST(MultiSegmentMatcherTest, TestMatchesSegmentsWithWildcards)
+{
+    octo::wildcardmatching::MultiSegmentMatcher matcher;
+    matcher.build({"app.log", "*.log", "app*", "a*p*g", "*", "", "*.txt", "*.log"});
+    EXPECT_EQ(matcher.get_segments_count(), 8);
+    EXPECT_EQ(matcher.get_distinct_segments_count(), 5);
+
+    std::vector<uint64_t> matched_mask;
+    matcher.match("app.log", matched_mask);
+    std::vector<bool> matched;
+    for (size_t segment_id = 0; segment_id < matcher.get_segments_count(); segment_id++)
+    {
+        matched.push_back(matcher.is_matched(segment_id, matched_mask));
+    }
+    EXPECT_THAT(matched, ::testing::ElementsAre(true, true, true, true, true, true, false, true));
+
+    matcher.match("x.log.txt", matched_mask);
+    matched.clear();
+    for (size_t segment_id = 0; segment_id < matcher.get_segments_count(); segment_id++)
+    {
+        matched.push_back(matcher.is_matched(segment_id, matched_mask));
+    }
+    EXPECT_THAT(matched, ::testing::ElementsAre(false, false, false, false, true, true, true, false));
+}
+
+TEST(MultiSegmentMatcherTest, TestMatchesSegmentsAcrossWords)
+{
+    // Enough distinct segments to fill many words, with one that does not fit a word and matches any part
+    std::vector<std::string> segments;
+    for (size_t index = 0; index < 1000; index++)
+    {
+        segments.push_back("name" + std::to_string(index) + "*");
+    }
+    segments.push_back(std::string(65, 'x'));
+    octo::wildcardmatching::MultiSegmentMatcher matcher;
+    matcher.build(std::vector<std::string_view>(segments.begin(), segments.end()));
+
+    std::vector<uint64_t> matched_mask;
+    matcher.match("name999.txt", matched_mask);
+    for (size_t segment_id = 0; segment_id < 1000; segment_id++)
+    {
+        EXPECT_EQ(matcher.is_matched(segment_id, matched_mask),
+                  segment_id == 9 || segment_id == 99 || segment_id == 999);
+    }
+    EXPECT_TRUE(matcher.is_matched(1000, matched_mask));
+
+    matcher.clear();
+    EXPECT_EQ(matcher.get_segments_count(), 0);
+    EXPECT_EQ(matcher.get_distinct_segments_count(), 0);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file wildcard-path-code-generator-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/wildcard-path-code-generator.hpp"
+#include "generated-wildcard-path-matcher.hpp"
+#include "generated-allow-wildcard-path-matcher.hpp"
+#include "generated-normalizing-wildcard-path-matcher.hpp"
+#include <random>
+#include <sstream>
+
+namespace
+{
+/**
+ * @brief
+ * Compares a generated matcher with the runtime matcher over the same wildcard paths, on random inputs built from
+ * parts that the literals of the wildcard paths are made of
+ */
+template <typename GeneratedMatcher>
+size_t expect_same_matches(const GeneratedMatcher& generated_matcher)
+{
+    static const char* INPUT_PARTS[] = {"a", "b", "c", "ab", "ba", "abc", "cab", "bab", "x", "aXb", ".", ".."};
+    static const char* INPUT_SEPERATORS[] = {"/", "/", "/", "//", "\\"};
+    octo::wildcardmatching::WildcardPathMatcher path_matcher(generated_matcher.get_allow_last_wildcard_as_many_paths());
+    path_matcher.set_input_folder_seperators(generated_matcher.get_input_folder_seperators());
+    path_matcher.set_normalize_input_paths(generated_matcher.get_normalize_input_paths());
+    path_matcher.add_wildcard_paths(generated_matcher.get_wildcard_paths());
+
+    std::mt19937 random(7);
+    size_t matches = 0;
+    for (size_t i = 0; i < 50000; i++)
+    {
+        std::string input;
+        size_t parts_count = random() % 8;
+        for (size_t part = 0; part < parts_count; part++)
+        {
+            input += INPUT_SEPERATORS[random() % (sizeof(INPUT_SEPERATORS) / sizeof(INPUT_SEPERATORS[0]))];
+            input += INPUT_PARTS[random() % (sizeof(INPUT_PARTS) / sizeof(INPUT_PARTS[0]))];
+        }
+        if (random() % 4 == 0)
+        {
+            input += "/";
+        }
+
+        std::optional<size_t> match_id = path_matcher.get_wildcard_match_id(input);
+        EXPECT_EQ(generated_matcher.get_wildcard_match_id(input), match_id) << input;
+        EXPECT_EQ(generated_matcher.has_match(input), match_id.has_value()) << input;
+        EXPECT_EQ(generated_matcher.get_wildcard_match(input), path_matcher.get_wildcard_match(input)) << input;
+        matches += match_id.has_value() ? 1 : 0;
+    }
+    return matches;
+}
+} // namespace
+
+TEST(WildcardPathCodeGeneratorTest, TestGeneratedMatcherMatchesLikeRuntimeMatcher)
+{
+    octo::wildcardmatching::tests::GeneratedWildcardPathMatcher generated_matcher;
+    EXPECT_FALSE(generated_matcher.get_allow_last_wildcard_as_many_paths());
+    EXPECT_EQ(generated_matcher.get_wildcard_paths_count(), 20);
+    EXPECT_EQ(generated_matcher.get_wildcard_path(0), "/a/b/c");
+    EXPECT_THROW(generated_matcher.get_wildcard_path(20), std::runtime_error);
+
+    // Both some and not all of the inputs should match for the comparison to mean anything
+    size_t matches = expect_same_matches(generated_matcher);
+    EXPECT_GT(matches, 1000);
+    EXPECT_LT(matches, 49000);
+}
+
+TEST(WildcardPathCodeGeneratorTest, TestGeneratedMatcherAllowsLastWildcardAsManyPaths)
+{
+    octo::wildcardmatching::tests::GeneratedAllowWildcardPathMatcher generated_matcher;
+    EXPECT_TRUE(generated_matcher.get_allow_last_wildcard_as_many_paths());
+    EXPECT_EQ(generated_matcher.get_wildcard_match_view("/a/bx/y"), "a/b*");
+    EXPECT_EQ(octo::wildcardmatching::tests::GeneratedWildcardPathMatcher().get_wildcard_match_view("/a/bx/y"),
+              "*/*/*");
+
+    // The last segments ending with a wildcard take most inputs here
+    size_t matches = expect_same_matches(generated_matcher);
+    EXPECT_GT(matches, 1000);
+    EXPECT_LT(matches, 50000);
+}
+
+TEST(WildcardPathCodeGeneratorTest, TestGeneratedMatcherNormalizesInputPaths)
+{
+    octo::wildcardmatching::tests::GeneratedNormalizingWildcardPathMatcher generated_matcher;
+    EXPECT_TRUE(generated_matcher.get_normalize_input_paths());
+    EXPECT_EQ(generated_matcher.get_input_folder_seperators(), "\\");
+    EXPECT_EQ(generated_matcher.get_wildcard_match_view("\\a\\x\\..\\b/./c/"), "/a/b/c");
+
+    size_t matches = expect_same_matches(generated_matcher);
+    EXPECT_GT(matches, 1000);
+    EXPECT_LT(matches, 49000);
+}
+
+TEST(WildcardPathCodeGeneratorTest, TestGeneratesEscapedLiteralsAndNamespace)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_path("/a\"b/c\\d/**");
+
+    octo::wildcardmatching::WildcardPathCodeGenerator generator(path_matcher);
+    std::ostringstream header;
+    generator.generate_header(header, "PolicyMatcher", "policy::paths");
+    EXPECT_THAT(header.str(), ::testing::HasSubstr("namespace policy::paths\n{\nclass PolicyMatcher\n"));
+    EXPECT_THAT(header.str(), ::testing::HasSubstr("#ifndef POLICY__PATHS_POLICYMATCHER_HPP_\n"));
+
+    std::ostringstream source;
+    generator.generate_source(source, "PolicyMatcher", "policy::paths", "policy-matcher.hpp");
+    EXPECT_THAT(source.str(), ::testing::HasSubstr("#include \"policy-matcher.hpp\"\n"));
+    EXPECT_THAT(source.str(), ::testing::HasSubstr("std::string_view(\"/a\\042b/c\\134d/**\", 11)"));
+    EXPECT_THAT(source.str(), ::testing::HasSubstr("case 3:"));
+}
@@ -0,0 +1,219 @@
+/**
+ * @file wildcard-path-loader-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/wildcard-path-loader.hpp"
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <thread>
+#include <atomic>
+
+namespace
+{
+class WildcardPathLoaderTest : public ::testing::Test
+{
+  protected:
+    std::string file_path_;
+
+    void SetUp() override
+    {
+        char file_template[] = "/tmp/octo-wildcard-loader-XXXXXX";
+        int fd = mkstemp(file_template);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        file_path_ = file_template;
+    }
+
+    void TearDown() override
+    {
+        unlink(file_path_.c_str());
+    }
+
+    void write_wildcard_paths_file(const std::string& content)
+    {
+        // Replace the file by a rename, the way it is expected to be updated
+        std::string temp_path = file_path_ + ".new";
+        {
+            std::ofstream file(temp_path, std::ios::trunc);
+            file << content;
+        }
+        rename(temp_path.c_str(), file_path_.c_str());
+    }
+};
+} // namespace
+
+TEST_F(WildcardPathLoaderTest, TestReloadDiffsAndReusesCompiledPaths)
+{
+    write_wildcard_paths_file("# policy v1\n/usr/**/*.so\n\n  **/.ssh  \r\n/etc/*\n");
+    octo::wildcardmatching::WildcardPathLoader loader(
+        file_path_, false, std::make_shared<octo::wildcardmatching::WildcardPathPool>());
+
+    octo::wildcardmatching::WildcardPathLoader::ReloadResult result = loader.reload();
+    EXPECT_TRUE(result.changed);
+    EXPECT_EQ(result.added, 3);
+    EXPECT_EQ(result.removed, 0);
+    std::shared_ptr<const octo::wildcardmatching::WildcardPathMatcher> first_matcher = loader.get_matcher();
+    EXPECT_EQ(first_matcher->get_wildcard_match("/home/john/.ssh"), "**/.ssh");
+    EXPECT_FALSE(first_matcher->has_match("/home/john/x.json"));
+
+    // Same content, nothing is published
+    result = loader.reload();
+    EXPECT_FALSE(result.changed);
+    EXPECT_EQ(result.unchanged, 3);
+    EXPECT_EQ(loader.get_matcher(), first_matcher);
+
+    write_wildcard_paths_file("/usr/**/*.so\n**/.ssh\n/home/*/*.json\n");
+    result = loader.reload();
+    EXPECT_TRUE(result.changed);
+    EXPECT_EQ(result.added, 1);
+    EXPECT_EQ(result.removed, 1);
+    EXPECT_EQ(result.unchanged, 2);
+    EXPECT_TRUE(result.patched);
+    std::shared_ptr<const octo::wildcardmatching::WildcardPathMatcher> second_matcher = loader.get_matcher();
+    EXPECT_TRUE(second_matcher->has_match("/home/john/x.json"));
+    EXPECT_FALSE(second_matcher->has_match("/etc/passwd"));
+    // The unchanged wildcard paths were not compiled again
+    EXPECT_EQ(second_matcher->get_wildcard_path(1).data(), first_matcher->get_wildcard_path(1).data());
+
+    // The previous matcher is still usable by whoever holds it
+    EXPECT_TRUE(first_matcher->has_match("/etc/passwd"));
+
+    // A reordered file changes which wildcard path matches first
+    write_wildcard_paths_file("**/.ssh\n/usr/**/*.so\n/home/*/*.json\n");
+    result = loader.reload();
+    EXPECT_TRUE(result.changed);
+    EXPECT_EQ(result.unchanged, 3);
+    EXPECT_EQ(loader.get_matcher()->get_wildcard_match_id("/home/john/.ssh"), 0);
+}
+
+TEST_F(WildcardPathLoaderTest, TestReloadPatchesCopyOfCurrentMatcher)
+{
+    std::string content;
+    for (int i = 0; i < 1000; i++)
+    {
+        content += "/srv/app" + std::to_string(i) + "/*.conf\n";
+    }
+    write_wildcard_paths_file(content);
+    octo::wildcardmatching::WildcardPathLoader loader(file_path_);
+    octo::wildcardmatching::WildcardPathLoader::ReloadResult result = loader.reload();
+    EXPECT_FALSE(result.patched);
+    std::shared_ptr<const octo::wildcardmatching::WildcardPathMatcher> first_matcher = loader.get_matcher();
+    EXPECT_EQ(first_matcher->get_pool(), nullptr);
+
+    // A line inserted in the middle, one changed and one removed, the rest is kept in its order
+    std::string changed_content = "/srv/app0/*.conf\n/srv/new/*.conf\n";
+    for (int i = 1; i < 1000; i++)
+    {
+        if (i == 500)
+        {
+            changed_content += "/srv/app500/*.yaml\n";
+        }
+        else if (i != 998)
+        {
+            changed_content += "/srv/app" + std::to_string(i) + "/*.conf\n";
+        }
+    }
+    write_wildcard_paths_file(changed_content);
+    result = loader.reload();
+    EXPECT_TRUE(result.changed);
+    EXPECT_TRUE(result.patched);
+    EXPECT_EQ(result.added, 2);
+    EXPECT_EQ(result.removed, 2);
+    std::shared_ptr<const octo::wildcardmatching::WildcardPathMatcher> second_matcher = loader.get_matcher();
+    EXPECT_EQ(second_matcher->get_wildcard_paths_count(), 1000);
+    EXPECT_EQ(second_matcher->get_wildcard_match_id("/srv/new/x.conf"), 1);
+    EXPECT_EQ(second_matcher->get_wildcard_match_id("/srv/app500/x.yaml"), 501);
+    EXPECT_EQ(second_matcher->get_wildcard_match_id("/srv/app999/x.conf"), 999);
+    EXPECT_EQ(second_matcher->get_wildcard_match_id("/srv/app998/x.conf"), std::nullopt);
+    EXPECT_EQ(first_matcher->get_wildcard_match_id("/srv/app998/x.conf"), 998);
+
+    // Every edit of a copy costs as much as a share of a build, so a tenth of the file changed is loaded from scratch
+    std::string rewritten_content;
+    for (int i = 0; i < 1000; i++)
+    {
+        rewritten_content += "/srv/app" + std::to_string(i) + (i < 100 ? "/*.yaml\n" : "/*.conf\n");
+    }
+    write_wildcard_paths_file(rewritten_content);
+    result = loader.reload();
+    EXPECT_TRUE(result.changed);
+    EXPECT_FALSE(result.patched);
+    EXPECT_EQ(loader.get_matcher()->get_wildcard_match_id("/srv/app5/x.yaml"), 5);
+    EXPECT_EQ(loader.get_matcher()->get_wildcard_match_id("/srv/app998/x.conf"), 998);
+
+    // A new file with little in common is loaded from scratch
+    write_wildcard_paths_file("/etc/*\n");
+    result = loader.reload();
+    EXPECT_FALSE(result.patched);
+    EXPECT_EQ(loader.get_matcher()->get_wildcard_paths(), std::vector<std::string>({"/etc/*"}));
+}
+
+TEST_F(WildcardPathLoaderTest, TestInvalidFileKeepsCurrentMatcher)
+{
+    write_wildcard_paths_file("/usr/**/*.so\n");
+    octo::wildcardmatching::WildcardPathLoader loader(file_path_);
+    EXPECT_TRUE(loader.poll());
+    std::shared_ptr<const octo::wildcardmatching::WildcardPathMatcher> matcher = loader.get_matcher();
+
+    write_wildcard_paths_file("/usr/**/*.so\n# comment\n/home/***\n");
+    try
+    {
+        loader.reload();
+        FAIL() << "Expected the reload to fail";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_THAT(e.what(), ::testing::HasSubstr("line 3"));
+    }
+    EXPECT_EQ(loader.get_matcher(), matcher);
+
+    octo::wildcardmatching::WildcardPathLoader missing_loader(file_path_ + ".missing");
+    EXPECT_THROW(missing_loader.reload(), std::runtime_error);
+    EXPECT_FALSE(missing_loader.poll());
+    EXPECT_EQ(missing_loader.get_matcher()->get_wildcard_paths_count(), 0);
+}
+
+TEST_F(WildcardPathLoaderTest, TestPollReloadsOnChange)
+{
+    write_wildcard_paths_file("/etc/*\n");
+    octo::wildcardmatching::WildcardPathLoader loader(file_path_);
+    EXPECT_TRUE(loader.poll());
+    EXPECT_FALSE(loader.poll());
+
+    // Lookups keep running on whatever matcher is published while the file is reloaded
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> lookups(0);
+    std::thread reader([&]() {
+        while (!stop)
+        {
+            std::shared_ptr<const octo::wildcardmatching::WildcardPathMatcher> matcher = loader.get_matcher();
+            if (matcher->has_match("/etc/passwd"))
+            {
+                lookups++;
+            }
+        }
+    });
+
+    while (lookups == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    write_wildcard_paths_file("/etc/*\n/var/log/*.log\n");
+    EXPECT_TRUE(loader.poll());
+    EXPECT_TRUE(loader.get_matcher()->has_match("/var/log/x.log"));
+    EXPECT_FALSE(loader.poll());
+
+    stop = true;
+    reader.join();
+    EXPECT_GT(lookups, 0);
+}
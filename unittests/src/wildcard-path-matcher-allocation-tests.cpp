@@ -0,0 +1,147 @@
+/**
+ * @file wildcard-path-matcher-allocation-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include "allocation-counter.hpp"
+
+namespace
+{
+const std::vector<std::string> WILDCARD_PATHS = {"/usr/**/*.so",
+                                                 "/home/*/*.json",
+                                                 "/home/*/*js",
+                                                 "**/.ssh",
+                                                 "/home/john/.bash*",
+                                                 "**/.bashrc",
+                                                 "**/test/test2.txt",
+                                                 "/etc/*",
+                                                 "**/a/**/b/**/c",
+                                                 "/single/*a*b*c",
+                                                 "/pre*a*b*post",
+                                                 "**/test3/**/test4/**",
+                                                 "**/test5/test6"};
+
+const std::vector<std::string> INPUTS = {"/usr/lib64/security/pam.so",
+                                         "/usr/bla.txt",
+                                         "/home/john/Desktop/cake.json",
+                                         "/home/tony/test.json",
+                                         "/home/shtivi/.ssh/id_rsa.pub",
+                                         "/home/john/.bash_profile",
+                                         "/dev/tty",
+                                         "/home/test/test/test2/test/test/3/.bashrc",
+                                         "/home/test/test/test2/test/test/test2/3/test/test2/test2.txt",
+                                         "/a/b/a/b/c",
+                                         "/prexaxbxpost",
+                                         "/x/test3/x/y/test4/x/y/z/w/test3",
+                                         "/test5/test5/test5/test6"};
+} // namespace
+
+TEST(WildcardPathMatcherAllocationTest, TestHasMatchDoesNotAllocate)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(WILDCARD_PATHS);
+
+    // Warm up the thread scratch memory
+    for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end(); ++input_iter)
+    {
+        path_matcher.has_match(*input_iter);
+    }
+
+    octo::wildcardmatching::tests::ScopedAllocationCounter counter;
+    for (size_t round = 0; round < 10; round++)
+    {
+        for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end();
+             ++input_iter)
+        {
+            path_matcher.has_match(*input_iter);
+        }
+    }
+    EXPECT_EQ(counter.get_allocations(), 0);
+}
+
+TEST(WildcardPathMatcherAllocationTest, TestGetWildcardMatchOnlyAllocatesTheResult)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(WILDCARD_PATHS);
+
+    // Warm up the thread scratch memory
+    for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end(); ++input_iter)
+    {
+        path_matcher.get_wildcard_match(*input_iter);
+    }
+
+    // The only allocation allowed is the returned copy of the matched path, when it does not fit the small string
+    for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end(); ++input_iter)
+    {
+        size_t allocations = 0;
+        std::string match;
+        {
+            octo::wildcardmatching::tests::ScopedAllocationCounter counter;
+            match = path_matcher.get_wildcard_match(*input_iter);
+            allocations = counter.get_allocations();
+        }
+        size_t expected_allocations = match.size() > std::string().capacity() ? 1 : 0;
+        EXPECT_EQ(allocations, expected_allocations) << "Failed on: [" << *input_iter << "]";
+    }
+}
+
+TEST(WildcardPathMatcherAllocationTest, TestMatchIdAndViewDoNotAllocate)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(WILDCARD_PATHS);
+
+    // Warm up the thread scratch memory
+    for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end(); ++input_iter)
+    {
+        path_matcher.get_wildcard_match_view(*input_iter);
+    }
+
+    octo::wildcardmatching::tests::ScopedAllocationCounter counter;
+    size_t matches = 0;
+    for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end(); ++input_iter)
+    {
+        matches += path_matcher.get_wildcard_match_view(*input_iter).has_value() ? 1 : 0;
+        matches += path_matcher.get_wildcard_match_id(*input_iter).has_value() ? 1 : 0;
+    }
+    EXPECT_EQ(counter.get_allocations(), 0);
+    EXPECT_GT(matches, 0);
+}
+
+TEST(WildcardPathMatcherAllocationTest, TestReusedPathViewDoesNotAllocate)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(WILDCARD_PATHS);
+    octo::wildcardmatching::WildcardPathMatcher other_path_matcher;
+    other_path_matcher.add_wildcard_paths({"/home/*/.ssh/*", "**/*.so"});
+
+    // Warm up the path view and the thread scratch memory
+    octo::wildcardmatching::PathView path_view;
+    for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end(); ++input_iter)
+    {
+        path_view = path_matcher.create_path_view(*input_iter);
+        path_matcher.has_match(path_view);
+        other_path_matcher.has_match(path_view);
+    }
+
+    octo::wildcardmatching::tests::ScopedAllocationCounter counter;
+    size_t matches = 0;
+    std::bitset<256> folder_seperators_table;
+    folder_seperators_table.set('/');
+    for (std::vector<std::string>::const_iterator input_iter = INPUTS.begin(); input_iter != INPUTS.end(); ++input_iter)
+    {
+        path_view.assign(*input_iter, '/', folder_seperators_table, false);
+        matches += path_matcher.has_match(path_view) ? 1 : 0;
+        matches += other_path_matcher.get_wildcard_match_id(path_view).has_value() ? 1 : 0;
+    }
+    EXPECT_EQ(counter.get_allocations(), 0);
+    EXPECT_GT(matches, 0);
+}
@@ -0,0 +1,141 @@
+/**
+ * @file wildcard-path-matcher-set-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher-set.hpp"
+#include "allocation-counter.hpp"
+#include <random>
+
+TEST(WildcardPathMatcherSetTest, TestFirstMatchOfEveryList)
+{
+    octo::wildcardmatching::WildcardPathMatcherSet matcher_set;
+    EXPECT_EQ(matcher_set.add_wildcard_paths("allow", {"/home/**", "/tmp/*"}), 0);
+    EXPECT_EQ(matcher_set.add_wildcard_paths("deny", {"**/.ssh/*", "/home/*/.bash*"}), 1);
+    EXPECT_EQ(matcher_set.add_wildcard_paths("audit", {"**/*.log", "/home/john/**", "**/.ssh/id_rsa"}), 2);
+    EXPECT_EQ(matcher_set.get_lists_count(), 3);
+    EXPECT_EQ(matcher_set.get_list_name(1), "deny");
+    EXPECT_EQ(matcher_set.get_list_index("audit"), 2);
+    EXPECT_EQ(matcher_set.get_list_index("other"), std::nullopt);
+
+    std::vector<std::optional<size_t>> match_ids;
+    matcher_set.get_wildcard_match_ids("/home/john/.ssh/id_rsa", match_ids);
+    EXPECT_THAT(match_ids, ::testing::ElementsAre(0, 0, 1));
+
+    matcher_set.get_wildcard_match_ids("/var/log/syslog.log", match_ids);
+    EXPECT_THAT(match_ids, ::testing::ElementsAre(std::nullopt, std::nullopt, 0));
+
+    std::vector<std::optional<std::string_view>> match_views;
+    matcher_set.get_wildcard_match_views("/home/tony/.bashrc", match_views);
+    EXPECT_THAT(match_views, ::testing::ElementsAre("/home/**", "/home/*/.bash*", std::nullopt));
+
+    octo::wildcardmatching::PathView path_view = matcher_set.create_path_view("/tmp/.ssh/key");
+    matcher_set.get_wildcard_match_views(path_view, match_views);
+    EXPECT_THAT(match_views, ::testing::ElementsAre(std::nullopt, "**/.ssh/*", std::nullopt));
+    EXPECT_EQ(matcher_set.get_wildcard_path(2, 1), "/home/john/**");
+    EXPECT_THROW(matcher_set.get_wildcard_path(0, 2), std::runtime_error);
+}
+
+TEST(WildcardPathMatcherSetTest, TestAddToEarlierList)
+{
+    octo::wildcardmatching::WildcardPathMatcherSet matcher_set;
+    matcher_set.add_wildcard_paths("allow", {"/home/**"});
+    matcher_set.add_wildcard_paths("deny", {"**/.ssh/*"});
+    EXPECT_EQ(matcher_set.add_wildcard_paths("allow", {"/etc/*", "**/.ssh/*"}), 0);
+    EXPECT_EQ(matcher_set.add_wildcard_paths("deny", {"/etc/shadow"}), 1);
+    EXPECT_THAT(matcher_set.get_wildcard_paths(0), ::testing::ElementsAre("/home/**", "/etc/*", "**/.ssh/*"));
+    EXPECT_THAT(matcher_set.get_wildcard_paths(1), ::testing::ElementsAre("**/.ssh/*", "/etc/shadow"));
+
+    std::vector<std::optional<size_t>> match_ids;
+    matcher_set.get_wildcard_match_ids("/etc/shadow", match_ids);
+    EXPECT_THAT(match_ids, ::testing::ElementsAre(1, 1));
+    matcher_set.get_wildcard_match_ids("/root/.ssh/key", match_ids);
+    EXPECT_THAT(match_ids, ::testing::ElementsAre(2, 0));
+
+    // Nothing is added when a wildcard path is invalid
+    EXPECT_THROW(matcher_set.add_wildcard_paths("allow", {"/var/*", "/a**b"}), std::runtime_error);
+    EXPECT_EQ(matcher_set.get_wildcard_paths(0).size(), 3);
+
+    matcher_set.clean_wildcard_paths();
+    EXPECT_EQ(matcher_set.get_lists_count(), 0);
+    matcher_set.get_wildcard_match_ids("/etc/shadow", match_ids);
+    EXPECT_TRUE(match_ids.empty());
+}
+
+TEST(WildcardPathMatcherSetTest, TestMatchesLikeSeparateMatchers)
+{
+    const std::vector<std::string> segments = {"a", "b", "ab", ".ssh", "x.log", "*", "**", "a*", "*b", "*.log"};
+    const std::vector<std::string> input_segments = {"a", "b", "ab", ".ssh", "x.log", "ba", "c"};
+    std::mt19937 random(1234);
+    for (bool allow_last_wildcard_as_many_paths : {false, true})
+    {
+        octo::wildcardmatching::WildcardPathMatcherSet matcher_set(allow_last_wildcard_as_many_paths);
+        std::vector<octo::wildcardmatching::WildcardPathMatcher> path_matchers;
+        for (size_t list_index = 0; list_index < 4; list_index++)
+        {
+            std::vector<std::string> wildcard_paths;
+            for (size_t i = 0; i < 40; i++)
+            {
+                std::string wildcard_path;
+                for (size_t depth = 1 + random() % 4; depth > 0; depth--)
+                {
+                    wildcard_path += "/" + segments[random() % segments.size()];
+                }
+                wildcard_paths.push_back(wildcard_path);
+            }
+            matcher_set.add_wildcard_paths("list" + std::to_string(list_index), wildcard_paths);
+            path_matchers.emplace_back(allow_last_wildcard_as_many_paths);
+            path_matchers.back().add_wildcard_paths(wildcard_paths);
+        }
+
+        std::vector<std::optional<size_t>> match_ids;
+        for (size_t i = 0; i < 5000; i++)
+        {
+            std::string input;
+            for (size_t depth = random() % 6; depth > 0; depth--)
+            {
+                input += "/" + input_segments[random() % input_segments.size()];
+            }
+            matcher_set.get_wildcard_match_ids(input, match_ids);
+            ASSERT_EQ(match_ids.size(), path_matchers.size());
+            for (size_t list_index = 0; list_index < path_matchers.size(); list_index++)
+            {
+                ASSERT_EQ(match_ids[list_index], path_matchers[list_index].get_wildcard_match_id(input))
+                    << "Failed on: [" << input << "] list " << list_index;
+            }
+        }
+    }
+}
+
+TEST(WildcardPathMatcherSetTest, TestMatchDoesNotAllocate)
+{
+    octo::wildcardmatching::WildcardPathMatcherSet matcher_set;
+    matcher_set.add_wildcard_paths("allow", {"/home/**", "/usr/**/*.so"});
+    matcher_set.add_wildcard_paths("deny", {"**/.ssh/*", "/etc/*"});
+    const std::vector<std::string> inputs = {"/home/john/.ssh/id_rsa", "/usr/lib/libc.so", "/etc/passwd", "/dev/null"};
+
+    // Warm up the thread scratch memory and size the results
+    std::vector<std::optional<size_t>> match_ids;
+    std::vector<std::optional<std::string_view>> match_views;
+    for (std::vector<std::string>::const_iterator input_iter = inputs.begin(); input_iter != inputs.end(); ++input_iter)
+    {
+        matcher_set.get_wildcard_match_ids(*input_iter, match_ids);
+        matcher_set.get_wildcard_match_views(*input_iter, match_views);
+    }
+
+    octo::wildcardmatching::tests::ScopedAllocationCounter counter;
+    for (std::vector<std::string>::const_iterator input_iter = inputs.begin(); input_iter != inputs.end(); ++input_iter)
+    {
+        matcher_set.get_wildcard_match_ids(*input_iter, match_ids);
+        matcher_set.get_wildcard_match_views(*input_iter, match_views);
+    }
+    EXPECT_EQ(counter.get_allocations(), 0);
+}
@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include <random>
 
 #define MATCH 0
 #define NO_MATCH 1
@@ -409,4 +410,766 @@ TEST(WildcardPathMatcherTest, TestInvalidPaths)
     std::vector<std::string> wildcard_paths = {"/home/lisa/*", "/root/*", "/var/*"};
 
     perform_tests(test_inputs, wildcard_paths, false);
-}
\ No newline at end of file
+}
+
+TEST(WildcardPathMatcherTest, TestDeepPathInfix)
+{
+    // Inputs that keep almost matching the infix block, which made the restart based scan go back on every mismatch
+    std::string almost_literal = "/deep1";
+    std::string almost_wildcard = "/deep2";
+    for (size_t i = 0; i < 200; i++)
+    {
+        almost_literal += "/a";
+        almost_wildcard += "/xa";
+    }
+
+    std::vector<std::pair<std::string, bool>> test_inputs = {{almost_literal, NO_MATCH},
+                                                             {almost_literal + "/b", MATCH},
+                                                             {almost_literal + "/b/c", MATCH},
+                                                             {almost_literal + "/a/b/a/b", MATCH},
+                                                             {almost_wildcard, NO_MATCH},
+                                                             {almost_wildcard + "/xb", MATCH},
+                                                             {almost_wildcard + "/xb/c", MATCH},
+                                                             {"/deep3/a/a/b/a/a/b/a/a/a/b/x", MATCH},
+                                                             {"/deep3/a/a/b/a/a/b/a/a/c/b/x", NO_MATCH},
+                                                             {"/deep4/a/b/a/b/a/b/a/c/x", MATCH},
+                                                             {"/deep4/a/b/a/b/a/b/a/b/x", NO_MATCH}};
+    std::vector<std::string> wildcard_paths = {"/deep1/**/a/a/a/a/b/**",
+                                               "/deep2/**/*a/x*/xa/*b/**",
+                                               "/deep3/**/a/a/b/a/a/a/b/**",
+                                               "/deep4/**/a/b/a/b/a/c/**"};
+
+    perform_tests(test_inputs, wildcard_paths, false);
+}
+
+TEST(WildcardPathMatcherTest, TestLongWildcardInfix)
+{
+    // Infix blocks longer than a single word of prefix states
+    std::string wildcard_path = "/long/**";
+    std::string input = "/long/x";
+    for (size_t i = 0; i < 100; i++)
+    {
+        wildcard_path += "/*" + std::to_string(i);
+        input += "/x" + std::to_string(i);
+    }
+    wildcard_path += "/**";
+
+    std::vector<std::pair<std::string, bool>> test_inputs = {
+        {input, MATCH}, {input + "/y", MATCH}, {"/long/x/x0/x1/x2", NO_MATCH}};
+    std::vector<std::string> wildcard_paths = {wildcard_path};
+
+    perform_tests(test_inputs, wildcard_paths, false);
+}
+
+TEST(WildcardPathMatcherTest, TestMatchIdsAndViews)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(std::vector<std::string>{"/usr/**/*.so", "**/.ssh", "/etc/*"});
+
+    EXPECT_EQ(path_matcher.get_wildcard_paths_count(), 3);
+    EXPECT_EQ(path_matcher.get_wildcard_path(1), "**/.ssh");
+    EXPECT_THROW(path_matcher.get_wildcard_path(3), std::runtime_error);
+
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/home/john/.ssh"), std::optional<size_t>(1));
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/x.txt"), std::optional<size_t>(2));
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/dev/tty"), std::nullopt);
+
+    EXPECT_EQ(path_matcher.get_wildcard_match_view("/usr/lib64/pam.so"), std::optional<std::string_view>("/usr/**/*.so"));
+    EXPECT_EQ(path_matcher.get_wildcard_match_view("/dev/tty"), std::nullopt);
+
+    // Views of the input do not have to be null terminated
+    std::string_view input = std::string_view("/etc/x.txt/y.txt").substr(0, 10);
+    EXPECT_EQ(path_matcher.get_wildcard_match_view(input), std::optional<std::string_view>("/etc/*"));
+    EXPECT_TRUE(path_matcher.has_match(input));
+}
+
+TEST(WildcardPathMatcherTest, TestAddMovedWildcardPaths)
+{
+    std::vector<std::string> wildcard_paths = {"/home/a_rather_long_wildcard_path_that_is_not_small/*", "**/.bashrc"};
+
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(std::move(wildcard_paths));
+
+    // The strings were compiled into the contiguous storage and released from the moved vector
+    EXPECT_TRUE(wildcard_paths.empty());
+    EXPECT_EQ(path_matcher.get_wildcard_path(1).data(),
+              path_matcher.get_wildcard_path(0).data() + path_matcher.get_wildcard_path(0).size());
+    EXPECT_EQ(path_matcher.get_wildcard_match("/root/.bashrc"), "**/.bashrc");
+    EXPECT_EQ(path_matcher.get_wildcard_match("/home/a_rather_long_wildcard_path_that_is_not_small/x"),
+              "/home/a_rather_long_wildcard_path_that_is_not_small/*");
+
+    std::vector<std::string> invalid_paths = {"/home/***"};
+    EXPECT_THROW(path_matcher.add_wildcard_paths(std::move(invalid_paths)), std::runtime_error);
+    EXPECT_EQ(path_matcher.get_wildcard_paths_count(), 2);
+}
+
+TEST(WildcardPathMatcherTest, TestReserveAndShrinkToFit)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_path("/home/*/.config/**/*.json");
+    path_matcher.reserve(1000, 64 * 1000);
+
+    octo::wildcardmatching::WildcardPathMatcher::MemoryUsage reserved_usage = path_matcher.get_memory_usage();
+    EXPECT_EQ(reserved_usage.wildcard_paths, 1);
+    EXPECT_GE(reserved_usage.storage.chars_bytes, 64 * 1000);
+    EXPECT_GE(reserved_usage.storage.segments_bytes,
+              1000 * 5 * sizeof(octo::wildcardmatching::CompiledWildcardPath::Segment));
+    EXPECT_GE(reserved_usage.owned_bytes, reserved_usage.storage.total_bytes);
+    EXPECT_EQ(reserved_usage.shared_bytes, 0);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        path_matcher.add_wildcard_path("/var/log/app" + std::to_string(i) + "/*.log");
+    }
+    EXPECT_EQ(path_matcher.get_wildcard_match("/var/log/app999/x.log"), "/var/log/app999/*.log");
+
+    path_matcher.shrink_to_fit();
+    octo::wildcardmatching::WildcardPathMatcher::MemoryUsage shrunk_usage = path_matcher.get_memory_usage();
+    EXPECT_EQ(shrunk_usage.wildcard_paths, 1001);
+    EXPECT_LT(shrunk_usage.storage.chars_bytes, reserved_usage.storage.chars_bytes);
+    EXPECT_EQ(shrunk_usage.storage.total_bytes,
+              sizeof(octo::wildcardmatching::WildcardPathStorage) + shrunk_usage.storage.chars_bytes +
+                  shrunk_usage.storage.segments_bytes + shrunk_usage.storage.cards_bytes +
+                  shrunk_usage.storage.records_bytes);
+    EXPECT_EQ(path_matcher.get_wildcard_match("/home/x/.config/a/b/c.json"), "/home/*/.config/**/*.json");
+    EXPECT_EQ(path_matcher.get_wildcard_match("/var/log/app0/x.log"), "/var/log/app0/*.log");
+}
+
+TEST(WildcardPathMatcherTest, TestPreFilterFollowsAllowSetting)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher(false);
+    path_matcher.add_wildcard_paths({"/home/*.txt", "/etc/*/.ssh", "**/config/*.json", "/var/log*"});
+
+    EXPECT_FALSE(path_matcher.has_match("/home"));
+    EXPECT_FALSE(path_matcher.has_match("/var/log/app/x"));
+    EXPECT_TRUE(path_matcher.has_match("/var/logs"));
+    EXPECT_TRUE(path_matcher.has_match("/etc/x/.ssh"));
+    EXPECT_FALSE(path_matcher.has_match("/etc/x/.sshx"));
+    EXPECT_FALSE(path_matcher.has_match("/etc/x/.ss"));
+    EXPECT_TRUE(path_matcher.has_match("/a/b/config/x.json"));
+    EXPECT_FALSE(path_matcher.has_match("/a/b/config"));
+
+    // The last wildcard segment may take no input parts or many of them once allowed
+    path_matcher.set_allow_last_wildcard_as_many_paths(true);
+    EXPECT_TRUE(path_matcher.has_match("/home"));
+    EXPECT_TRUE(path_matcher.has_match("/var/log/app/x"));
+    EXPECT_FALSE(path_matcher.has_match("/etc/x/.sshx"));
+
+    path_matcher.set_allow_last_wildcard_as_many_paths(false);
+    EXPECT_FALSE(path_matcher.has_match("/home"));
+    EXPECT_FALSE(path_matcher.has_match("/var/log/app/x"));
+}
+
+TEST(WildcardPathMatcherTest, TestRequiredLiteralsKeepAddOrder)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    // The first two have no required literal, the rest are indexed by one
+    path_matcher.add_wildcard_paths({"**/*.*", "/*/*", "/home/*/.ssh", "/home/*/*"});
+
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/home/john/.ssh"), 0);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/home/john"), 1);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/home/john/ssh"), 3);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/john/ssh"), std::nullopt);
+    EXPECT_GT(path_matcher.get_memory_usage().required_literals_bytes, 0);
+
+    // Single adds are compared without the index until enough of them are added
+    octo::wildcardmatching::WildcardPathMatcher single_path_matcher;
+    for (int i = 0; i < 200; i++)
+    {
+        single_path_matcher.add_wildcard_path("/srv/app" + std::to_string(i % 100) + "/*.log");
+        EXPECT_EQ(single_path_matcher.get_wildcard_match_id("/srv/app" + std::to_string(i % 100) + "/x.log"),
+                  i % 100);
+    }
+    EXPECT_EQ(single_path_matcher.get_wildcard_match_id("/srv/app7/x.log"), 7);
+    EXPECT_EQ(single_path_matcher.get_wildcard_match_id("/srv/app7/x.txt"), std::nullopt);
+}
+
+TEST(WildcardPathMatcherTest, TestMatchPlanFollowsPatternShape)
+{
+    // Few wildcard paths are cheaper to scan than to index
+    octo::wildcardmatching::WildcardPathMatcher small_path_matcher;
+    small_path_matcher.add_wildcard_paths({"/home/*/.ssh/*", "**/.bashrc", "/var/log/**"});
+    octo::wildcardmatching::WildcardPathMatcher::MatchPlan match_plan = small_path_matcher.get_match_plan();
+    EXPECT_EQ(match_plan.scanned_wildcard_paths, 3);
+    EXPECT_GT(match_plan.estimated_lookup_ns, 0);
+
+    std::vector<std::string> file_name_wildcard_paths;
+    std::vector<std::string> tenant_wildcard_paths;
+    std::vector<std::string> app_wildcard_paths;
+    for (int i = 0; i < 2000; i++)
+    {
+        file_name_wildcard_paths.push_back("**/name" + std::to_string(i));
+        tenant_wildcard_paths.push_back("/tenant" + std::to_string(i) + "/*/*.log");
+        app_wildcard_paths.push_back("/srv/*/app" + std::to_string(i) + "*/**");
+    }
+
+    // Many **/name are found by their last part, many literal prefixes by their first part
+    octo::wildcardmatching::WildcardPathMatcher file_name_path_matcher;
+    file_name_path_matcher.add_wildcard_paths(file_name_wildcard_paths);
+    EXPECT_EQ(file_name_path_matcher.get_match_plan().last_part_indexed_wildcard_paths, 2000);
+    EXPECT_EQ(file_name_path_matcher.get_wildcard_match_id("/a/b/name1234"), 1234);
+    EXPECT_EQ(file_name_path_matcher.get_wildcard_match_id("/a/name1234/b"), std::nullopt);
+
+    octo::wildcardmatching::WildcardPathMatcher tenant_path_matcher;
+    tenant_path_matcher.add_wildcard_paths(tenant_wildcard_paths);
+    EXPECT_EQ(tenant_path_matcher.get_match_plan().first_part_indexed_wildcard_paths, 2000);
+    EXPECT_EQ(tenant_path_matcher.get_wildcard_match_id("/tenant17/app/x.log"), 17);
+    EXPECT_EQ(tenant_path_matcher.get_wildcard_match_id("/tenant17/app/x.txt"), std::nullopt);
+
+    // Shared leading and trailing segments leave the rare literal to the automaton
+    octo::wildcardmatching::WildcardPathMatcher app_path_matcher;
+    app_path_matcher.add_wildcard_paths(app_wildcard_paths);
+    EXPECT_EQ(app_path_matcher.get_match_plan().literal_indexed_wildcard_paths, 2000);
+    EXPECT_EQ(app_path_matcher.get_wildcard_match_id("/srv/x/app7-beta/config"), 7);
+
+    // Names too short to be selective literals are left to the last part index, in the same list
+    std::vector<std::string> number_wildcard_paths;
+    for (int i = 0; i < 2000; i++)
+    {
+        number_wildcard_paths.push_back("**/" + std::to_string(i));
+    }
+    octo::wildcardmatching::WildcardPathMatcher mixed_path_matcher;
+    mixed_path_matcher.add_wildcard_paths(app_wildcard_paths);
+    mixed_path_matcher.add_wildcard_paths(number_wildcard_paths);
+    mixed_path_matcher.add_wildcard_path("**/*.log");
+    match_plan = mixed_path_matcher.get_match_plan();
+    EXPECT_EQ(match_plan.literal_indexed_wildcard_paths, 2000);
+    EXPECT_EQ(match_plan.last_part_indexed_wildcard_paths, 2000);
+    EXPECT_EQ(match_plan.unplanned_wildcard_paths, 1);
+    EXPECT_EQ(mixed_path_matcher.get_wildcard_match_id("/srv/x/app5/7"), 5);
+    EXPECT_EQ(mixed_path_matcher.get_wildcard_match_id("/home/x/7"), 2007);
+    EXPECT_EQ(mixed_path_matcher.get_wildcard_match_id("/home/x/7.log"), 4000);
+    EXPECT_GT(mixed_path_matcher.get_memory_usage().part_indexes_bytes, 0);
+}
+
+TEST(WildcardPathMatcherTest, TestScannedWildcardPathsFilteredByLeadingSegments)
+{
+    // Wildcard paths with no literal part to index are scanned, and filtered by their leading segments first
+    std::vector<std::string> wildcard_paths;
+    for (int i = 0; i < 1000; i++)
+    {
+        wildcard_paths.push_back("/" + std::string(1, 'a' + i % 26) + "*/*" + std::string(1, 'a' + i / 26 % 26) +
+                                 "/*.log");
+    }
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(wildcard_paths);
+    EXPECT_EQ(path_matcher.get_match_plan().scanned_wildcard_paths, 1000);
+    EXPECT_GT(path_matcher.get_memory_usage().leading_segments_bytes, 0);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/xb/app.log"), 18 + 26);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/xb/app.txt"), std::nullopt);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/xb"), std::nullopt);
+
+    // A replaced wildcard path is found until the next plan filters by its segments
+    path_matcher.replace_wildcard_path(0, "/srv/*/app.*");
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/xb/app.txt"), 0);
+    path_matcher.add_wildcard_paths({"/other/*"});
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/xb/app.log"), 0);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/other/x"), 1000);
+}
+
+TEST(WildcardPathMatcherTest, TestRemoveAndReplaceWildcardPaths)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths({"/home/*/.ssh/*", "**/.bashrc", "/var/log/**", "/etc/*", "**/*.pem"});
+
+    // The ids after a removed wildcard path move down, and the rest keep their order
+    path_matcher.remove_wildcard_path(1);
+    EXPECT_EQ(path_matcher.get_wildcard_paths_count(), 4);
+    EXPECT_EQ(path_matcher.get_wildcard_paths(),
+              std::vector<std::string>({"/home/*/.ssh/*", "/var/log/**", "/etc/*", "**/*.pem"}));
+    EXPECT_EQ(path_matcher.get_wildcard_path(1), "/var/log/**");
+    EXPECT_FALSE(path_matcher.has_match("/root/.bashrc"));
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/key.pem"), 2);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/key.pem"), 3);
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_id("/var/log/a.pem"), 1);
+
+    EXPECT_TRUE(path_matcher.remove_wildcard_path(std::string_view("/etc/*")));
+    EXPECT_FALSE(path_matcher.remove_wildcard_path(std::string_view("/etc/*")));
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/key.pem"), 2);
+
+    // A replaced wildcard path keeps its id and its place in the match order
+    path_matcher.replace_wildcard_path(0, "/etc/*.pem");
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/key.pem"), 0);
+    EXPECT_FALSE(path_matcher.has_match("/home/john/.ssh/id_rsa"));
+    path_matcher.add_wildcard_path("/home/**");
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/home/john/.ssh/id_rsa"), 3);
+
+    std::vector<std::optional<size_t>> match_ids;
+    path_matcher.get_batch_wildcard_match_ids({"/etc/a.pem", "/home/x", "/var/log/x"}, match_ids);
+    EXPECT_EQ(match_ids, std::vector<std::optional<size_t>>({0, 3, 1}));
+    path_matcher.get_wildcard_match_ids_by_group("/home/x.pem", {1, 3, 4}, match_ids);
+    EXPECT_EQ(match_ids, std::vector<std::optional<size_t>>({std::nullopt, 2, 3}));
+
+    EXPECT_THROW(path_matcher.remove_wildcard_path(4), std::runtime_error);
+    EXPECT_THROW(path_matcher.replace_wildcard_path(0, "/etc/***"), std::runtime_error);
+}
+
+TEST(WildcardPathMatcherTest, TestRemoveAndReplacePatchTheIndexes)
+{
+    std::vector<std::string> wildcard_paths;
+    for (int i = 0; i < 100; i++)
+    {
+        wildcard_paths.push_back("/*" + std::to_string(i % 10) + "/*/*");
+    }
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(wildcard_paths);
+    ASSERT_EQ(path_matcher.get_match_plan().scanned_wildcard_paths, 100);
+    const size_t leading_segments_bytes = path_matcher.get_memory_usage().leading_segments_bytes;
+    ASSERT_GT(leading_segments_bytes, 0);
+
+    // The replacement moves to the index of its literal first segment, the scanned ones keep their leading segments
+    path_matcher.replace_wildcard_path(5, "/etc/*/*");
+    EXPECT_EQ(path_matcher.get_match_plan().scanned_wildcard_paths, 99);
+    EXPECT_EQ(path_matcher.get_match_plan().first_part_indexed_wildcard_paths, 1);
+    EXPECT_EQ(path_matcher.get_memory_usage().leading_segments_bytes, leading_segments_bytes);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/a/b"), 5);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/x5/a/b"), 15);
+
+    // A scanned replacement takes the place of the old one in the leading segments
+    path_matcher.replace_wildcard_path(15, "/*/*/*z");
+    EXPECT_EQ(path_matcher.get_match_plan().scanned_wildcard_paths, 99);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/x5/a/b"), 25);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/q/a/bz"), 15);
+
+    // Equal wildcard paths are removed by string in the order they were added
+    EXPECT_TRUE(path_matcher.remove_wildcard_path(std::string_view("/*5/*/*")));
+    EXPECT_EQ(path_matcher.get_match_plan().scanned_wildcard_paths, 98);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/x5/a/b"), 34);
+    EXPECT_TRUE(path_matcher.remove_wildcard_path(std::string_view("/etc/*/*")));
+    EXPECT_EQ(path_matcher.get_match_plan().first_part_indexed_wildcard_paths, 0);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/a/b"), std::nullopt);
+    path_matcher.add_wildcard_path("/*5/*/*");
+    EXPECT_TRUE(path_matcher.remove_wildcard_path(std::string_view("/*/*/*z")));
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/x5/a/b"), 32);
+
+    // An inserted wildcard path moves the ones from its id on up by one
+    path_matcher.insert_wildcard_path(2, "/*5/*/*");
+    path_matcher.insert_wildcard_path(0, "/etc/*/*");
+    EXPECT_EQ(path_matcher.get_wildcard_paths_count(), 100);
+    EXPECT_EQ(path_matcher.get_wildcard_path(3), "/*5/*/*");
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/x5/a/b"), 3);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/etc/a/b"), 0);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/x9/a/b"), 10);
+    EXPECT_THROW(path_matcher.insert_wildcard_path(101, "/etc/*"), std::runtime_error);
+}
+
+TEST(WildcardPathMatcherTest, TestRemovedWildcardPathsAreReleased)
+{
+    std::vector<std::string> wildcard_paths;
+    for (int i = 0; i < 1000; i++)
+    {
+        wildcard_paths.push_back("/srv/app" + std::to_string(i) + "/config/*.json");
+    }
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths(wildcard_paths);
+    const size_t chars_bytes = path_matcher.get_memory_usage().storage.chars_bytes;
+
+    // A replacement that fits is compiled over the old wildcard path
+    path_matcher.replace_wildcard_path(10, "/srv/app10/*.yaml");
+    EXPECT_EQ(path_matcher.get_memory_usage().storage.chars_bytes, chars_bytes);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/app10/x.yaml"), 10);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/app10/config/x.json"), std::nullopt);
+
+    // Enough removals release the removed wildcard paths
+    for (int i = 0; i < 500; i++)
+    {
+        path_matcher.remove_wildcard_path(500);
+        EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/app" + std::to_string(500 + i) + "/config/x.json"),
+                  std::nullopt);
+        EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/app999/config/x.json"),
+                  i == 499 ? std::nullopt : std::optional<size_t>(998 - i));
+    }
+    path_matcher.shrink_to_fit();
+    EXPECT_EQ(path_matcher.get_wildcard_paths_count(), 500);
+    EXPECT_LT(path_matcher.get_memory_usage().storage.wildcard_paths, 1000);
+    EXPECT_LT(path_matcher.get_memory_usage().storage.chars_bytes, chars_bytes);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/srv/app10/x.yaml"), 10);
+}
+
+TEST(WildcardPathMatcherTest, TestCanMatchUnderDirectory)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths({"/home/*/.ssh/*", "/var/log/**/*.log", "/etc/hosts"});
+
+    EXPECT_TRUE(path_matcher.can_match_under_directory("/"));
+    EXPECT_TRUE(path_matcher.can_match_under_directory("/home"));
+    EXPECT_TRUE(path_matcher.can_match_under_directory("/home/john/.ssh"));
+    EXPECT_FALSE(path_matcher.can_match_under_directory("/home/john/Documents"));
+    EXPECT_FALSE(path_matcher.can_match_under_directory("/home/john/.ssh/keys"));
+    EXPECT_TRUE(path_matcher.can_match_under_directory("/var/log/a/b/c"));
+    EXPECT_TRUE(path_matcher.can_match_under_directory("/etc"));
+    EXPECT_FALSE(path_matcher.can_match_under_directory("/etc/hosts"));
+    EXPECT_FALSE(path_matcher.can_match_under_directory("/usr"));
+
+    // The last wildcard can take many paths once allowed
+    path_matcher.set_allow_last_wildcard_as_many_paths(true);
+    EXPECT_TRUE(path_matcher.can_match_under_directory("/home/john/.ssh/keys"));
+}
+
+TEST(WildcardPathMatcherTest, TestAddWildcardPathsParallel)
+{
+    std::vector<std::string> wildcard_paths;
+    for (int i = 0; i < 20000; i++)
+    {
+        wildcard_paths.push_back("/srv/app" + std::to_string(i) + (i % 2 ? "/**/*.log" : "/config/*.json"));
+    }
+    wildcard_paths.push_back("**/.ssh");
+
+    octo::wildcardmatching::WildcardPathMatcher serial_matcher;
+    serial_matcher.add_wildcard_path("/etc/*");
+    serial_matcher.add_wildcard_paths(wildcard_paths);
+
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+    std::vector<std::shared_ptr<octo::wildcardmatching::WildcardPathPool>> matcher_pools = {nullptr, pool};
+    for (std::shared_ptr<octo::wildcardmatching::WildcardPathPool> matcher_pool : matcher_pools)
+    {
+        octo::wildcardmatching::WildcardPathMatcher parallel_matcher(false, matcher_pool);
+        parallel_matcher.add_wildcard_path("/etc/*");
+        parallel_matcher.add_wildcard_paths_parallel(wildcard_paths, 4);
+
+        EXPECT_EQ(parallel_matcher.get_wildcard_paths(), serial_matcher.get_wildcard_paths());
+        for (std::string input : {"/srv/app7/a/b/c.log", "/srv/app19998/config/x.json", "/srv/app19998/x.log",
+                                  "/home/john/.ssh", "/etc/hosts", "/usr/bin/ls"})
+        {
+            EXPECT_EQ(parallel_matcher.get_wildcard_match_id(input), serial_matcher.get_wildcard_match_id(input))
+                << input;
+        }
+    }
+}
+
+TEST(WildcardPathMatcherTest, TestAddWildcardPathsParallelReportsAllInvalid)
+{
+    std::vector<std::string> wildcard_paths(10000, "/home/*/.bashrc");
+    wildcard_paths[2] = "/home/***";
+    wildcard_paths[9998] = "/a/**b/c";
+
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    try
+    {
+        path_matcher.add_wildcard_paths_parallel(wildcard_paths, 4);
+        FAIL() << "Expected the add to fail";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_THAT(e.what(), ::testing::HasSubstr("line 3 [/home/***]"));
+        EXPECT_THAT(e.what(), ::testing::HasSubstr("line 9999 [/a/**b/c]"));
+    }
+    // Nothing is added when any of them is invalid
+    EXPECT_EQ(path_matcher.get_wildcard_paths_count(), 0);
+}
+
+TEST(WildcardPathMatcherTest, TestNormalizeInputPaths)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths({"/home/*/.ssh/*", "/var/log/**/*.log"});
+
+    // Off by default, . and .. are parts like any other
+    EXPECT_FALSE(path_matcher.get_normalize_input_paths());
+    EXPECT_FALSE(path_matcher.has_match("/home/john/./.ssh/id_rsa"));
+    EXPECT_FALSE(path_matcher.has_match("/home/john/docs/../.ssh/id_rsa"));
+
+    path_matcher.set_normalize_input_paths(true);
+    EXPECT_TRUE(path_matcher.has_match("/home/john/./.ssh/id_rsa"));
+    EXPECT_TRUE(path_matcher.has_match("/home/john/docs/../.ssh//id_rsa/"));
+    EXPECT_TRUE(path_matcher.has_match("/var/log/nginx/../../log/./app.log"));
+    EXPECT_FALSE(path_matcher.has_match("/home/john/.ssh/id_rsa/.."));
+    // Going above the root stays at the root
+    EXPECT_TRUE(path_matcher.has_match("/../../home/john/.ssh/id_rsa"));
+    // Only whole . and .. parts are resolved
+    EXPECT_FALSE(path_matcher.has_match("/home/john/.../.ssh/id_rsa/..."));
+    EXPECT_TRUE(path_matcher.can_match_under_directory("/var/tmp/../log"));
+    EXPECT_FALSE(path_matcher.can_match_under_directory("/var/log/../tmp"));
+}
+
+TEST(WildcardPathMatcherTest, TestInputFolderSeperators)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_path("/home/*/.ssh/*");
+    EXPECT_FALSE(path_matcher.has_match("\\home\\john/.ssh\\id_rsa"));
+
+    path_matcher.set_input_folder_seperators("\\");
+    EXPECT_EQ(path_matcher.get_input_folder_seperators(), "\\");
+    EXPECT_TRUE(path_matcher.has_match("\\home\\john/.ssh\\id_rsa"));
+    EXPECT_TRUE(path_matcher.has_match("\\\\home/\\john\\\\.ssh\\id_rsa\\"));
+    EXPECT_EQ(path_matcher.get_wildcard_match_view("C:\\..\\home\\john\\.ssh\\id_rsa"), std::nullopt);
+
+    path_matcher.set_normalize_input_paths(true);
+    EXPECT_EQ(path_matcher.get_wildcard_match_view("C:\\..\\home\\john\\.ssh\\id_rsa"), "/home/*/.ssh/*");
+}
+
+TEST(WildcardPathMatcherTest, TestPathViewMatchedByManyMatchers)
+{
+    octo::wildcardmatching::WildcardPathMatcher ssh_matcher;
+    ssh_matcher.add_wildcard_paths({"/home/*/.ssh/*", "**/id_rsa"});
+    octo::wildcardmatching::WildcardPathMatcher log_matcher;
+    log_matcher.add_wildcard_paths({"/var/log/**/*.log", "/home/*/.ssh/known_hosts"});
+
+    octo::wildcardmatching::PathView path_view = ssh_matcher.create_path_view("/home/john/.ssh/id_rsa");
+    EXPECT_EQ(path_view.get_input(), "/home/john/.ssh/id_rsa");
+    EXPECT_THAT(path_view.get_parts(), ::testing::ElementsAre("home", "john", ".ssh", "id_rsa"));
+    EXPECT_EQ(path_view.get_facts().parts, 4);
+    EXPECT_EQ(path_view.get_facts().last_part_size, 6);
+    EXPECT_EQ(path_view.get_facts().last_part_hash, octo::wildcardmatching::PathView::hash_part("id_rsa"));
+    EXPECT_EQ(path_view.get_facts().chars, 18);
+
+    EXPECT_TRUE(ssh_matcher.has_match(path_view));
+    EXPECT_EQ(ssh_matcher.get_wildcard_match(path_view), "/home/*/.ssh/*");
+    EXPECT_EQ(ssh_matcher.get_wildcard_match_id(path_view), 0);
+    EXPECT_FALSE(log_matcher.has_match(path_view));
+    EXPECT_EQ(log_matcher.get_wildcard_match_view(path_view), std::nullopt);
+    EXPECT_TRUE(log_matcher.can_match_under_directory(ssh_matcher.create_path_view("/var/log")));
+
+    // The literal last segment is filtered by the last part hash, an equal sized last part is not enough
+    octo::wildcardmatching::PathView known_hosts_view("/home/john/.ssh/known_hosts", '/');
+    octo::wildcardmatching::PathView other_hosts_view("/home/john/.ssh/known_hostz", '/');
+    EXPECT_EQ(log_matcher.get_wildcard_match_id(known_hosts_view), 1);
+    EXPECT_EQ(log_matcher.get_wildcard_match_id(other_hosts_view), std::nullopt);
+}
+
+TEST(WildcardPathMatcherTest, TestPathViewIsSplitAgainByOtherSettings)
+{
+    octo::wildcardmatching::WildcardPathMatcher plain_matcher;
+    plain_matcher.add_wildcard_path("/home/*/.ssh/*");
+    octo::wildcardmatching::WildcardPathMatcher normalizing_matcher;
+    normalizing_matcher.set_input_folder_seperators("\\");
+    normalizing_matcher.set_normalize_input_paths(true);
+    normalizing_matcher.add_wildcard_path("/home/*/.ssh/*");
+
+    // A path view split by other settings is split again by the settings of the matcher
+    octo::wildcardmatching::PathView plain_view =
+        plain_matcher.create_path_view("\\home\\john\\docs\\..\\.ssh\\id_rsa");
+    EXPECT_EQ(plain_view.get_facts().parts, 1);
+    EXPECT_FALSE(plain_matcher.has_match(plain_view));
+    EXPECT_TRUE(normalizing_matcher.has_match(plain_view));
+    EXPECT_EQ(plain_view.get_facts().parts, 1);
+
+    octo::wildcardmatching::PathView normalized_view("/home/john/./.ssh/id_rsa", '/', "\\", true);
+    EXPECT_EQ(normalized_view.get_facts().parts, 4);
+    EXPECT_TRUE(normalizing_matcher.has_match(normalized_view));
+    EXPECT_FALSE(plain_matcher.has_match(normalized_view));
+}
+
+TEST(WildcardPathMatcherTest, TestBatchMatchesLikeSingleLookups)
+{
+    const std::vector<std::string> segments = {"a", "b", "ab", "lib", "x.so", "*", "**", "a*", "*b", "*.so", "l*b"};
+    const std::vector<std::string> input_segments = {"a", "b", "ab", "lib", "x.so", "ba", "c"};
+    std::mt19937 random(4321);
+    for (bool allow_last_wildcard_as_many_paths : {false, true})
+    {
+        octo::wildcardmatching::WildcardPathMatcher path_matcher(allow_last_wildcard_as_many_paths);
+        for (size_t i = 0; i < 200; i++)
+        {
+            std::string wildcard_path;
+            for (size_t depth = 1 + random() % 5; depth > 0; depth--)
+            {
+                wildcard_path += "/" + segments[random() % segments.size()];
+            }
+            path_matcher.add_wildcard_path(wildcard_path);
+        }
+
+        // Sorted inputs share long leading runs of parts, the case the batch reuses the most
+        std::vector<std::string> inputs;
+        for (size_t i = 0; i < 3000; i++)
+        {
+            std::string input;
+            for (size_t depth = random() % 7; depth > 0; depth--)
+            {
+                input += "/" + input_segments[random() % input_segments.size()];
+            }
+            inputs.push_back(input);
+        }
+        std::sort(inputs.begin(), inputs.end());
+
+        std::vector<std::optional<size_t>> match_ids;
+        for (const std::vector<std::string>& batch : {inputs, std::vector<std::string>(inputs.rbegin(), inputs.rend())})
+        {
+            path_matcher.get_batch_wildcard_match_ids(batch, match_ids);
+            ASSERT_EQ(match_ids.size(), batch.size());
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                ASSERT_EQ(match_ids[i], path_matcher.get_wildcard_match_id(batch[i]))
+                    << "Failed on: [" << batch[i] << "]";
+            }
+        }
+    }
+}
+
+TEST(WildcardPathMatcherTest, TestMostSpecificMatch)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths({"**",
+                                     "/home/**",
+                                     "/home/*/.ssh/*",
+                                     "/home/**/.ssh/id_rsa",
+                                     "/home/john/.ssh/*",
+                                     "/home/*/.ssh/id_*",
+                                     "/home/jo*/.ssh/*",
+                                     "/home/john/**/.ssh/id_rsa"});
+
+    // The first added still wins for the regular lookups
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/home/john/.ssh/id_rsa"), 0);
+
+    // Literal segments first, then literal characters, then fewer double wildcards
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_view("/home/john/.ssh/id_rsa"),
+              "/home/john/**/.ssh/id_rsa");
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_view("/home/john/.ssh/known_hosts"), "/home/john/.ssh/*");
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_view("/home/joe/.ssh/id_dsa"), "/home/*/.ssh/id_*");
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_view("/home/joe/.ssh/config"), "/home/jo*/.ssh/*");
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_view("/home/tony/.ssh/config"), "/home/*/.ssh/*");
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_view("/home/tony/a/.ssh/id_rsa"), "/home/**/.ssh/id_rsa");
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_id("/home/tony"), 1);
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_id("/etc/passwd"), 0);
+
+    // Equally specific wildcard paths keep the order they were added in
+    path_matcher.add_wildcard_path("/etc/*sswd");
+    path_matcher.add_wildcard_path("/etc/pa*wd");
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_id(path_matcher.create_path_view("/etc/passwd")), 8);
+
+    // The lookup stops at the first match in specificity order, the less specific candidates are not compared
+    octo::wildcardmatching::WildcardPathMatcher ranked_matcher;
+    ranked_matcher.add_wildcard_paths({"**", "/etc/*", "/etc/passwd"});
+    octo::wildcardmatching::WildcardPathMatcher single_matcher;
+    single_matcher.add_wildcard_paths({"/etc/passwd"});
+    octo::wildcardmatching::WildcardPathMatcher::MatchResult match_result =
+        ranked_matcher.get_most_specific_wildcard_match_result("/etc/passwd");
+    EXPECT_EQ(match_result.status, octo::wildcardmatching::WildcardPathMatcher::MatchStatus::FOUND);
+    EXPECT_EQ(match_result.wildcard_path_id, 2);
+    // Only the pre filter step of the other two candidates
+    EXPECT_EQ(match_result.steps, single_matcher.get_wildcard_match_result("/etc/passwd").steps + 2);
+
+    // Wildcard paths replaced or inserted since the plan are unranked, and still compared in specificity order
+    ranked_matcher.replace_wildcard_path(1, "/etc/pass*");
+    EXPECT_EQ(ranked_matcher.get_most_specific_wildcard_match_id("/etc/passwd"), 2);
+    EXPECT_EQ(ranked_matcher.get_most_specific_wildcard_match_id("/etc/passport"), 1);
+    ranked_matcher.insert_wildcard_path(0, "/etc/passwd");
+    ranked_matcher.insert_wildcard_path(0, "/*/passwd");
+    EXPECT_EQ(ranked_matcher.get_most_specific_wildcard_match_id("/etc/passwd"), 1);
+    ranked_matcher.remove_wildcard_path(1);
+    EXPECT_EQ(ranked_matcher.get_most_specific_wildcard_match_id("/etc/passwd"), 3);
+    EXPECT_EQ(ranked_matcher.get_most_specific_wildcard_match_id("/var/passwd"), 0);
+
+    path_matcher.clean_wildcard_paths();
+    EXPECT_EQ(path_matcher.get_most_specific_wildcard_match_id("/etc/passwd"), std::nullopt);
+}
+
+TEST(WildcardPathMatcherTest, TestMatchStepBudget)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    const std::string costly_wildcard_path = "**/a/**/a/**/a/**/a/*a*a*a*a*b";
+    path_matcher.add_wildcard_paths({"/home/*/x", costly_wildcard_path});
+
+    // Every segment is compared once, and the blocks after a ** are searched for along the input
+    octo::wildcardmatching::WildcardPathMatcher::WildcardPathCost cost =
+        path_matcher.estimate_wildcard_path_cost(costly_wildcard_path);
+    EXPECT_EQ(cost.fixed_steps, 10);
+    EXPECT_EQ(cost.steps_per_part, 13);
+    EXPECT_EQ(path_matcher.estimate_wildcard_path_cost("/home/*/x").steps_per_part, 0);
+
+    std::string deep_input;
+    for (size_t i = 0; i < 200; i++)
+    {
+        deep_input += "/a";
+    }
+    deep_input += "/aaaab";
+
+    // Unbounded lookups only report the steps they were charged
+    octo::wildcardmatching::WildcardPathMatcher::MatchResult match_result =
+        path_matcher.get_wildcard_match_result(deep_input);
+    EXPECT_EQ(match_result.status, octo::wildcardmatching::WildcardPathMatcher::MatchStatus::FOUND);
+    EXPECT_EQ(match_result.wildcard_path_id, 1);
+    EXPECT_EQ(match_result.steps, 1 + 1 + 10 + 13 * 201);
+
+    // A bounded lookup stops before the costly comparison, the cheap lookups are not affected
+    path_matcher.set_match_step_budget(1000);
+    match_result = path_matcher.get_wildcard_match_result(deep_input);
+    EXPECT_EQ(match_result.status, octo::wildcardmatching::WildcardPathMatcher::MatchStatus::BUDGET_EXCEEDED);
+    EXPECT_LE(match_result.steps, 1000);
+    EXPECT_FALSE(path_matcher.has_match(deep_input));
+    EXPECT_EQ(path_matcher.get_wildcard_match_id(deep_input), std::nullopt);
+    EXPECT_EQ(path_matcher.get_wildcard_match_id("/home/john/x"), 0);
+    match_result = path_matcher.get_wildcard_match_result("/etc/passwd");
+    EXPECT_EQ(match_result.status, octo::wildcardmatching::WildcardPathMatcher::MatchStatus::NOT_FOUND);
+
+    // Every lookup is bounded, and reports the exceeded budget where it reports a status
+    match_result = path_matcher.get_most_specific_wildcard_match_result(deep_input);
+    EXPECT_EQ(match_result.status, octo::wildcardmatching::WildcardPathMatcher::MatchStatus::BUDGET_EXCEEDED);
+    std::vector<octo::wildcardmatching::WildcardPathMatcher::MatchResult> match_results;
+    path_matcher.get_batch_wildcard_match_results({"/home/john/x", deep_input}, match_results);
+    ASSERT_EQ(match_results.size(), 2);
+    EXPECT_EQ(match_results[0].status, octo::wildcardmatching::WildcardPathMatcher::MatchStatus::FOUND);
+    EXPECT_EQ(match_results[1].status, octo::wildcardmatching::WildcardPathMatcher::MatchStatus::BUDGET_EXCEEDED);
+    std::vector<std::optional<size_t>> match_ids;
+    path_matcher.get_batch_wildcard_match_ids({"/home/john/x", deep_input}, match_ids);
+    EXPECT_THAT(match_ids, ::testing::ElementsAre(0, std::nullopt));
+    EXPECT_EQ(path_matcher.get_wildcard_match_ids_by_group(deep_input, {1, 2}, match_ids),
+              octo::wildcardmatching::WildcardPathMatcher::MatchStatus::BUDGET_EXCEEDED);
+
+    // Deny lists can take an exceeded budget as a match, and a directory is never ruled out past the budget
+    path_matcher.set_match_on_budget_exceeded(true);
+    EXPECT_TRUE(path_matcher.has_match(deep_input));
+    EXPECT_FALSE(path_matcher.has_match("/etc/passwd"));
+    octo::wildcardmatching::WildcardPathMatcher directory_matcher;
+    directory_matcher.add_wildcard_paths({"/home/*/x", "/var/*"});
+    EXPECT_FALSE(directory_matcher.can_match_under_directory("/etc"));
+    directory_matcher.set_match_step_budget(4);
+    EXPECT_TRUE(directory_matcher.can_match_under_directory("/etc"));
+
+    // Wildcard paths above the max cost can not be added
+    path_matcher.set_max_wildcard_path_cost(8);
+    EXPECT_THROW(path_matcher.add_wildcard_path(costly_wildcard_path), std::runtime_error);
+    EXPECT_NO_THROW(path_matcher.add_wildcard_path("/home/**/x"));
+    EXPECT_EQ(path_matcher.get_wildcard_paths_count(), 3);
+}
+
+TEST(WildcardPathMatcherTest, TestWildcardMatchCaptures)
+{
+    octo::wildcardmatching::WildcardPathMatcher path_matcher;
+    path_matcher.add_wildcard_paths({"/home/*/.ssh/id_*", "/var/**/log/*.*.gz", "/usr/**/**/lib*", "/opt/*/**"});
+
+    octo::wildcardmatching::WildcardPathMatcher::WildcardCapture captures[4];
+    size_t captures_count = 0;
+    std::string input = "/home/john/.ssh/id_rsa";
+    EXPECT_EQ(path_matcher.get_wildcard_match_captures(input, captures, 4, captures_count), 0);
+    ASSERT_EQ(captures_count, 2);
+    EXPECT_EQ(input.substr(captures[0].offset, captures[0].size), "john");
+    EXPECT_EQ(input.substr(captures[1].offset, captures[1].size), "rsa");
+
+    // ** spans all the parts it took, the infix * take the first occurrence of the next card
+    input = "/var/a/b/log/syslog.1.gz";
+    EXPECT_EQ(path_matcher.get_wildcard_match_captures(input, captures, 4, captures_count), 1);
+    ASSERT_EQ(captures_count, 3);
+    EXPECT_EQ(input.substr(captures[0].offset, captures[0].size), "a/b");
+    EXPECT_EQ(input.substr(captures[1].offset, captures[1].size), "syslog");
+    EXPECT_EQ(input.substr(captures[2].offset, captures[2].size), "1");
+
+    // Wildcards that took nothing are empty, ** in a row give all the parts to the first one
+    input = "/usr/local/libc.so";
+    EXPECT_EQ(path_matcher.get_wildcard_match_captures(input, captures, 4, captures_count), 2);
+    ASSERT_EQ(captures_count, 3);
+    EXPECT_EQ(input.substr(captures[0].offset, captures[0].size), "local");
+    EXPECT_EQ(captures[1].size, 0);
+    EXPECT_EQ(input.substr(captures[2].offset, captures[2].size), "c.so");
+    input = "/opt/app";
+    EXPECT_EQ(path_matcher.get_wildcard_match_captures(input, captures, 4, captures_count), 3);
+    ASSERT_EQ(captures_count, 2);
+    EXPECT_EQ(input.substr(captures[0].offset, captures[0].size), "app");
+    EXPECT_EQ(captures[1].offset, input.size());
+    EXPECT_EQ(captures[1].size, 0);
+
+    // A full buffer keeps counting
+    input = "/var/log/a.b.gz";
+    EXPECT_EQ(path_matcher.get_wildcard_match_captures(input, captures, 1, captures_count), 1);
+    EXPECT_EQ(captures_count, 3);
+    EXPECT_EQ(captures[0].size, 0);
+    EXPECT_EQ(path_matcher.get_wildcard_match_captures("/etc/passwd", captures, 4, captures_count), std::nullopt);
+    EXPECT_EQ(captures_count, 0);
+
+    // A last * that takes many paths also spans the parts after its own
+    path_matcher.set_allow_last_wildcard_as_many_paths(true);
+    input = "/opt2/x/y";
+    path_matcher.add_wildcard_path("/opt2/*");
+    EXPECT_EQ(path_matcher.get_wildcard_match_captures(input, captures, 4, captures_count), 4);
+    ASSERT_EQ(captures_count, 1);
+    EXPECT_EQ(input.substr(captures[0].offset, captures[0].size), "x/y");
+}
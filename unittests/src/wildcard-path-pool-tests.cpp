@@ -0,0 +1,189 @@
+/**
+ * @file wildcard-path-pool-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/wildcard-path-matcher.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-pool.hpp"
+#include <thread>
+
+TEST(WildcardPathPoolTest, TestMatchersShareCompiledPaths)
+{
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+
+    octo::wildcardmatching::WildcardPathMatcher first_matcher(false, pool);
+    octo::wildcardmatching::WildcardPathMatcher second_matcher(false, pool);
+    first_matcher.add_wildcard_paths({"/usr/**/*.so", "**/.ssh", "/etc/*"});
+    second_matcher.add_wildcard_paths({"/usr/**/*.so", "**/.ssh", "/home/*/*.json"});
+
+    EXPECT_EQ(pool->get_entries_count(), 4);
+    octo::wildcardmatching::WildcardPathPool::MemoryUsage pool_usage = pool->get_memory_usage();
+    EXPECT_EQ(pool_usage.entries, 4);
+    EXPECT_EQ(pool_usage.references, 6);
+    EXPECT_GT(pool_usage.compiled_paths_bytes, 0);
+
+    // Both matchers look at the same compiled string
+    EXPECT_EQ(first_matcher.get_wildcard_path(1).data(), second_matcher.get_wildcard_path(1).data());
+    EXPECT_EQ(first_matcher.get_wildcard_match("/root/.ssh"), "**/.ssh");
+    EXPECT_EQ(second_matcher.get_wildcard_match("/home/john/x.json"), "/home/*/*.json");
+    EXPECT_FALSE(first_matcher.has_match("/home/john/x.json"));
+
+    octo::wildcardmatching::WildcardPathMatcher::MemoryUsage matcher_usage = first_matcher.get_memory_usage();
+    EXPECT_EQ(matcher_usage.wildcard_paths, 3);
+    EXPECT_GT(matcher_usage.shared_bytes, 0);
+    EXPECT_GT(matcher_usage.owned_bytes, 0);
+}
+
+TEST(WildcardPathPoolTest, TestPathsArePackedIntoChunks)
+{
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+
+    octo::wildcardmatching::WildcardPathMatcher first_matcher(false, pool);
+    std::vector<std::string> wildcard_paths;
+    for (size_t i = 0; i < 100; i++)
+    {
+        wildcard_paths.push_back("/srv/app" + std::to_string(i) + "/**/*.log");
+    }
+    // A path longer than a whole chunk gets a chunk of its own
+    wildcard_paths.push_back("/" + std::string(100000, 'a') + "/*");
+    first_matcher.add_wildcard_paths(wildcard_paths);
+    first_matcher.add_wildcard_path("/srv/app7/**/*.log");
+
+    EXPECT_EQ(pool->get_entries_count(), 101);
+    EXPECT_EQ(pool->get_memory_usage().chunks, 4);
+    EXPECT_TRUE(first_matcher.has_match("/srv/app42/a/b.log"));
+    EXPECT_EQ(first_matcher.get_wildcard_match_id("/" + std::string(100000, 'a') + "/x"), 100);
+
+    // Referencing the same path twice in one matcher does not share it
+    EXPECT_EQ(first_matcher.get_memory_usage().shared_bytes, 0);
+
+    octo::wildcardmatching::WildcardPathMatcher second_matcher(false, pool);
+    second_matcher.add_wildcard_paths({"/srv/app7/**/*.log"});
+    EXPECT_GT(first_matcher.get_memory_usage().shared_bytes, 0);
+    EXPECT_EQ(first_matcher.get_memory_usage().shared_bytes, second_matcher.get_memory_usage().shared_bytes);
+
+    first_matcher.clean_wildcard_paths();
+    EXPECT_EQ(pool->get_entries_count(), 1);
+    EXPECT_EQ(pool->get_memory_usage().chunks, 1);
+}
+
+TEST(WildcardPathPoolTest, TestEntriesAreReleased)
+{
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+
+    {
+        octo::wildcardmatching::WildcardPathMatcher first_matcher(false, pool);
+        first_matcher.add_wildcard_paths({"/usr/**/*.so", "**/.ssh"});
+        {
+            octo::wildcardmatching::WildcardPathMatcher second_matcher(false, pool);
+            second_matcher.add_wildcard_paths({"**/.ssh", "/etc/*"});
+            EXPECT_EQ(pool->get_entries_count(), 3);
+        }
+        EXPECT_EQ(pool->get_entries_count(), 2);
+
+        first_matcher.clean_wildcard_paths();
+        EXPECT_EQ(pool->get_entries_count(), 0);
+        EXPECT_EQ(pool->get_memory_usage().chunks, 0);
+        EXPECT_EQ(pool->get_memory_usage().compiled_paths_bytes, 0);
+    }
+}
+
+TEST(WildcardPathPoolTest, TestRemovedEntriesAreReleased)
+{
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+    octo::wildcardmatching::WildcardPathMatcher path_matcher(false, pool);
+    path_matcher.add_wildcard_paths({"/usr/**/*.so", "**/.ssh", "/etc/*"});
+
+    path_matcher.replace_wildcard_path(0, "/usr/lib/*.so");
+    path_matcher.remove_wildcard_path(1);
+    EXPECT_EQ(path_matcher.get_wildcard_paths(), std::vector<std::string>({"/usr/lib/*.so", "/etc/*"}));
+    EXPECT_TRUE(path_matcher.has_match("/usr/lib/libc.so"));
+    EXPECT_FALSE(path_matcher.has_match("/root/.ssh"));
+
+    // The removed entries are released with the next plan
+    path_matcher.add_wildcard_paths({"/var/**"});
+    EXPECT_EQ(pool->get_entries_count(), 3);
+}
+
+TEST(WildcardPathPoolTest, TestMatcherOutlivesPool)
+{
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+    octo::wildcardmatching::WildcardPathMatcher path_matcher(false, pool);
+    path_matcher.add_wildcard_paths({"**/.bashrc"});
+    pool.reset();
+
+    EXPECT_TRUE(path_matcher.get_pool() != nullptr);
+    EXPECT_TRUE(path_matcher.has_match("/root/.bashrc"));
+}
+
+TEST(WildcardPathPoolTest, TestFolderSeperatorIsPartOfTheEntry)
+{
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+
+    octo::wildcardmatching::WildcardPathMatcher unix_matcher(false, pool);
+    octo::wildcardmatching::WildcardPathMatcher windows_matcher(false, pool);
+    windows_matcher.set_folder_seperator('\\');
+    unix_matcher.add_wildcard_paths({"dir\\*.txt"});
+    windows_matcher.add_wildcard_paths({"dir\\*.txt"});
+
+    // With the unix seperator the whole path is a single segment
+    EXPECT_EQ(pool->get_entries_count(), 2);
+    EXPECT_TRUE(unix_matcher.has_match("dir\\x\\y.txt"));
+    EXPECT_FALSE(windows_matcher.has_match("dir\\x\\y.txt"));
+    EXPECT_TRUE(windows_matcher.has_match("dir\\y.txt"));
+
+    // Changing the seperator compiles the path again through the pool
+    unix_matcher.set_folder_seperator('\\');
+    EXPECT_FALSE(unix_matcher.has_match("dir\\x\\y.txt"));
+    EXPECT_EQ(pool->get_entries_count(), 1);
+}
+
+TEST(WildcardPathPoolTest, TestConcurrentMatchers)
+{
+    std::shared_ptr<octo::wildcardmatching::WildcardPathPool> pool =
+        std::make_shared<octo::wildcardmatching::WildcardPathPool>();
+
+    std::vector<std::thread> threads;
+    std::vector<int> results(8, 0);
+    for (size_t thread_index = 0; thread_index < results.size(); thread_index++)
+    {
+        threads.push_back(std::thread([pool, thread_index, &results]() {
+            for (size_t round = 0; round < 200; round++)
+            {
+                octo::wildcardmatching::WildcardPathMatcher path_matcher(false, pool);
+                path_matcher.add_wildcard_paths(
+                    {"/usr/**/*.so", "**/.ssh", "/tenant" + std::to_string(thread_index) + "/**"});
+                if (path_matcher.has_match("/usr/lib64/pam.so") &&
+                    path_matcher.has_match("/tenant" + std::to_string(thread_index) + "/x") &&
+                    !path_matcher.has_match("/tenant" + std::to_string(thread_index + 1) + "/x"))
+                {
+                    results[thread_index]++;
+                }
+            }
+        }));
+    }
+    for (std::vector<std::thread>::iterator thread_iter = threads.begin(); thread_iter != threads.end(); ++thread_iter)
+    {
+        thread_iter->join();
+    }
+
+    for (size_t thread_index = 0; thread_index < results.size(); thread_index++)
+    {
+        EXPECT_EQ(results[thread_index], 200);
+    }
+    EXPECT_EQ(pool->get_entries_count(), 0);
+}
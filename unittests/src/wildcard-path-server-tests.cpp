@@ -0,0 +1,206 @@
+/**
+ * @file wildcard-path-server-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/wildcard-path-server.hpp"
+#include "octo-wildcardmatching-cpp/wildcard-path-client.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+void append_request(std::vector<char>& request, uint8_t request_type, std::string_view input)
+{
+    // The header is in the byte order of the host, like the client writes it
+    const uint32_t input_size = (uint32_t)input.size();
+    const size_t request_offset = request.size();
+    request.resize(request_offset + octo::wildcardmatching::protocol::REQUEST_HEADER_SIZE);
+    memcpy(request.data() + request_offset, &input_size, sizeof(input_size));
+    memcpy(request.data() + request_offset + sizeof(input_size), &request_type, sizeof(request_type));
+    request.insert(request.end(), input.begin(), input.end());
+}
+
+class WildcardPathServerTest : public ::testing::Test
+{
+  protected:
+    std::string directory_;
+    std::string socket_path_;
+    std::shared_ptr<octo::wildcardmatching::WildcardPathMatcher> matcher_;
+    std::unique_ptr<octo::wildcardmatching::WildcardPathServer> server_;
+    std::atomic<bool> should_stop_{false};
+    std::thread server_thread_;
+
+    void SetUp() override
+    {
+        char directory_template[] = "/tmp/octo-wildcard-server-XXXXXX";
+        ASSERT_NE(mkdtemp(directory_template), nullptr);
+        directory_ = directory_template;
+        socket_path_ = directory_ + "/server.sock";
+
+        matcher_ = std::make_shared<octo::wildcardmatching::WildcardPathMatcher>();
+        matcher_->add_wildcard_paths({"/home/*/.ssh/*", "**/.bashrc", "/var/log/**/*.log", "/etc/*"});
+        server_ = std::make_unique<octo::wildcardmatching::WildcardPathServer>(socket_path_, matcher_);
+        server_thread_ = std::thread([this]() {
+            while (!should_stop_)
+            {
+                server_->poll(10);
+            }
+        });
+    }
+
+    void TearDown() override
+    {
+        stop_server();
+        server_.reset();
+        rmdir(directory_.c_str());
+    }
+
+    void stop_server()
+    {
+        should_stop_ = true;
+        if (server_thread_.joinable())
+        {
+            server_thread_.join();
+        }
+    }
+};
+} // namespace
+
+TEST_F(WildcardPathServerTest, TestServesLookupsOfTheMatcher)
+{
+    octo::wildcardmatching::WildcardPathClient client(socket_path_);
+    EXPECT_TRUE(client.has_match("/home/john/.ssh/id_rsa"));
+    EXPECT_FALSE(client.has_match("/home/john/.ssh"));
+    EXPECT_EQ(client.get_wildcard_match("/a/b/.bashrc"), "**/.bashrc");
+    EXPECT_EQ(client.get_wildcard_match("/a/b/.profile"), "");
+    EXPECT_EQ(client.get_wildcard_match_id("/var/log/app/x.log"), 2);
+    EXPECT_EQ(client.get_wildcard_match_id("/var/log/app/x.txt"), std::nullopt);
+
+    // Pipelined lookups are answered in order, in fewer batches than requests
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 1000; i++)
+    {
+        inputs.push_back(i % 3 == 0   ? "/etc/conf" + std::to_string(i)
+                         : i % 3 == 1 ? "/var/log/" + std::to_string(i) + "/x.log"
+                                      : "/srv/" + std::to_string(i));
+    }
+    std::vector<std::optional<size_t>> match_ids;
+    client.get_wildcard_match_ids(inputs, match_ids);
+    ASSERT_EQ(match_ids.size(), inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        EXPECT_EQ(match_ids[i], matcher_->get_wildcard_match_id(inputs[i]));
+    }
+
+    stop_server();
+    EXPECT_EQ(server_->get_requests_count(), 1006);
+    EXPECT_LT(server_->get_batches_count(), 1006);
+    EXPECT_EQ(server_->get_connections_count(), 1);
+}
+
+TEST_F(WildcardPathServerTest, TestServesConcurrentClients)
+{
+    std::atomic<size_t> mismatches(0);
+    std::vector<std::thread> client_threads;
+    for (int client_index = 0; client_index < 8; client_index++)
+    {
+        client_threads.emplace_back([&, client_index]() {
+            octo::wildcardmatching::WildcardPathClient client(socket_path_);
+            for (int i = 0; i < 200; i++)
+            {
+                std::string input = "/home/user" + std::to_string(client_index) + "/.ssh/key" + std::to_string(i);
+                if (client.get_wildcard_match_id(input) != std::optional<size_t>(0) || client.has_match("/srv/x"))
+                {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (std::vector<std::thread>::iterator thread_iter = client_threads.begin(); thread_iter != client_threads.end();
+         ++thread_iter)
+    {
+        thread_iter->join();
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+TEST_F(WildcardPathServerTest, TestPublishesMatcherAndRejectsInvalidRequests)
+{
+    octo::wildcardmatching::WildcardPathClient client(socket_path_);
+    EXPECT_FALSE(client.has_match("/srv/app"));
+    std::shared_ptr<octo::wildcardmatching::WildcardPathMatcher> matcher =
+        std::make_shared<octo::wildcardmatching::WildcardPathMatcher>();
+    matcher->add_wildcard_paths({"/srv/*"});
+    server_->set_matcher(matcher);
+    EXPECT_EQ(client.get_wildcard_match("/srv/app"), "/srv/*");
+
+    // Inputs that can not be a path are not sent
+    EXPECT_THROW(client.has_match(std::string(1024 * 1024, 'a')), std::runtime_error);
+    EXPECT_TRUE(client.has_match("/srv/app"));
+
+    // Unknown request types are answered as invalid, and the connection stays usable
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path_.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(connect(fd, reinterpret_cast<const struct sockaddr*>(&address), sizeof(address)), 0);
+    std::vector<char> request;
+    append_request(request, 9, "abc");
+    append_request(request, (uint8_t)octo::wildcardmatching::protocol::RequestType::HAS_MATCH, "/srv");
+    ASSERT_EQ(send(fd, request.data(), request.size(), 0), (ssize_t)request.size());
+    char response[10];
+    size_t received_size = 0;
+    while (received_size < sizeof(response))
+    {
+        ssize_t read_size = recv(fd, response + received_size, sizeof(response) - received_size, 0);
+        ASSERT_GT(read_size, 0);
+        received_size += read_size;
+    }
+    EXPECT_EQ(response[4], (char)octo::wildcardmatching::protocol::ResponseStatus::INVALID_REQUEST);
+    EXPECT_EQ(response[9], (char)octo::wildcardmatching::protocol::ResponseStatus::NOT_FOUND);
+    close(fd);
+
+    // Lookups that exceed the step budget are not a match, unless the matcher takes them as one
+    std::shared_ptr<octo::wildcardmatching::WildcardPathMatcher> bounded_matcher =
+        std::make_shared<octo::wildcardmatching::WildcardPathMatcher>();
+    bounded_matcher->add_wildcard_paths({"**/a/**/a/*a*b"});
+    bounded_matcher->set_match_step_budget(10);
+    server_->set_matcher(bounded_matcher);
+    EXPECT_EQ(client.get_wildcard_match_id("/a/a/a/ab"), std::nullopt);
+    EXPECT_FALSE(client.has_match("/a/a/a/ab"));
+    std::shared_ptr<octo::wildcardmatching::WildcardPathMatcher> fail_closed_matcher =
+        std::make_shared<octo::wildcardmatching::WildcardPathMatcher>(*bounded_matcher);
+    fail_closed_matcher->set_match_on_budget_exceeded(true);
+    server_->set_matcher(fail_closed_matcher);
+    EXPECT_TRUE(client.has_match("/a/a/a/ab"));
+    EXPECT_EQ(client.get_wildcard_match("/a/a/a/ab"), "");
+
+    // A second server can not take the socket of a running one, and clients can not connect once it is gone
+    EXPECT_THROW(octo::wildcardmatching::WildcardPathServer(socket_path_, matcher), std::runtime_error);
+    stop_server();
+    server_.reset();
+    EXPECT_THROW(octo::wildcardmatching::WildcardPathClient client(socket_path_), std::runtime_error);
+
+    // A file that is not a socket is never taken over
+    std::string file_path = directory_ + "/file";
+    close(open(file_path.c_str(), O_CREAT | O_WRONLY, 0644));
+    EXPECT_THROW(octo::wildcardmatching::WildcardPathServer(file_path, matcher), std::runtime_error);
+    EXPECT_EQ(access(file_path.c_str(), F_OK), 0);
+    unlink(file_path.c_str());
+}
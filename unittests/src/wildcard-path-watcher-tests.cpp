@@ -0,0 +1,202 @@
+/**
+ * @file wildcard-path-watcher-tests.cpp
+ * @author ofir iluz (iluzofir@gmail.com)
+ * @brief
+ * @version 0.1
+ * @date 2022-08-11
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "octo-wildcardmatching-cpp/wildcard-path-watcher.hpp"
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <chrono>
+
+namespace
+{
+void remove_directory_tree(const std::string& directory)
+{
+    if (DIR* dir = opendir(directory.c_str()))
+    {
+        while (struct dirent* entry = readdir(dir))
+        {
+            if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            {
+                std::string path = directory + "/" + entry->d_name;
+                struct stat path_stat;
+                if (lstat(path.c_str(), &path_stat) == 0 && S_ISDIR(path_stat.st_mode))
+                {
+                    remove_directory_tree(path);
+                }
+                else
+                {
+                    unlink(path.c_str());
+                }
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(directory.c_str());
+}
+
+void write_file(const std::string& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::app);
+    file << content;
+}
+
+class WildcardPathWatcherTest : public ::testing::Test
+{
+  protected:
+    std::string root_;
+    std::vector<octo::wildcardmatching::WildcardPathWatcher::Event> events_;
+    size_t callbacks_ = 0;
+
+    void SetUp() override
+    {
+        char root_template[] = "/tmp/octo-wildcard-watcher-XXXXXX";
+        ASSERT_NE(mkdtemp(root_template), nullptr);
+        root_ = root_template;
+        mkdir((root_ + "/logs").c_str(), 0755);
+        mkdir((root_ + "/conf").c_str(), 0755);
+        mkdir((root_ + "/other").c_str(), 0755);
+    }
+
+    void TearDown() override
+    {
+        remove_directory_tree(root_);
+    }
+
+    std::unique_ptr<octo::wildcardmatching::WildcardPathWatcher> make_watcher(size_t events_buffer_size = 64 * 1024,
+                                                                              size_t max_events_per_poll = 16 * 1024)
+    {
+        std::shared_ptr<octo::wildcardmatching::WildcardPathMatcher> matcher =
+            std::make_shared<octo::wildcardmatching::WildcardPathMatcher>();
+        matcher->add_wildcard_paths({root_ + "/logs/**/*.log", root_ + "/conf/*.json"});
+        return std::make_unique<octo::wildcardmatching::WildcardPathWatcher>(
+            matcher, [this](const std::vector<octo::wildcardmatching::WildcardPathWatcher::Event>& events) {
+                callbacks_++;
+                events_.insert(events_.end(), events.begin(), events.end());
+            },
+            events_buffer_size,
+            max_events_per_poll);
+    }
+
+    bool has_event(octo::wildcardmatching::WildcardPathWatcher::EventType type, const std::string& path) const
+    {
+        for (const octo::wildcardmatching::WildcardPathWatcher::Event& event : events_)
+        {
+            if (event.type == type && event.path == root_ + path)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void poll_until(octo::wildcardmatching::WildcardPathWatcher& watcher,
+                    octo::wildcardmatching::WildcardPathWatcher::EventType type,
+                    const std::string& path)
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!has_event(type, path) && std::chrono::steady_clock::now() < deadline)
+        {
+            watcher.poll(100);
+        }
+    }
+};
+} // namespace
+
+TEST_F(WildcardPathWatcherTest, TestWatchesOnlyDirectoriesThatCanMatch)
+{
+    std::unique_ptr<octo::wildcardmatching::WildcardPathWatcher> watcher = make_watcher();
+    watcher->add_directory(root_);
+    // The root, logs and conf, but not other
+    EXPECT_EQ(watcher->get_watched_directories_count(), 3);
+
+    write_file(root_ + "/other/x.log", "x");
+    write_file(root_ + "/logs/a.txt", "x");
+    write_file(root_ + "/logs/a.log", "x");
+    write_file(root_ + "/conf/c.json", "x");
+    poll_until(*watcher, octo::wildcardmatching::WildcardPathWatcher::EventType::CREATED, "/conf/c.json");
+
+    EXPECT_TRUE(has_event(octo::wildcardmatching::WildcardPathWatcher::EventType::CREATED, "/logs/a.log"));
+    EXPECT_TRUE(has_event(octo::wildcardmatching::WildcardPathWatcher::EventType::CREATED, "/conf/c.json"));
+    for (const octo::wildcardmatching::WildcardPathWatcher::Event& event : events_)
+    {
+        EXPECT_NE(event.path, root_ + "/other/x.log");
+        EXPECT_NE(event.path, root_ + "/logs/a.txt");
+        EXPECT_EQ(event.wildcard_path_id, event.path == root_ + "/conf/c.json" ? 1 : 0);
+    }
+    // The whole burst is drained and delivered together
+    EXPECT_LE(callbacks_, 2);
+    EXPECT_EQ(watcher->get_overflows_count(), 0);
+
+    // Nothing left to deliver
+    events_.clear();
+    EXPECT_EQ(watcher->poll(0), 0);
+    EXPECT_TRUE(events_.empty());
+}
+
+TEST_F(WildcardPathWatcherTest, TestFollowsNewDirectories)
+{
+    std::unique_ptr<octo::wildcardmatching::WildcardPathWatcher> watcher = make_watcher();
+    watcher->add_directory(root_);
+
+    // The file may be created before the new directory is watched, it is reported either way
+    mkdir((root_ + "/logs/app").c_str(), 0755);
+    write_file(root_ + "/logs/app/b.log", "x");
+    mkdir((root_ + "/other/app").c_str(), 0755);
+    poll_until(*watcher, octo::wildcardmatching::WildcardPathWatcher::EventType::CREATED, "/logs/app/b.log");
+    EXPECT_TRUE(has_event(octo::wildcardmatching::WildcardPathWatcher::EventType::CREATED, "/logs/app/b.log"));
+    EXPECT_EQ(watcher->get_watched_directories_count(), 4);
+
+    write_file(root_ + "/logs/app/b.log", "y");
+    poll_until(*watcher, octo::wildcardmatching::WildcardPathWatcher::EventType::MODIFIED, "/logs/app/b.log");
+    EXPECT_TRUE(has_event(octo::wildcardmatching::WildcardPathWatcher::EventType::MODIFIED, "/logs/app/b.log"));
+
+    unlink((root_ + "/logs/app/b.log").c_str());
+    poll_until(*watcher, octo::wildcardmatching::WildcardPathWatcher::EventType::DELETED, "/logs/app/b.log");
+    EXPECT_TRUE(has_event(octo::wildcardmatching::WildcardPathWatcher::EventType::DELETED, "/logs/app/b.log"));
+}
+
+TEST_F(WildcardPathWatcherTest, TestMaxEventsPerPoll)
+{
+    // The smallest events buffer reads only a few events at a time, so the poll stops draining early
+    std::unique_ptr<octo::wildcardmatching::WildcardPathWatcher> watcher = make_watcher(0, 4);
+    watcher->add_directory(root_);
+
+    for (size_t i = 0; i < 20; i++)
+    {
+        write_file(root_ + "/logs/f" + std::to_string(i) + ".log", "x");
+    }
+    size_t first_delivered_events = watcher->poll(1000);
+    EXPECT_GT(first_delivered_events, 0);
+    EXPECT_LT(first_delivered_events, 40);
+
+    // The rest are left queued for the next polls
+    poll_until(*watcher, octo::wildcardmatching::WildcardPathWatcher::EventType::MODIFIED, "/logs/f19.log");
+    EXPECT_EQ(events_.size(), 40);
+    EXPECT_GT(callbacks_, 1);
+    for (size_t i = 0; i < 20; i++)
+    {
+        EXPECT_TRUE(has_event(octo::wildcardmatching::WildcardPathWatcher::EventType::CREATED,
+                              "/logs/f" + std::to_string(i) + ".log"));
+    }
+}
+
+TEST_F(WildcardPathWatcherTest, TestUnmatchableDirectoryIsNotWatched)
+{
+    std::unique_ptr<octo::wildcardmatching::WildcardPathWatcher> watcher = make_watcher();
+    watcher->add_directory(root_ + "/other");
+    EXPECT_EQ(watcher->get_watched_directories_count(), 0);
+    EXPECT_THROW(watcher->add_directory(root_ + "/logs/missing"), std::runtime_error);
+}